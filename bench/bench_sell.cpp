@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <srs/array.h>
+#include <srs/sparse.h>
+#include <chrono>
+#include <iostream>
+
+
+using Timer = std::chrono::duration<double, std::milli>;
+
+void print(int n,
+           int nnz,
+           int c,
+           int sigma,
+           double fill,
+           const Timer& t_csr,
+           const Timer& t_sparse_mv,
+           const Timer& t_sell)
+{
+    std::cout << "Sparse matrix-vector multiplication (SELL-C-sigma):\n"
+              << "---------------------------------------------------\n"
+              << "size =          " << n << " x " << n << '\n'
+              << "nnz =           " << nnz << '\n'
+              << "C, sigma =      " << c << ", " << sigma << '\n'
+              << "padding =       " << fill << '\n'
+              << "sparse_mv/csr = " << t_sparse_mv.count() / t_csr.count()
+              << '\n'
+              << "sell/csr =      " << t_sell.count() / t_csr.count()
+              << "\n\n";
+}
+
+// Matrix with irregular row lengths, between 1 and max_len nonzeros.
+srs::sparse_dmatrix make_matrix(int n, int max_len)
+{
+    srs::Sparse_builder<double> builder(n, n);
+    for (int i = 0; i < n; ++i) {
+        int len = 1 + (i * 7919) % max_len;
+        for (int k = 0; k < len; ++k) {
+            int j = (i + k * 97 + (k * k * 31) % 1013) % n;
+            builder.add(i, j, 1.0 / (1.0 + k));
+        }
+    }
+    return builder.compress();
+}
+
+void benchmark(int n, int max_len, int c, int sigma, int nrep = 20)
+{
+    srs::sparse_dmatrix a = make_matrix(n, max_len);
+    srs::dvector x(n, 1.0);
+
+    srs::dvector y1;
+    srs::mv_mul(a, x, y1);  // warm-up
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < nrep; ++r) {
+        srs::mv_mul(a, x, y1);
+    }
+    auto t2     = std::chrono::high_resolution_clock::now();
+    Timer t_csr = t2 - t1;
+
+    srs::Sparse_mv<double> smv(a, nrep);
+    srs::dvector y2(n);
+    smv.mv('N', 1.0, x, 0.0, y2);
+    t1 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < nrep; ++r) {
+        smv.mv('N', 1.0, x, 0.0, y2);
+    }
+    t2                = std::chrono::high_resolution_clock::now();
+    Timer t_sparse_mv = t2 - t1;
+
+    srs::Sell_matrix<double> s(a, c, sigma);
+    srs::dvector y3(n);
+    srs::mv_mul(1.0, s, x, 0.0, y3);
+    t1 = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < nrep; ++r) {
+        srs::mv_mul(1.0, s, x, 0.0, y3);
+    }
+    t2           = std::chrono::high_resolution_clock::now();
+    Timer t_sell = t2 - t1;
+
+    double fill = static_cast<double>(s.num_stored()) / a.num_nonzero();
+    print(n, a.num_nonzero(), c, sigma, fill, t_csr, t_sparse_mv, t_sell);
+}
+
+int main()
+{
+    benchmark(1000, 16, 8, 256);
+    benchmark(100000, 32, 8, 256);
+    benchmark(100000, 32, 4, 32);
+    benchmark(1000000, 64, 8, 256);
+    benchmark(1000000, 64, 8, 1);
+}
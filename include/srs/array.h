@@ -17,6 +17,7 @@
 #ifndef SRS_ARRAY_H
 #define SRS_ARRAY_H
 
+#include <srs/types.h>
 #include <complex>
 #include <stdexcept>
 #include <string>
@@ -37,7 +38,8 @@ namespace srs {
 //
 // Note:
 // - The general Array template exists only to allow specializations.
-// - Array indexing uses signed integers (int).
+// - Array indexing uses signed integers (Int_t, see types.h); the number of
+//   elements is checked for overflow of Int_t.
 // - Use e.g. Intel MKL for improved numerical performance.
 //
 template <class T, int N>
@@ -56,19 +58,20 @@ struct Array_error : std::runtime_error {
 
 //------------------------------------------------------------------------------
 
-// Convenient typedefs:
+// Convenient typedefs (the integer types use Int_t, so that e.g. pivots can
+// be passed directly to the backend):
 
-typedef Array<int, 1> ivector;
+typedef Array<Int_t, 1> ivector;
 typedef Array<std::size_t, 1> uvector;
 typedef Array<double, 1> dvector;
 typedef Array<std::complex<double>, 1> zvector;
 
-typedef Array<int, 2> imatrix;
+typedef Array<Int_t, 2> imatrix;
 typedef Array<std::size_t, 2> umatrix;
 typedef Array<double, 2> dmatrix;
 typedef Array<std::complex<double>, 2> zmatrix;
 
-typedef Array<int, 3> icube;
+typedef Array<Int_t, 3> icube;
 typedef Array<std::size_t, 3> ucube;
 typedef Array<double, 3> dcube;
 typedef Array<std::complex<double>, 3> zcube;
@@ -135,6 +135,9 @@ public:
     T* data() { return elems.data(); }
     const T* data() const { return elems.data(); }
 
+    // Distance between two consecutive elements.
+    size_type inc() const { return 1; }
+
     // Element-wise operations:
 
     template <class F>
@@ -49,12 +49,14 @@ public:
     Array() : elems(), extents{0, 0}, stride(0) {}
 
     Array(size_type nrows, size_type ncols)
-        : elems(nrows * ncols), extents{nrows, ncols}, stride(nrows)
+        : elems(checked_mul(nrows, ncols)), extents{nrows, ncols}, stride(nrows)
     {
     }
 
     Array(size_type nrows, size_type ncols, const T& value)
-        : elems(nrows * ncols, value), extents{nrows, ncols}, stride(nrows)
+        : elems(checked_mul(nrows, ncols), value),
+          extents{nrows, ncols},
+          stride(nrows)
     {
     }
 
@@ -160,6 +162,9 @@ public:
     T* data() { return elems.data(); }
     const T* data() const { return elems.data(); }
 
+    // Distance between the first elements of two consecutive columns.
+    size_type leading_dim() const { return stride; }
+
     // Element-wise operations:
 
     template <class F>
@@ -198,7 +203,7 @@ private:
 
 template <class T>
 Array<T, 2>::Array(size_type nrows, size_type ncols, T* ptr)
-    : elems(nrows * ncols), extents{nrows, ncols}, stride(nrows)
+    : elems(checked_mul(nrows, ncols)), extents{nrows, ncols}, stride(nrows)
 {
     for (size_type i = 0; i < size(); ++i) {
         elems[i] = ptr[i];
@@ -208,7 +213,7 @@ Array<T, 2>::Array(size_type nrows, size_type ncols, T* ptr)
 template <class T>
 template <Int_t nrows, Int_t ncols>
 Array<T, 2>::Array(const T (&a)[nrows][ncols])
-    : elems(nrows * ncols), extents{nrows, ncols}, stride(nrows)
+    : elems(checked_mul(nrows, ncols)), extents{nrows, ncols}, stride(nrows)
 {
     for (size_type i = 0; i < extents[0]; ++i) {
         for (size_type j = 0; j < extents[1]; ++j) {
@@ -220,7 +225,9 @@ Array<T, 2>::Array(const T (&a)[nrows][ncols])
 template <class T>
 template <class U>
 Array<T, 2>::Array(const Array_ref<U, 2>& a)
-    : elems(a.rows() * a.cols()), extents{a.rows(), a.cols()}, stride(a.rows())
+    : elems(checked_mul(a.rows(), a.cols())),
+      extents{a.rows(), a.cols()},
+      stride(a.rows())
 {
     for (size_type j = 0; j < a.cols(); ++j) {
         for (size_type i = 0; i < a.rows(); ++i) {
@@ -408,7 +415,7 @@ inline void Array<T, 2>::swap(Array<T, 2>& a)
 template <class T>
 inline void Array<T, 2>::resize(size_type nrows, size_type ncols)
 {
-    elems.resize(nrows * ncols);
+    elems.resize(checked_mul(nrows, ncols));
     extents = {nrows, ncols};
     stride  = nrows;
 }
@@ -418,7 +425,7 @@ inline void Array<T, 2>::resize(size_type nrows,
                                 size_type ncols,
                                 const T& value)
 {
-    elems.resize(nrows * ncols, value);
+    elems.resize(checked_mul(nrows, ncols), value);
     extents = {nrows, ncols};
     stride  = nrows;
 }
@@ -594,7 +601,7 @@ void Array<T, 2>::assign(initializer_list_2d ilist)
     size_type n1 = ilist.size();
     size_type n2 = ilist.begin()->size();
 
-    elems.resize(n1 * n2);
+    elems.resize(checked_mul(n1, n2));
     extents = {n1, n2};
     stride  = n1;
 
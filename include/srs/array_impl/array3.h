@@ -50,12 +50,16 @@ public:
     Array() : elems(), extents{0, 0, 0}, strides{0, 0} {}
 
     Array(size_type n1, size_type n2, size_type n3)
-        : elems(n1 * n2 * n3), extents{n1, n2, n3}, strides{n1, n1 * n2}
+        : elems(checked_mul(n1, n2, n3)),
+          extents{n1, n2, n3},
+          strides{n1, n1 * n2}
     {
     }
 
     Array(size_type n1, size_type n2, size_type n3, const T& value)
-        : elems(n1 * n2 * n3, value), extents{n1, n2, n3}, strides{n1, n1 * n2}
+        : elems(checked_mul(n1, n2, n3), value),
+          extents{n1, n2, n3},
+          strides{n1, n1 * n2}
     {
     }
 
@@ -195,7 +199,7 @@ private:
 
 template <class T>
 Array<T, 3>::Array(size_type n1, size_type n2, size_type n3, T* ptr)
-    : elems(n1 * n2 * n3), extents{n1, n2, n3}, strides{n1, n1 * n2}
+    : elems(checked_mul(n1, n2, n3)), extents{n1, n2, n3}, strides{n1, n1 * n2}
 {
     for (size_type i = 0; i < size(); ++i) {
         elems[i] = ptr[i];
@@ -205,7 +209,7 @@ Array<T, 3>::Array(size_type n1, size_type n2, size_type n3, T* ptr)
 template <class T>
 template <Int_t n1, Int_t n2, Int_t n3>
 Array<T, 3>::Array(const T (&a)[n1][n2][n3])
-    : elems(n1 * n2 * n3), extents{n1, n2, n3}, strides{n1, n1 * n2}
+    : elems(checked_mul(n1, n2, n3)), extents{n1, n2, n3}, strides{n1, n1 * n2}
 {
     for (size_type i = 0; i < extents[0]; ++i) {
         for (size_type j = 0; j < extents[1]; ++j) {
@@ -219,7 +223,7 @@ Array<T, 3>::Array(const T (&a)[n1][n2][n3])
 template <class T>
 template <class U>
 Array<T, 3>::Array(const Array_ref<U, 3>& a)
-    : elems(a.rows() * a.cols() * a.depths()),
+    : elems(checked_mul(a.rows(), a.cols(), a.depths())),
       extents{a.rows(), a.cols(), a.depths()},
       strides{a.rows(), a.rows() * a.cols()}
 {
@@ -392,7 +396,7 @@ inline void Array<T, 3>::swap(Array<T, 3>& a)
 template <class T>
 inline void Array<T, 3>::resize(size_type n1, size_type n2, size_type n3)
 {
-    elems.resize(n1 * n2 * n3);
+    elems.resize(checked_mul(n1, n2, n3));
     extents = {n1, n2, n3};
     strides = {n1, n1 * n2};
 }
@@ -403,7 +407,7 @@ inline void Array<T, 3>::resize(size_type n1,
                                 size_type n3,
                                 const T& value)
 {
-    elems.resize(n1 * n2 * n3, value);
+    elems.resize(checked_mul(n1, n2, n3), value);
     extents = {n1, n2, n3};
     strides = {n1, n1 * n2};
 }
@@ -545,7 +549,7 @@ void Array<T, 3>::assign(initializer_list_3d ilist)
     size_type n1 = ilist.begin()->size();
     size_type n2 = ilist.begin()->begin()->size();
 
-    elems.resize(n1 * n2 * n3);
+    elems.resize(checked_mul(n1, n2, n3));
     extents = {n1, n2, n3};
     strides = {n1, n1 * n2};
 
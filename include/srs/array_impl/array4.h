@@ -50,7 +50,7 @@ public:
     Array() : elems(), extents{0, 0, 0, 0}, strides{0, 0, 0} {}
 
     Array(size_type n1, size_type n2, size_type n3, size_type n4)
-        : elems(n1 * n2 * n3 * n4),
+        : elems(checked_mul(n1, n2, n3, n4)),
           extents{n1, n2, n3, n4},
           strides{n1, n1 * n2, n1 * n2 * n3}
     {
@@ -58,7 +58,7 @@ public:
 
     Array(
         size_type n1, size_type n2, size_type n3, size_type n4, const T& value)
-        : elems(n1 * n2 * n3 * n4, value),
+        : elems(checked_mul(n1, n2, n3, n4), value),
           extents{n1, n2, n3, n4},
           strides{n1, n1 * n2, n1 * n2 * n3}
     {
@@ -184,7 +184,7 @@ private:
 template <class T>
 Array<T, 4>::Array(
     size_type n1, size_type n2, size_type n3, size_type n4, T* ptr)
-    : elems(n1 * n2 * n3 * n4),
+    : elems(checked_mul(n1, n2, n3, n4)),
       extents{n1, n2, n3, n4},
       strides{n1, n1 * n2, n1 * n2 * n3}
 {
@@ -196,7 +196,7 @@ Array<T, 4>::Array(
 template <class T>
 template <Int_t n1, Int_t n2, Int_t n3, Int_t n4>
 Array<T, 4>::Array(const T (&a)[n1][n2][n3][n4])
-    : elems(n1 * n2 * n3 * n4),
+    : elems(checked_mul(n1, n2, n3, n4)),
       extents{n1, n2, n3, n4},
       strides{n1, n1 * n2, n1 * n2 * n3}
 {
@@ -332,7 +332,7 @@ inline void Array<T, 4>::resize(size_type n1,
                                 size_type n3,
                                 size_type n4)
 {
-    elems.resize(n1 * n2 * n3 * n4);
+    elems.resize(checked_mul(n1, n2, n3, n4));
     extents = {n1, n2, n3, n4};
     strides = {n1, n1 * n2, n1 * n2 * n3};
 }
@@ -341,7 +341,7 @@ template <class T>
 inline void Array<T, 4>::resize(
     size_type n1, size_type n2, size_type n3, size_type n4, const T& value)
 {
-    elems.resize(n1 * n2 * n3 * n4, value);
+    elems.resize(checked_mul(n1, n2, n3, n4), value);
     extents = {n1, n2, n3, n4};
     strides = {n1, n1 * n2, n1 * n2 * n3};
 }
@@ -487,7 +487,7 @@ void Array<T, 4>::assign(initializer_list_4d ilist)
     size_type n1 = ilist.begin()->begin()->size();
     size_type n2 = ilist.begin()->begin()->begin()->size();
 
-    elems.resize(n1 * n2 * n3 * n4);
+    elems.resize(checked_mul(n1, n2, n3, n4));
     extents = {n1, n2, n3, n4};
     strides = {n1, n1 * n2, n1 * n2 * n3};
 
@@ -78,6 +78,9 @@ public:
     T* data() { return elems; }
     const T* data() const { return elems; }
 
+    // Distance between two consecutive elements.
+    size_type inc() const { return stride; }
+
     // Modifiers:
 
     void swap(const Array_ref& a);
@@ -91,6 +91,9 @@ public:
     T* data() { return elems; }
     const T* data() const { return elems; }
 
+    // Distance between the first elements of two consecutive columns.
+    size_type leading_dim() const { return stride; }
+
     // Element-wise operations:
 
     template <class F>
@@ -30,7 +30,7 @@
 
 namespace srs {
 
-typedef Band_matrix<int> band_imatrix;
+typedef Band_matrix<Int_t> band_imatrix;
 typedef Band_matrix<double> band_dmatrix;
 
 }  // namespace srs
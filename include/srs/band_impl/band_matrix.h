@@ -48,7 +48,7 @@ public:
     }
 
     Band_matrix(size_type m, size_type n, size_type kl, size_type ku)
-        : elems((kl + ku + 1) * n),
+        : elems(checked_mul(kl + ku + 1, n)),
           extents{m, n},
           bwidth{kl, ku},
           stride{kl + ku + 1},
@@ -149,7 +149,7 @@ private:
 template <class T>
 Band_matrix<T>::Band_matrix(
     size_type m, size_type n, size_type kl, size_type ku, const T& value)
-    : elems((kl + ku + 1) * n, value),
+    : elems(checked_mul(kl + ku + 1, n), value),
       extents{m, n},
       bwidth{kl, ku},
       stride{kl + ku + 1},
@@ -173,7 +173,7 @@ template <class T>
 template <Int_t n1, Int_t n2>
 Band_matrix<T>::Band_matrix(
     size_type m, size_type n, size_type kl, size_type ku, const T (&a)[n1][n2])
-    : elems((kl + ku + 1) * n),
+    : elems(checked_mul(kl + ku + 1, n)),
       extents{m, n},
       bwidth{kl, ku},
       stride{kl + ku + 1},
@@ -188,7 +188,7 @@ Band_matrix<T>::Band_matrix(
 
 template <class T>
 Band_matrix<T>::Band_matrix(size_type kl, size_type ku, const Array<T, 2>& a)
-    : elems((kl + ku + 1) * a.cols()),
+    : elems(checked_mul(kl + ku + 1, a.cols())),
       extents{a.rows(), a.cols()},
       bwidth{kl, ku},
       stride{kl + ku + 1},
@@ -261,7 +261,7 @@ void Band_matrix<T>::resize(size_type m,
                             size_type kl,
                             size_type ku)
 {
-    elems.resize((kl + ku + 1) * n);
+    elems.resize(checked_mul(kl + ku + 1, n));
     extents = {m, n};
     stride  = {kl + ku + 1};
 }
@@ -331,7 +331,7 @@ inline Band_matrix<T>& Band_matrix<T>::operator-()
 template <class T>
 inline T& Band_matrix<T>::ref(size_type i, size_type j)
 {
-    if (std::max(0, j - bwidth[1]) <= i
+    if (std::max(size_type{0}, j - bwidth[1]) <= i
         && i < std::min(extents[0], j + bwidth[0] + 1)) {
         return elems[index(i, j)];
     }
@@ -343,7 +343,7 @@ inline T& Band_matrix<T>::ref(size_type i, size_type j)
 template <class T>
 inline const T& Band_matrix<T>::ref(size_type i, size_type j) const
 {
-    if (std::max(0, j - bwidth[1]) <= i
+    if (std::max(size_type{0}, j - bwidth[1]) <= i
         && i < std::min(extents[0], j + bwidth[0] + 1)) {
         return elems[index(i, j)];
     }
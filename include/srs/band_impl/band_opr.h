@@ -17,7 +17,10 @@
 #ifndef SRS_BAND_OPR_H
 #define SRS_BAND_OPR_H
 
+#include <srs/array.h>
+#include <srs/math_impl/blas.h>
 #include <algorithm>
+#include <gsl/gsl>
 
 
 namespace srs {
@@ -92,6 +95,87 @@ inline Band_matrix<T> operator*(const T& scalar, const Band_matrix<T>& a)
 
 //------------------------------------------------------------------------------
 
+// Matrix-vector multiplication:
+//
+// The products require O(n * (kl + ku)) operations and are dispatched to
+// the gbmv and sbmv routines of the BLAS backend.
+
+// Compute w = a * v.
+template <class T>
+void mv_mul(const Band_matrix<T>& a, const Array<T, 1>& v, Array<T, 1>& w)
+{
+    Expects(v.size() == a.cols());
+    w.resize(a.rows());
+
+    // clang-format off
+    blas::gbmv(
+        'N', a.rows(), a.cols(), a.lower(), a.upper(), T(1), a.data(),
+        a.leading_dim(), v.data(), 1, T(0), w.data(), 1);
+    // clang-format on
+}
+
+// Compute w = a * v for a symmetric band matrix, where only the diagonal
+// and the superdiagonals of a are referenced.
+template <class T>
+void sym_mv_mul(const Band_matrix<T>& a, const Array<T, 1>& v, Array<T, 1>& w)
+{
+    Expects(a.rows() == a.cols());
+    Expects(v.size() == a.cols());
+    w.resize(a.rows());
+
+    // clang-format off
+    blas::sbmv(
+        'U', a.rows(), a.upper(), T(1), a.data(), a.leading_dim(), v.data(),
+        1, T(0), w.data(), 1);
+    // clang-format on
+}
+
+template <class T>
+inline Array<T, 1> operator*(const Band_matrix<T>& a, const Array<T, 1>& v)
+{
+    Array<T, 1> result;
+    mv_mul(a, v, result);
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+// Matrix-matrix multiplication:
+
+// Compute c = a * b, where b is a dense matrix. The columns of c are
+// computed in parallel.
+template <class T>
+void mm_mul(const Band_matrix<T>& a, const Array<T, 2>& b, Array<T, 2>& c)
+{
+    using size_type = typename Array<T, 2>::size_type;
+
+    Expects(b.rows() == a.cols());
+    c.resize(a.rows(), b.cols());
+
+    const size_type ldb = b.leading_dim();
+    const size_type ldc = c.leading_dim();
+
+#pragma omp parallel for schedule(static)
+    for (size_type j = 0; j < b.cols(); ++j) {
+        // clang-format off
+        blas::gbmv(
+            'N', a.rows(), a.cols(), a.lower(), a.upper(), T(1), a.data(),
+            a.leading_dim(), b.data() + j * ldb, 1, T(0), c.data() + j * ldc,
+            1);
+        // clang-format on
+    }
+}
+
+template <class T>
+inline Array<T, 2> operator*(const Band_matrix<T>& a, const Array<T, 2>& b)
+{
+    Array<T, 2> result;
+    mm_mul(a, b, result);
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
 // Algorithms:
 
 // Swap matrices.
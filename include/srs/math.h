@@ -19,12 +19,14 @@
 
 
 //
-// Provides a mathematical library with interfaces to Intel MKL.
+// Provides a mathematical library with interfaces to BLAS and LAPACK (Intel
+// MKL or OpenBLAS), see math_impl/backend.h.
 //
 
 #include <srs/math_impl/core.h>
 #include <srs/math_impl/derivation.h>
 #include <srs/math_impl/euler.h>
+#include <srs/math_impl/factorization.h>
 #include <srs/math_impl/geometry.h>
 #include <srs/math_impl/grid.h>
 #include <srs/math_impl/integration.h>
@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SRS_MATH_BACKEND_H
+#define SRS_MATH_BACKEND_H
+
+
+//
+// Selects the BLAS/LAPACK backend at configure time.
+//
+// Backends:
+// - SRS_USE_MKL: Intel MKL (default). Provides BLAS, LAPACK, FEAST and
+//   PARDISO.
+// - SRS_USE_OPENBLAS: OpenBLAS with the CBLAS and LAPACKE interfaces.
+// - SRS_USE_NATIVE: No external libraries. BLAS operations, LU
+//   factorization, linear solvers and symmetric eigensolvers fall back on the
+//   native kernels of libsrs; the remaining LAPACK based methods are not
+//   available.
+//
+// Defines SRS_HAVE_LAPACK if LAPACK is available, and MKL_INT as the integer
+// type of the BLAS/LAPACK interface for all backends.
+//
+// With SRS_USE_ILP64, the 64-bit integer (ILP64) interface is used: MKL
+// must be linked with mkl_intel_ilp64 and OpenBLAS must be built with
+// INTERFACE64=1. MKL_INT is then the same type as srs::Int_t (types.h).
+//
+#if defined(SRS_USE_OPENBLAS)
+#if defined(SRS_USE_ILP64) && !defined(LAPACK_ILP64)
+#define LAPACK_ILP64
+#endif
+#include <cblas.h>
+#include <lapacke.h>
+#ifndef MKL_INT
+#define MKL_INT lapack_int
+#endif
+#define SRS_HAVE_LAPACK
+#elif defined(SRS_USE_NATIVE)
+#ifndef MKL_INT
+#ifdef SRS_USE_ILP64
+#define MKL_INT long long
+#else
+#define MKL_INT int
+#endif
+#endif
+#else
+#ifndef SRS_USE_MKL
+#define SRS_USE_MKL
+#endif
+#if defined(SRS_USE_ILP64) && !defined(MKL_ILP64)
+#define MKL_ILP64
+#endif
+#include <mkl.h>
+#define SRS_HAVE_LAPACK
+#endif
+
+#endif  // SRS_MATH_BACKEND_H
@@ -0,0 +1,1192 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SRS_MATH_BLAS_H
+#define SRS_MATH_BLAS_H
+
+#include <srs/math_impl/backend.h>
+#include <srs/types.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <type_traits>
+
+
+//
+// Provides the BLAS operations used by libsrs, dispatched to the backend
+// selected in backend.h.
+//
+// Note:
+// - All matrices are stored in column-major order.
+// - Transpose flags follow the BLAS convention ('N' or 'T').
+// - The native kernels are used directly by the native backend.
+// - gemm, gemv, axpy and dot are provided for float, double,
+//   std::complex<float> and std::complex<double>; other types fall back on
+//   the native kernels. Complex dot products are not conjugated.
+//
+namespace srs {
+namespace blas {
+
+static_assert(std::is_same<Int_t, MKL_INT>::value,
+              "Int_t must be the integer type of the BLAS/LAPACK interface");
+
+// Native kernels:
+
+// Compute columns jfirst, ..., jlast - 1 of c = alpha * op(a) * op(b) +
+// beta * c, where op(a) is m x k and op(b) is k x n.
+template <class T>
+void native_gemm_cols(char transa,
+                      char transb,
+                      MKL_INT m,
+                      MKL_INT jfirst,
+                      MKL_INT jlast,
+                      MKL_INT k,
+                      T alpha,
+                      const T* a,
+                      MKL_INT lda,
+                      const T* b,
+                      MKL_INT ldb,
+                      T beta,
+                      T* c,
+                      MKL_INT ldc)
+{
+    const bool ta = (transa == 'T') || (transa == 't');
+    const bool tb = (transb == 'T') || (transb == 't');
+
+    for (MKL_INT j = jfirst; j < jlast; ++j) {
+        T* cj = c + j * ldc;
+        for (MKL_INT i = 0; i < m; ++i) {
+            cj[i] = (beta == T(0)) ? T(0) : beta * cj[i];
+        }
+        if (ta) {  // dot products with contiguous columns of a
+            for (MKL_INT i = 0; i < m; ++i) {
+                const T* ai = a + i * lda;
+                T sum       = T(0);
+                for (MKL_INT p = 0; p < k; ++p) {
+                    sum += ai[p] * (tb ? b[j + p * ldb] : b[p + j * ldb]);
+                }
+                cj[i] += alpha * sum;
+            }
+        }
+        else {  // linear combination of columns of a
+            for (MKL_INT p = 0; p < k; ++p) {
+                const T* ap = a + p * lda;
+                T bpj = alpha * (tb ? b[j + p * ldb] : b[p + j * ldb]);
+                for (MKL_INT i = 0; i < m; ++i) {
+                    cj[i] += bpj * ap[i];
+                }
+            }
+        }
+    }
+}
+
+// Compute c = alpha * op(a) * op(b) + beta * c, where op(a) is m x k and
+// op(b) is k x n.
+template <class T>
+void native_gemm(char transa,
+                 char transb,
+                 MKL_INT m,
+                 MKL_INT n,
+                 MKL_INT k,
+                 T alpha,
+                 const T* a,
+                 MKL_INT lda,
+                 const T* b,
+                 MKL_INT ldb,
+                 T beta,
+                 T* c,
+                 MKL_INT ldc)
+{
+#pragma omp parallel for schedule(static)
+    for (MKL_INT j = 0; j < n; ++j) {
+        // clang-format off
+        native_gemm_cols(
+            transa, transb, m, j, j + 1, k, alpha, a, lda, b, ldb, beta, c,
+            ldc);
+        // clang-format on
+    }
+}
+
+// Compute c_l = alpha * op(a_l) * op(b_l) + beta * c_l for a batch of
+// matrices, where a_l starts at a + l * stridea and so on. The batch is
+// processed in parallel, with each product computed by one thread.
+template <class T>
+void native_gemm_batch_strided(char transa,
+                               char transb,
+                               MKL_INT m,
+                               MKL_INT n,
+                               MKL_INT k,
+                               T alpha,
+                               const T* a,
+                               MKL_INT lda,
+                               MKL_INT stridea,
+                               const T* b,
+                               MKL_INT ldb,
+                               MKL_INT strideb,
+                               T beta,
+                               T* c,
+                               MKL_INT ldc,
+                               MKL_INT stridec,
+                               MKL_INT batch_size)
+{
+#pragma omp parallel for schedule(static)
+    for (MKL_INT l = 0; l < batch_size; ++l) {
+        // clang-format off
+        native_gemm_cols(
+            transa, transb, m, 0, n, k, alpha, a + l * stridea, lda,
+            b + l * strideb, ldb, beta, c + l * stridec, ldc);
+        // clang-format on
+    }
+}
+
+// Compute c[l] = alpha * op(a[l]) * op(b[l]) + beta * c[l] for a batch of
+// matrices with individual dimensions and leading dimensions.
+template <class T>
+void native_gemm_batch(char transa,
+                       char transb,
+                       const MKL_INT* m,
+                       const MKL_INT* n,
+                       const MKL_INT* k,
+                       T alpha,
+                       const T* const* a,
+                       const MKL_INT* lda,
+                       const T* const* b,
+                       const MKL_INT* ldb,
+                       T beta,
+                       T* const* c,
+                       const MKL_INT* ldc,
+                       MKL_INT batch_size)
+{
+#pragma omp parallel for schedule(dynamic)
+    for (MKL_INT l = 0; l < batch_size; ++l) {
+        // clang-format off
+        native_gemm_cols(
+            transa, transb, m[l], 0, n[l], k[l], alpha, a[l], lda[l], b[l],
+            ldb[l], beta, c[l], ldc[l]);
+        // clang-format on
+    }
+}
+
+// Compute y = alpha * op(a) * x + beta * y, where a is m x n.
+template <class T>
+void native_gemv(char transa,
+                 MKL_INT m,
+                 MKL_INT n,
+                 T alpha,
+                 const T* a,
+                 MKL_INT lda,
+                 const T* x,
+                 MKL_INT incx,
+                 T beta,
+                 T* y,
+                 MKL_INT incy)
+{
+    const bool ta = (transa == 'T') || (transa == 't');
+    if (ta) {
+        for (MKL_INT j = 0; j < n; ++j) {
+            const T* aj = a + j * lda;
+            T sum       = T(0);
+            for (MKL_INT i = 0; i < m; ++i) {
+                sum += aj[i] * x[i * incx];
+            }
+            T& yj = y[j * incy];
+            yj    = (beta == T(0)) ? alpha * sum : alpha * sum + beta * yj;
+        }
+    }
+    else {
+        for (MKL_INT i = 0; i < m; ++i) {
+            T& yi = y[i * incy];
+            yi    = (beta == T(0)) ? T(0) : beta * yi;
+        }
+        for (MKL_INT j = 0; j < n; ++j) {
+            const T* aj = a + j * lda;
+            T xj        = alpha * x[j * incx];
+            for (MKL_INT i = 0; i < m; ++i) {
+                y[i * incy] += xj * aj[i];
+            }
+        }
+    }
+}
+
+// Compute y = alpha * x + y.
+template <class T>
+void native_axpy(
+    MKL_INT n, T alpha, const T* x, MKL_INT incx, T* y, MKL_INT incy)
+{
+    for (MKL_INT i = 0; i < n; ++i) {
+        y[i * incy] += alpha * x[i * incx];
+    }
+}
+
+// Compute x^T * y.
+template <class T>
+T native_dot(MKL_INT n, const T* x, MKL_INT incx, const T* y, MKL_INT incy)
+{
+    T result = T(0);
+    for (MKL_INT i = 0; i < n; ++i) {
+        result += x[i * incx] * y[i * incy];
+    }
+    return result;
+}
+
+// Compute y = alpha * op(a) * x + beta * y, where a is an m x n band matrix
+// with kl subdiagonals and ku superdiagonals in BLAS band storage.
+template <class T>
+void native_gbmv(char transa,
+                 MKL_INT m,
+                 MKL_INT n,
+                 MKL_INT kl,
+                 MKL_INT ku,
+                 T alpha,
+                 const T* a,
+                 MKL_INT lda,
+                 const T* x,
+                 MKL_INT incx,
+                 T beta,
+                 T* y,
+                 MKL_INT incy)
+{
+    const bool ta = (transa == 'T') || (transa == 't');
+    if (ta) {
+#pragma omp parallel for schedule(static)
+        for (MKL_INT j = 0; j < n; ++j) {
+            const T* aj    = a + ku - j + j * lda;
+            MKL_INT ifirst = std::max<MKL_INT>(0, j - ku);
+            MKL_INT ilast  = std::min<MKL_INT>(m, j + kl + 1);
+            T sum          = T(0);
+            for (MKL_INT i = ifirst; i < ilast; ++i) {
+                sum += aj[i] * x[i * incx];
+            }
+            T& yj = y[j * incy];
+            yj    = (beta == T(0)) ? alpha * sum : alpha * sum + beta * yj;
+        }
+    }
+    else {
+        for (MKL_INT i = 0; i < m; ++i) {
+            T& yi = y[i * incy];
+            yi    = (beta == T(0)) ? T(0) : beta * yi;
+        }
+        for (MKL_INT j = 0; j < n; ++j) {
+            const T* aj    = a + ku - j + j * lda;
+            MKL_INT ifirst = std::max<MKL_INT>(0, j - ku);
+            MKL_INT ilast  = std::min<MKL_INT>(m, j + kl + 1);
+            T xj           = alpha * x[j * incx];
+#pragma omp simd
+            for (MKL_INT i = ifirst; i < ilast; ++i) {
+                y[i * incy] += xj * aj[i];
+            }
+        }
+    }
+}
+
+// Compute y = alpha * a * x + beta * y, where a is an n x n symmetric band
+// matrix with k super- (uplo = 'U') or subdiagonals (uplo = 'L') in BLAS
+// band storage.
+template <class T>
+void native_sbmv(char uplo,
+                 MKL_INT n,
+                 MKL_INT k,
+                 T alpha,
+                 const T* a,
+                 MKL_INT lda,
+                 const T* x,
+                 MKL_INT incx,
+                 T beta,
+                 T* y,
+                 MKL_INT incy)
+{
+    const bool upper = (uplo == 'U') || (uplo == 'u');
+
+    for (MKL_INT i = 0; i < n; ++i) {
+        T& yi = y[i * incy];
+        yi    = (beta == T(0)) ? T(0) : beta * yi;
+    }
+    // Each stored element a(i, j) contributes to both y(i) and y(j).
+    for (MKL_INT j = 0; j < n; ++j) {
+        T xj  = alpha * x[j * incx];
+        T sum = T(0);
+        if (upper) {
+            const T* aj = a + k - j + j * lda;
+            for (MKL_INT i = std::max<MKL_INT>(0, j - k); i < j; ++i) {
+                y[i * incy] += xj * aj[i];
+                sum += aj[i] * x[i * incx];
+            }
+            y[j * incy] += xj * aj[j] + alpha * sum;
+        }
+        else {
+            const T* aj  = a - j + j * lda;
+            MKL_INT iend = std::min<MKL_INT>(n, j + k + 1);
+            for (MKL_INT i = j + 1; i < iend; ++i) {
+                y[i * incy] += xj * aj[i];
+                sum += aj[i] * x[i * incx];
+            }
+            y[j * incy] += xj * aj[j] + alpha * sum;
+        }
+    }
+}
+
+// Compute y = alpha * a * x + beta * y, where a is a symmetric n x n matrix
+// with the upper or lower triangle in packed storage.
+template <class T>
+void native_spmv(char uplo,
+                 MKL_INT n,
+                 T alpha,
+                 const T* ap,
+                 const T* x,
+                 MKL_INT incx,
+                 T beta,
+                 T* y,
+                 MKL_INT incy)
+{
+    const bool upper = (uplo == 'U') || (uplo == 'u');
+
+    for (MKL_INT i = 0; i < n; ++i) {
+        T& yi = y[i * incy];
+        yi    = (beta == T(0)) ? T(0) : beta * yi;
+    }
+    // Each stored element a(i, j) contributes to both y(i) and y(j).
+    for (MKL_INT j = 0; j < n; ++j) {
+        T xj  = alpha * x[j * incx];
+        T sum = T(0);
+        if (upper) {
+            const T* aj = ap + j * (j + 1) / 2;
+            for (MKL_INT i = 0; i < j; ++i) {
+                y[i * incy] += xj * aj[i];
+                sum += aj[i] * x[i * incx];
+            }
+            y[j * incy] += xj * aj[j] + alpha * sum;
+        }
+        else {
+            const T* aj = ap + j * (2 * n - j + 1) / 2 - j;
+            for (MKL_INT i = j + 1; i < n; ++i) {
+                y[i * incy] += xj * aj[i];
+                sum += aj[i] * x[i * incx];
+            }
+            y[j * incy] += xj * aj[j] + alpha * sum;
+        }
+    }
+}
+
+// Compute y = alpha * a * x + beta * y, where a is a symmetric n x n matrix
+// with the upper or lower triangle in full storage.
+template <class T>
+void native_symv(char uplo,
+                 MKL_INT n,
+                 T alpha,
+                 const T* a,
+                 MKL_INT lda,
+                 const T* x,
+                 MKL_INT incx,
+                 T beta,
+                 T* y,
+                 MKL_INT incy)
+{
+    const bool upper = (uplo == 'U') || (uplo == 'u');
+
+    for (MKL_INT i = 0; i < n; ++i) {
+        T& yi = y[i * incy];
+        yi    = (beta == T(0)) ? T(0) : beta * yi;
+    }
+    // Each stored element a(i, j) contributes to both y(i) and y(j).
+    for (MKL_INT j = 0; j < n; ++j) {
+        const T* aj = a + j * lda;
+        T xj        = alpha * x[j * incx];
+        T sum       = T(0);
+        MKL_INT i0  = upper ? 0 : j + 1;
+        MKL_INT i1  = upper ? j : n;
+        for (MKL_INT i = i0; i < i1; ++i) {
+            y[i * incy] += xj * aj[i];
+            sum += aj[i] * x[i * incx];
+        }
+        y[j * incy] += xj * aj[j] + alpha * sum;
+    }
+}
+
+// Compute c = alpha * a * b + beta * c (side = 'L') or c = alpha * b * a +
+// beta * c (side = 'R'), where c is m x n and a is symmetric with the upper
+// or lower triangle in full storage. The columns of c are computed in
+// parallel.
+template <class T>
+void native_symm(char side,
+                 char uplo,
+                 MKL_INT m,
+                 MKL_INT n,
+                 T alpha,
+                 const T* a,
+                 MKL_INT lda,
+                 const T* b,
+                 MKL_INT ldb,
+                 T beta,
+                 T* c,
+                 MKL_INT ldc)
+{
+    const bool left  = (side == 'L') || (side == 'l');
+    const bool upper = (uplo == 'U') || (uplo == 'u');
+
+    // Element (i, j) of a, read from the stored triangle.
+    auto aij = [=](MKL_INT i, MKL_INT j) {
+        return ((i <= j) == upper) ? a[i + j * lda] : a[j + i * lda];
+    };
+
+#pragma omp parallel for schedule(static)
+    for (MKL_INT j = 0; j < n; ++j) {
+        T* cj = c + j * ldc;
+        for (MKL_INT i = 0; i < m; ++i) {
+            cj[i] = (beta == T(0)) ? T(0) : beta * cj[i];
+        }
+        if (left) {
+            for (MKL_INT k = 0; k < m; ++k) {
+                T bkj = alpha * b[k + j * ldb];
+                for (MKL_INT i = 0; i < m; ++i) {
+                    cj[i] += aij(i, k) * bkj;
+                }
+            }
+        }
+        else {
+            for (MKL_INT k = 0; k < n; ++k) {
+                const T* bk = b + k * ldb;
+                T akj       = alpha * aij(k, j);
+                for (MKL_INT i = 0; i < m; ++i) {
+                    cj[i] += bk[i] * akj;
+                }
+            }
+        }
+    }
+}
+
+// Compute x = alpha * x.
+template <class T>
+void native_scal(MKL_INT n, T alpha, T* x, MKL_INT incx)
+{
+    for (MKL_INT i = 0; i < n; ++i) {
+        x[i * incx] *= alpha;
+    }
+}
+
+// Copy x to y.
+template <class T>
+void native_copy(MKL_INT n, const T* x, MKL_INT incx, T* y, MKL_INT incy)
+{
+    for (MKL_INT i = 0; i < n; ++i) {
+        y[i * incy] = x[i * incx];
+    }
+}
+
+// Euclidean norm of x, scaled to avoid overflow.
+template <class T>
+T native_nrm2(MKL_INT n, const T* x, MKL_INT incx)
+{
+    T scale = T(0);
+    T ssq   = T(1);
+    for (MKL_INT i = 0; i < n; ++i) {
+        if (x[i * incx] != T(0)) {
+            T absxi = std::abs(x[i * incx]);
+            if (scale < absxi) {
+                ssq   = T(1) + ssq * (scale / absxi) * (scale / absxi);
+                scale = absxi;
+            }
+            else {
+                ssq += (absxi / scale) * (absxi / scale);
+            }
+        }
+    }
+    return scale * std::sqrt(ssq);
+}
+
+// Compute b = alpha * op(a), where a is rows x cols.
+template <class T>
+void native_omatcopy(char trans,
+                     MKL_INT rows,
+                     MKL_INT cols,
+                     T alpha,
+                     const T* a,
+                     MKL_INT lda,
+                     T* b,
+                     MKL_INT ldb)
+{
+    const bool ta = (trans == 'T') || (trans == 't');
+    for (MKL_INT j = 0; j < cols; ++j) {
+        for (MKL_INT i = 0; i < rows; ++i) {
+            if (ta) {
+                b[j + i * ldb] = alpha * a[i + j * lda];
+            }
+            else {
+                b[i + j * ldb] = alpha * a[i + j * lda];
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Backend dispatch for double precision:
+
+void gemm(char transa,
+          char transb,
+          MKL_INT m,
+          MKL_INT n,
+          MKL_INT k,
+          double alpha,
+          const double* a,
+          MKL_INT lda,
+          const double* b,
+          MKL_INT ldb,
+          double beta,
+          double* c,
+          MKL_INT ldc);
+
+void gemv(char transa,
+          MKL_INT m,
+          MKL_INT n,
+          double alpha,
+          const double* a,
+          MKL_INT lda,
+          const double* x,
+          MKL_INT incx,
+          double beta,
+          double* y,
+          MKL_INT incy);
+
+void axpy(MKL_INT n,
+          double alpha,
+          const double* x,
+          MKL_INT incx,
+          double* y,
+          MKL_INT incy);
+
+double dot(
+    MKL_INT n, const double* x, MKL_INT incx, const double* y, MKL_INT incy);
+
+void scal(MKL_INT n, double alpha, double* x, MKL_INT incx);
+
+void copy(MKL_INT n, const double* x, MKL_INT incx, double* y, MKL_INT incy);
+
+double nrm2(MKL_INT n, const double* x, MKL_INT incx);
+
+void omatcopy(char trans,
+              MKL_INT rows,
+              MKL_INT cols,
+              double alpha,
+              const double* a,
+              MKL_INT lda,
+              double* b,
+              MKL_INT ldb);
+
+//------------------------------------------------------------------------------
+
+// Backend dispatch for single precision and complex types:
+
+void gemm(char transa,
+          char transb,
+          MKL_INT m,
+          MKL_INT n,
+          MKL_INT k,
+          float alpha,
+          const float* a,
+          MKL_INT lda,
+          const float* b,
+          MKL_INT ldb,
+          float beta,
+          float* c,
+          MKL_INT ldc);
+
+void gemv(char transa,
+          MKL_INT m,
+          MKL_INT n,
+          float alpha,
+          const float* a,
+          MKL_INT lda,
+          const float* x,
+          MKL_INT incx,
+          float beta,
+          float* y,
+          MKL_INT incy);
+
+void axpy(MKL_INT n,
+          float alpha,
+          const float* x,
+          MKL_INT incx,
+          float* y,
+          MKL_INT incy);
+
+float dot(
+    MKL_INT n, const float* x, MKL_INT incx, const float* y, MKL_INT incy);
+
+void gemm(char transa,
+          char transb,
+          MKL_INT m,
+          MKL_INT n,
+          MKL_INT k,
+          std::complex<float> alpha,
+          const std::complex<float>* a,
+          MKL_INT lda,
+          const std::complex<float>* b,
+          MKL_INT ldb,
+          std::complex<float> beta,
+          std::complex<float>* c,
+          MKL_INT ldc);
+
+void gemv(char transa,
+          MKL_INT m,
+          MKL_INT n,
+          std::complex<float> alpha,
+          const std::complex<float>* a,
+          MKL_INT lda,
+          const std::complex<float>* x,
+          MKL_INT incx,
+          std::complex<float> beta,
+          std::complex<float>* y,
+          MKL_INT incy);
+
+void axpy(MKL_INT n,
+          std::complex<float> alpha,
+          const std::complex<float>* x,
+          MKL_INT incx,
+          std::complex<float>* y,
+          MKL_INT incy);
+
+std::complex<float> dot(MKL_INT n,
+                        const std::complex<float>* x,
+                        MKL_INT incx,
+                        const std::complex<float>* y,
+                        MKL_INT incy);
+
+void gemm(char transa,
+          char transb,
+          MKL_INT m,
+          MKL_INT n,
+          MKL_INT k,
+          std::complex<double> alpha,
+          const std::complex<double>* a,
+          MKL_INT lda,
+          const std::complex<double>* b,
+          MKL_INT ldb,
+          std::complex<double> beta,
+          std::complex<double>* c,
+          MKL_INT ldc);
+
+void gemv(char transa,
+          MKL_INT m,
+          MKL_INT n,
+          std::complex<double> alpha,
+          const std::complex<double>* a,
+          MKL_INT lda,
+          const std::complex<double>* x,
+          MKL_INT incx,
+          std::complex<double> beta,
+          std::complex<double>* y,
+          MKL_INT incy);
+
+void axpy(MKL_INT n,
+          std::complex<double> alpha,
+          const std::complex<double>* x,
+          MKL_INT incx,
+          std::complex<double>* y,
+          MKL_INT incy);
+
+std::complex<double> dot(MKL_INT n,
+                         const std::complex<double>* x,
+                         MKL_INT incx,
+                         const std::complex<double>* y,
+                         MKL_INT incy);
+
+//------------------------------------------------------------------------------
+
+// Batched matrix-matrix products, dispatched to the MKL batch interface and
+// to the threaded native kernels for the other backends:
+
+void gemm_batch_strided(char transa,
+                        char transb,
+                        MKL_INT m,
+                        MKL_INT n,
+                        MKL_INT k,
+                        float alpha,
+                        const float* a,
+                        MKL_INT lda,
+                        MKL_INT stridea,
+                        const float* b,
+                        MKL_INT ldb,
+                        MKL_INT strideb,
+                        float beta,
+                        float* c,
+                        MKL_INT ldc,
+                        MKL_INT stridec,
+                        MKL_INT batch_size);
+
+void gemm_batch(char transa,
+                char transb,
+                const MKL_INT* m,
+                const MKL_INT* n,
+                const MKL_INT* k,
+                float alpha,
+                const float* const* a,
+                const MKL_INT* lda,
+                const float* const* b,
+                const MKL_INT* ldb,
+                float beta,
+                float* const* c,
+                const MKL_INT* ldc,
+                MKL_INT batch_size);
+
+void gemm_batch_strided(char transa,
+                        char transb,
+                        MKL_INT m,
+                        MKL_INT n,
+                        MKL_INT k,
+                        double alpha,
+                        const double* a,
+                        MKL_INT lda,
+                        MKL_INT stridea,
+                        const double* b,
+                        MKL_INT ldb,
+                        MKL_INT strideb,
+                        double beta,
+                        double* c,
+                        MKL_INT ldc,
+                        MKL_INT stridec,
+                        MKL_INT batch_size);
+
+void gemm_batch(char transa,
+                char transb,
+                const MKL_INT* m,
+                const MKL_INT* n,
+                const MKL_INT* k,
+                double alpha,
+                const double* const* a,
+                const MKL_INT* lda,
+                const double* const* b,
+                const MKL_INT* ldb,
+                double beta,
+                double* const* c,
+                const MKL_INT* ldc,
+                MKL_INT batch_size);
+
+void gemm_batch_strided(char transa,
+                        char transb,
+                        MKL_INT m,
+                        MKL_INT n,
+                        MKL_INT k,
+                        std::complex<float> alpha,
+                        const std::complex<float>* a,
+                        MKL_INT lda,
+                        MKL_INT stridea,
+                        const std::complex<float>* b,
+                        MKL_INT ldb,
+                        MKL_INT strideb,
+                        std::complex<float> beta,
+                        std::complex<float>* c,
+                        MKL_INT ldc,
+                        MKL_INT stridec,
+                        MKL_INT batch_size);
+
+void gemm_batch(char transa,
+                char transb,
+                const MKL_INT* m,
+                const MKL_INT* n,
+                const MKL_INT* k,
+                std::complex<float> alpha,
+                const std::complex<float>* const* a,
+                const MKL_INT* lda,
+                const std::complex<float>* const* b,
+                const MKL_INT* ldb,
+                std::complex<float> beta,
+                std::complex<float>* const* c,
+                const MKL_INT* ldc,
+                MKL_INT batch_size);
+
+void gemm_batch_strided(char transa,
+                        char transb,
+                        MKL_INT m,
+                        MKL_INT n,
+                        MKL_INT k,
+                        std::complex<double> alpha,
+                        const std::complex<double>* a,
+                        MKL_INT lda,
+                        MKL_INT stridea,
+                        const std::complex<double>* b,
+                        MKL_INT ldb,
+                        MKL_INT strideb,
+                        std::complex<double> beta,
+                        std::complex<double>* c,
+                        MKL_INT ldc,
+                        MKL_INT stridec,
+                        MKL_INT batch_size);
+
+void gemm_batch(char transa,
+                char transb,
+                const MKL_INT* m,
+                const MKL_INT* n,
+                const MKL_INT* k,
+                std::complex<double> alpha,
+                const std::complex<double>* const* a,
+                const MKL_INT* lda,
+                const std::complex<double>* const* b,
+                const MKL_INT* ldb,
+                std::complex<double> beta,
+                std::complex<double>* const* c,
+                const MKL_INT* ldc,
+                MKL_INT batch_size);
+
+//------------------------------------------------------------------------------
+
+// Band matrix-vector products (sbmv for real types only):
+
+void gbmv(char transa,
+          MKL_INT m,
+          MKL_INT n,
+          MKL_INT kl,
+          MKL_INT ku,
+          float alpha,
+          const float* a,
+          MKL_INT lda,
+          const float* x,
+          MKL_INT incx,
+          float beta,
+          float* y,
+          MKL_INT incy);
+
+void sbmv(char uplo,
+          MKL_INT n,
+          MKL_INT k,
+          float alpha,
+          const float* a,
+          MKL_INT lda,
+          const float* x,
+          MKL_INT incx,
+          float beta,
+          float* y,
+          MKL_INT incy);
+
+void gbmv(char transa,
+          MKL_INT m,
+          MKL_INT n,
+          MKL_INT kl,
+          MKL_INT ku,
+          double alpha,
+          const double* a,
+          MKL_INT lda,
+          const double* x,
+          MKL_INT incx,
+          double beta,
+          double* y,
+          MKL_INT incy);
+
+void sbmv(char uplo,
+          MKL_INT n,
+          MKL_INT k,
+          double alpha,
+          const double* a,
+          MKL_INT lda,
+          const double* x,
+          MKL_INT incx,
+          double beta,
+          double* y,
+          MKL_INT incy);
+
+void gbmv(char transa,
+          MKL_INT m,
+          MKL_INT n,
+          MKL_INT kl,
+          MKL_INT ku,
+          std::complex<float> alpha,
+          const std::complex<float>* a,
+          MKL_INT lda,
+          const std::complex<float>* x,
+          MKL_INT incx,
+          std::complex<float> beta,
+          std::complex<float>* y,
+          MKL_INT incy);
+
+void gbmv(char transa,
+          MKL_INT m,
+          MKL_INT n,
+          MKL_INT kl,
+          MKL_INT ku,
+          std::complex<double> alpha,
+          const std::complex<double>* a,
+          MKL_INT lda,
+          const std::complex<double>* x,
+          MKL_INT incx,
+          std::complex<double> beta,
+          std::complex<double>* y,
+          MKL_INT incy);
+
+//------------------------------------------------------------------------------
+
+// Packed symmetric matrix-vector products (real types only):
+
+void spmv(char uplo,
+          MKL_INT n,
+          float alpha,
+          const float* ap,
+          const float* x,
+          MKL_INT incx,
+          float beta,
+          float* y,
+          MKL_INT incy);
+
+void spmv(char uplo,
+          MKL_INT n,
+          double alpha,
+          const double* ap,
+          const double* x,
+          MKL_INT incx,
+          double beta,
+          double* y,
+          MKL_INT incy);
+
+//------------------------------------------------------------------------------
+
+// Symmetric matrix-vector and matrix-matrix products (real types only):
+
+void symv(char uplo,
+          MKL_INT n,
+          float alpha,
+          const float* a,
+          MKL_INT lda,
+          const float* x,
+          MKL_INT incx,
+          float beta,
+          float* y,
+          MKL_INT incy);
+
+void symm(char side,
+          char uplo,
+          MKL_INT m,
+          MKL_INT n,
+          float alpha,
+          const float* a,
+          MKL_INT lda,
+          const float* b,
+          MKL_INT ldb,
+          float beta,
+          float* c,
+          MKL_INT ldc);
+
+void symv(char uplo,
+          MKL_INT n,
+          double alpha,
+          const double* a,
+          MKL_INT lda,
+          const double* x,
+          MKL_INT incx,
+          double beta,
+          double* y,
+          MKL_INT incy);
+
+void symm(char side,
+          char uplo,
+          MKL_INT m,
+          MKL_INT n,
+          double alpha,
+          const double* a,
+          MKL_INT lda,
+          const double* b,
+          MKL_INT ldb,
+          double beta,
+          double* c,
+          MKL_INT ldc);
+
+//------------------------------------------------------------------------------
+
+// Fallback on the native kernels for types not supported by BLAS:
+
+template <class T>
+inline void gemm(char transa,
+                 char transb,
+                 MKL_INT m,
+                 MKL_INT n,
+                 MKL_INT k,
+                 T alpha,
+                 const T* a,
+                 MKL_INT lda,
+                 const T* b,
+                 MKL_INT ldb,
+                 T beta,
+                 T* c,
+                 MKL_INT ldc)
+{
+    native_gemm(transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+template <class T>
+inline void gemv(char transa,
+                 MKL_INT m,
+                 MKL_INT n,
+                 T alpha,
+                 const T* a,
+                 MKL_INT lda,
+                 const T* x,
+                 MKL_INT incx,
+                 T beta,
+                 T* y,
+                 MKL_INT incy)
+{
+    native_gemv(transa, m, n, alpha, a, lda, x, incx, beta, y, incy);
+}
+
+template <class T>
+inline void axpy(
+    MKL_INT n, T alpha, const T* x, MKL_INT incx, T* y, MKL_INT incy)
+{
+    native_axpy(n, alpha, x, incx, y, incy);
+}
+
+template <class T>
+inline T dot(MKL_INT n, const T* x, MKL_INT incx, const T* y, MKL_INT incy)
+{
+    return native_dot(n, x, incx, y, incy);
+}
+
+template <class T>
+inline void gemm_batch_strided(char transa,
+                               char transb,
+                               MKL_INT m,
+                               MKL_INT n,
+                               MKL_INT k,
+                               T alpha,
+                               const T* a,
+                               MKL_INT lda,
+                               MKL_INT stridea,
+                               const T* b,
+                               MKL_INT ldb,
+                               MKL_INT strideb,
+                               T beta,
+                               T* c,
+                               MKL_INT ldc,
+                               MKL_INT stridec,
+                               MKL_INT batch_size)
+{
+    // clang-format off
+    native_gemm_batch_strided(
+        transa, transb, m, n, k, alpha, a, lda, stridea, b, ldb, strideb,
+        beta, c, ldc, stridec, batch_size);
+    // clang-format on
+}
+
+template <class T>
+inline void gemm_batch(char transa,
+                       char transb,
+                       const MKL_INT* m,
+                       const MKL_INT* n,
+                       const MKL_INT* k,
+                       T alpha,
+                       const T* const* a,
+                       const MKL_INT* lda,
+                       const T* const* b,
+                       const MKL_INT* ldb,
+                       T beta,
+                       T* const* c,
+                       const MKL_INT* ldc,
+                       MKL_INT batch_size)
+{
+    // clang-format off
+    native_gemm_batch(
+        transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+        batch_size);
+    // clang-format on
+}
+
+template <class T>
+inline void gbmv(char transa,
+                 MKL_INT m,
+                 MKL_INT n,
+                 MKL_INT kl,
+                 MKL_INT ku,
+                 T alpha,
+                 const T* a,
+                 MKL_INT lda,
+                 const T* x,
+                 MKL_INT incx,
+                 T beta,
+                 T* y,
+                 MKL_INT incy)
+{
+    // clang-format off
+    native_gbmv(
+        transa, m, n, kl, ku, alpha, a, lda, x, incx, beta, y, incy);
+    // clang-format on
+}
+
+template <class T>
+inline void sbmv(char uplo,
+                 MKL_INT n,
+                 MKL_INT k,
+                 T alpha,
+                 const T* a,
+                 MKL_INT lda,
+                 const T* x,
+                 MKL_INT incx,
+                 T beta,
+                 T* y,
+                 MKL_INT incy)
+{
+    native_sbmv(uplo, n, k, alpha, a, lda, x, incx, beta, y, incy);
+}
+
+template <class T>
+inline void spmv(char uplo,
+                 MKL_INT n,
+                 T alpha,
+                 const T* ap,
+                 const T* x,
+                 MKL_INT incx,
+                 T beta,
+                 T* y,
+                 MKL_INT incy)
+{
+    native_spmv(uplo, n, alpha, ap, x, incx, beta, y, incy);
+}
+
+template <class T>
+inline void symv(char uplo,
+                 MKL_INT n,
+                 T alpha,
+                 const T* a,
+                 MKL_INT lda,
+                 const T* x,
+                 MKL_INT incx,
+                 T beta,
+                 T* y,
+                 MKL_INT incy)
+{
+    native_symv(uplo, n, alpha, a, lda, x, incx, beta, y, incy);
+}
+
+template <class T>
+inline void symm(char side,
+                 char uplo,
+                 MKL_INT m,
+                 MKL_INT n,
+                 T alpha,
+                 const T* a,
+                 MKL_INT lda,
+                 const T* b,
+                 MKL_INT ldb,
+                 T beta,
+                 T* c,
+                 MKL_INT ldc)
+{
+    // clang-format off
+    native_symm(
+        side, uplo, m, n, alpha, a, lda, b, ldb, beta, c, ldc);
+    // clang-format on
+}
+
+}  // namespace blas
+}  // namespace srs
+
+#endif  // SRS_MATH_BLAS_H
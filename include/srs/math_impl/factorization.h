@@ -0,0 +1,361 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SRS_MATH_FACTORIZATION_H
+#define SRS_MATH_FACTORIZATION_H
+
+#include <srs/math_impl/backend.h>
+#include <srs/array.h>
+#include <srs/band.h>
+#include <srs/packed.h>
+#include <srs/rfp.h>
+#include <srs/types.h>
+
+
+//
+// Provides matrix factorization classes.
+//
+// Features:
+// - The factorization is computed once and can be reused for solving any
+//   number of systems of equations.
+// - Cholesky and LDL^T factorizations of real symmetric matrices held in
+//   full, packed, RFP or band storage (where supported by LAPACK).
+// - LU factorization with partial pivoting of general band matrices.
+// - Householder QR factorization, optionally with column pivoting, for
+//   least squares problems.
+//
+// Note:
+// - The general Cholesky, Ldlt and Lu templates exist only to allow
+//   specializations.
+// - The upper triangle of the symmetric matrices is referenced.
+// - Requires a backend with LAPACK (see backend.h).
+//
+#ifdef SRS_HAVE_LAPACK
+namespace srs {
+
+//------------------------------------------------------------------------------
+
+// Cholesky factorization of a real symmetric positive definite matrix.
+template <class M>
+class Cholesky {
+private:
+    Cholesky();
+};
+
+// Cholesky factorization a = u^T * u of a matrix in full storage.
+template <>
+class Cholesky<dmatrix> {
+public:
+    typedef Int_t size_type;
+
+    Cholesky() : u() {}
+
+    explicit Cholesky(const dmatrix& a) { factorize(a); }
+
+    // Compute factorization of a new matrix.
+    void factorize(const dmatrix& a);
+
+    // Solve a * x = b. On exit, b holds the solution.
+    void solve(dmatrix& b) const;
+    void solve(dvector& b) const;
+
+    // Rank-one update of the factorization to that of a + x * x^T.
+    void update(const dvector& x);
+
+    // Rank-one downdate of the factorization to that of a - x * x^T.
+    void downdate(const dvector& x);
+
+    // Determinant of the factorized matrix.
+    double det() const;
+
+    // Upper triangular Cholesky factor.
+    const dmatrix& factor() const { return u; }
+
+    size_type rows() const { return u.rows(); }
+    size_type cols() const { return u.cols(); }
+
+private:
+    dmatrix u;
+};
+
+// Cholesky factorization of a matrix in packed storage.
+template <>
+class Cholesky<packed_dmatrix> {
+public:
+    typedef Int_t size_type;
+
+    Cholesky() : u() {}
+
+    explicit Cholesky(const packed_dmatrix& a) { factorize(a); }
+
+    // Compute factorization of a new matrix.
+    void factorize(const packed_dmatrix& a);
+
+    // Solve a * x = b. On exit, b holds the solution.
+    void solve(dmatrix& b) const;
+    void solve(dvector& b) const;
+
+    // Rank-one update of the factorization to that of a + x * x^T.
+    void update(const dvector& x);
+
+    // Rank-one downdate of the factorization to that of a - x * x^T.
+    void downdate(const dvector& x);
+
+    // Determinant of the factorized matrix.
+    double det() const;
+
+    // Upper triangular Cholesky factor in packed storage.
+    const packed_dmatrix& factor() const { return u; }
+
+    size_type rows() const { return u.rows(); }
+    size_type cols() const { return u.cols(); }
+
+private:
+    packed_dmatrix u;
+};
+
+// Cholesky factorization of a matrix in rectangular full packed storage.
+// Uses the blocked dpftrf, which runs at level 3 BLAS speed with the
+// memory footprint of packed storage.
+template <>
+class Cholesky<rfp_dmatrix> {
+public:
+    typedef Int_t size_type;
+
+    Cholesky() : u() {}
+
+    explicit Cholesky(const rfp_dmatrix& a) { factorize(a); }
+
+    // Compute factorization of a new matrix.
+    void factorize(const rfp_dmatrix& a);
+
+    // Solve a * x = b. On exit, b holds the solution.
+    void solve(dmatrix& b) const;
+    void solve(dvector& b) const;
+
+    // Determinant of the factorized matrix.
+    double det() const;
+
+    // Upper triangular Cholesky factor in RFP storage; the elements (i, j)
+    // with i <= j are the factor.
+    const rfp_dmatrix& factor() const { return u; }
+
+    size_type rows() const { return u.rows(); }
+    size_type cols() const { return u.cols(); }
+
+private:
+    rfp_dmatrix u;
+};
+
+// Cholesky factorization of a matrix in band storage (kl = ku).
+template <>
+class Cholesky<band_dmatrix> {
+public:
+    typedef Int_t size_type;
+
+    Cholesky() : u() {}
+
+    explicit Cholesky(const band_dmatrix& a) { factorize(a); }
+
+    // Compute factorization of a new matrix.
+    void factorize(const band_dmatrix& a);
+
+    // Solve a * x = b. On exit, b holds the solution.
+    void solve(dmatrix& b) const;
+    void solve(dvector& b) const;
+
+    // Determinant of the factorized matrix.
+    double det() const;
+
+    // Upper triangular Cholesky factor held in the upper band.
+    const band_dmatrix& factor() const { return u; }
+
+    size_type rows() const { return u.rows(); }
+    size_type cols() const { return u.cols(); }
+
+private:
+    band_dmatrix u;
+};
+
+//------------------------------------------------------------------------------
+
+// LDL^T factorization of a real symmetric indefinite matrix using the
+// Bunch-Kaufman diagonal pivoting method.
+template <class M>
+class Ldlt {
+private:
+    Ldlt();
+};
+
+// LDL^T factorization of a matrix in full storage.
+template <>
+class Ldlt<dmatrix> {
+public:
+    typedef Int_t size_type;
+
+    Ldlt() : ld(), ipiv() {}
+
+    explicit Ldlt(const dmatrix& a) { factorize(a); }
+
+    // Compute factorization of a new matrix.
+    void factorize(const dmatrix& a);
+
+    // Solve a * x = b. On exit, b holds the solution.
+    void solve(dmatrix& b) const;
+    void solve(dvector& b) const;
+
+    // Block diagonal matrix D and multipliers as returned by dsytrf.
+    const dmatrix& factor() const { return ld; }
+
+    // Pivot indices as returned by dsytrf (one-based).
+    const ivector& pivots() const { return ipiv; }
+
+    size_type rows() const { return ld.rows(); }
+    size_type cols() const { return ld.cols(); }
+
+private:
+    dmatrix ld;
+    ivector ipiv;
+};
+
+// LDL^T factorization of a matrix in packed storage.
+template <>
+class Ldlt<packed_dmatrix> {
+public:
+    typedef Int_t size_type;
+
+    Ldlt() : ld(), ipiv() {}
+
+    explicit Ldlt(const packed_dmatrix& a) { factorize(a); }
+
+    // Compute factorization of a new matrix.
+    void factorize(const packed_dmatrix& a);
+
+    // Solve a * x = b. On exit, b holds the solution.
+    void solve(dmatrix& b) const;
+    void solve(dvector& b) const;
+
+    // Block diagonal matrix D and multipliers as returned by dsptrf.
+    const packed_dmatrix& factor() const { return ld; }
+
+    // Pivot indices as returned by dsptrf (one-based).
+    const ivector& pivots() const { return ipiv; }
+
+    size_type rows() const { return ld.rows(); }
+    size_type cols() const { return ld.cols(); }
+
+private:
+    packed_dmatrix ld;
+    ivector ipiv;
+};
+
+//------------------------------------------------------------------------------
+
+// LU factorization a = p * l * u with partial pivoting.
+template <class M>
+class Lu {
+private:
+    Lu();
+};
+
+// LU factorization of a square matrix in band storage. The factorization
+// requires O(n * kl * (kl + ku)) operations, and u has kl + ku
+// superdiagonals due to fill-in from the row interchanges.
+template <>
+class Lu<band_dmatrix> {
+public:
+    typedef Int_t size_type;
+
+    Lu() : lu(), ipiv() {}
+
+    explicit Lu(const band_dmatrix& a) { factorize(a); }
+
+    // Compute factorization of a new matrix.
+    void factorize(const band_dmatrix& a);
+
+    // Solve a * x = b. On exit, b holds the solution.
+    void solve(dmatrix& b) const;
+    void solve(dvector& b) const;
+
+    // Determinant of the factorized matrix.
+    double det() const;
+
+    // Factor u and multipliers of l as returned by dgbtrf; the band has kl
+    // subdiagonals and kl + ku superdiagonals.
+    const band_dmatrix& factor() const { return lu; }
+
+    // Pivot indices as returned by dgbtrf (one-based).
+    const ivector& pivots() const { return ipiv; }
+
+    size_type rows() const { return lu.rows(); }
+    size_type cols() const { return lu.cols(); }
+
+private:
+    band_dmatrix lu;
+    ivector ipiv;
+};
+
+//------------------------------------------------------------------------------
+
+// Householder QR factorization of a real m x n matrix, a * p = q * r, where
+// p is a permutation matrix if column pivoting is used and the identity
+// otherwise.
+class Qr {
+public:
+    typedef Int_t size_type;
+
+    Qr() : qr(), tau(), jpvt(), pivoting(false) {}
+
+    explicit Qr(const dmatrix& a, bool pivot = false) { factorize(a, pivot); }
+
+    // Compute factorization of a new matrix.
+    void factorize(const dmatrix& a, bool pivot = false);
+
+    // Solve the least squares problem min ||a * x - b|| for m >= n. On exit,
+    // b holds the n x nrhs solution. With column pivoting, rank deficient
+    // problems are solved by setting the components of x associated with
+    // negligible diagonal elements of r to zero.
+    void solve(dmatrix& b) const;
+    void solve(dvector& b) const;
+
+    // Orthogonal factor q (m x min(m, n)).
+    dmatrix q() const;
+
+    // Upper triangular factor r (min(m, n) x n).
+    dmatrix r() const;
+
+    // Column permutation (zero-based), column j of a * p is column
+    // perm(j) of a.
+    ivector permutation() const;
+
+    // Numerical rank estimated from the diagonal of r. If tol is negative,
+    // max(m, n) * eps * |r(0, 0)| is used.
+    size_type rank(double tol = -1.0) const;
+
+    size_type rows() const { return qr.rows(); }
+    size_type cols() const { return qr.cols(); }
+
+private:
+    dmatrix qr;     // r and Householder vectors as returned by LAPACK
+    dvector tau;    // scalar factors of the elementary reflectors
+    ivector jpvt;   // column permutation (one-based)
+    bool pivoting;  // column pivoting used
+};
+
+}  // namespace srs
+#endif  // SRS_HAVE_LAPACK
+
+#endif  // SRS_MATH_FACTORIZATION_H
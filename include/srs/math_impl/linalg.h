@@ -17,16 +17,20 @@
 #ifndef SRS_MATH_LINALG_H
 #define SRS_MATH_LINALG_H
 
-#include <mkl.h>
+#include <srs/math_impl/backend.h>
 #include <srs/array.h>
 #include <srs/band.h>
+#include <srs/math_impl/blas.h>
 #include <srs/packed.h>
+#include <srs/rfp.h>
 #include <srs/sparse.h>
 #include <srs/types.h>
 #include <algorithm>
 #include <gsl/gsl>
 #include <limits>
 #include <numeric>
+#include <string>
+#include <vector>
 
 
 //
@@ -406,34 +410,34 @@ inline Array<T, 1> normalize(const Array<T, 1>& vec)
 
 // Vector dot and cross products:
 
-// Compute dot product.
+// Compute dot product. Dispatches to BLAS for float, double and complex
+// types; complex vectors are not conjugated.
 template <class T>
 inline T dot(const Array<T, 1>& a, const Array<T, 1>& b)
 {
-    // Intel MKL will be faster for large N.
     Expects(a.size() == b.size());
-    return std::inner_product(a.begin(), a.end(), b.begin(), T(0));
+    return blas::dot(a.size(), a.data(), a.inc(), b.data(), b.inc());
 }
 
 template <class T>
 inline T dot(const Array<T, 1>& a, const Array_ref<T, 1>& b)
 {
     Expects(a.size() == b.size());
-    return std::inner_product(a.begin(), a.end(), b.begin(), T(0));
+    return blas::dot(a.size(), a.data(), a.inc(), b.data(), b.inc());
 }
 
 template <class T>
 inline T dot(const Array_ref<T, 1>& a, const Array<T, 1>& b)
 {
     Expects(a.size() == b.size());
-    return std::inner_product(a.begin(), a.end(), b.begin(), T(0));
+    return blas::dot(a.size(), a.data(), a.inc(), b.data(), b.inc());
 }
 
 template <class T>
 inline T dot(const Array_ref<T, 1>& a, const Array_ref<T, 1>& b)
 {
     Expects(a.size() == b.size());
-    return std::inner_product(a.begin(), a.end(), b.begin(), T(0));
+    return blas::dot(a.size(), a.data(), a.inc(), b.data(), b.inc());
 }
 
 // Compute cross product.
@@ -484,19 +488,230 @@ inline Array<T, 1> cross(const Array_ref<T, 1>& a, const Array_ref<T, 1>& b)
 
 //------------------------------------------------------------------------------
 
-// Compute vector-scalar product and add the result to a vector.
-template <class T>
-void axpy(const T& a, const Array<T, 1>& x, Array<T, 1>& y)
+// Generic BLAS operations:
+//
+// The operands may be Array or Array_ref objects, where the stride of an
+// Array_ref is passed to BLAS as leading dimension or increment. Transpose
+// flags are 'N' or 'T'. Dispatches to BLAS for float, double,
+// std::complex<float> and std::complex<double>, and to the native kernels
+// in srs::blas otherwise.
+
+// Compute vector-scalar product and add the result to a vector,
+// y = a * x + y.
+template <class T, class VX>
+inline void axpy(const typename Array_ref<T, 1>::value_type& a,
+                 const VX& x,
+                 Array_ref<T, 1> y)
 {
     Expects(x.size() == y.size());
+    blas::axpy(x.size(), a, x.data(), x.inc(), y.data(), y.inc());
+}
+
+template <class T, class VX>
+inline void axpy(const typename Array<T, 1>::value_type& a,
+                 const VX& x,
+                 Array<T, 1>& y)
+{
+    axpy(a, x, Array_ref<T, 1>(y.size(), 1, y.data()));
+}
+
+// Compute matrix-vector product, y = alpha * op(a) * x + beta * y.
+template <class T, class MA, class VX>
+void gemv(char transa,
+          const typename Array_ref<T, 1>::value_type& alpha,
+          const MA& a,
+          const VX& x,
+          const typename Array_ref<T, 1>::value_type& beta,
+          Array_ref<T, 1> y)
+{
+    const bool ta = (transa == 'T') || (transa == 't');
+
+    Expects(x.size() == (ta ? a.rows() : a.cols()));
+    Expects(y.size() == (ta ? a.cols() : a.rows()));
+
+    MKL_INT lda = std::max<MKL_INT>(1, a.leading_dim());
 
-    using size_type = typename Array<T, 1>::size_type;
+    // clang-format off
+    blas::gemv(
+        ta ? 'T' : 'N', a.rows(), a.cols(), alpha, a.data(), lda, x.data(),
+        x.inc(), beta, y.data(), y.inc());
+    // clang-format on
+}
+
+// Array y is resized if empty.
+template <class T, class MA, class VX>
+inline void gemv(char transa,
+                 const typename Array<T, 1>::value_type& alpha,
+                 const MA& a,
+                 const VX& x,
+                 const typename Array<T, 1>::value_type& beta,
+                 Array<T, 1>& y)
+{
+    if (y.empty()) {
+        y.resize(((transa == 'T') || (transa == 't')) ? a.cols() : a.rows());
+    }
+    gemv(transa, alpha, a, x, beta, Array_ref<T, 1>(y.size(), 1, y.data()));
+}
+
+// Compute matrix-matrix product, c = alpha * op(a) * op(b) + beta * c.
+template <class T, class MA, class MB>
+void gemm(char transa,
+          char transb,
+          const typename Array_ref<T, 2>::value_type& alpha,
+          const MA& a,
+          const MB& b,
+          const typename Array_ref<T, 2>::value_type& beta,
+          Array_ref<T, 2> c)
+{
+    const bool ta = (transa == 'T') || (transa == 't');
+    const bool tb = (transb == 'T') || (transb == 't');
+
+    // Dimensions of op(a) (m x k) and op(b) (k x n).
+    MKL_INT m = ta ? a.cols() : a.rows();
+    MKL_INT k = ta ? a.rows() : a.cols();
+    MKL_INT n = tb ? b.rows() : b.cols();
+
+    Expects(k == (tb ? b.cols() : b.rows()));
+    Expects(c.rows() == m && c.cols() == n);
+
+    MKL_INT lda = std::max<MKL_INT>(1, a.leading_dim());
+    MKL_INT ldb = std::max<MKL_INT>(1, b.leading_dim());
+    MKL_INT ldc = std::max<MKL_INT>(1, c.leading_dim());
+
+    // clang-format off
+    blas::gemm(
+        ta ? 'T' : 'N', tb ? 'T' : 'N', m, n, k, alpha, a.data(), lda,
+        b.data(), ldb, beta, c.data(), ldc);
+    // clang-format on
+}
+
+// Array c is resized if empty.
+template <class T, class MA, class MB>
+inline void gemm(char transa,
+                 char transb,
+                 const typename Array<T, 2>::value_type& alpha,
+                 const MA& a,
+                 const MB& b,
+                 const typename Array<T, 2>::value_type& beta,
+                 Array<T, 2>& c)
+{
+    if (c.empty()) {
+        const bool ta = (transa == 'T') || (transa == 't');
+        const bool tb = (transb == 'T') || (transb == 't');
+        c.resize(ta ? a.cols() : a.rows(), tb ? b.rows() : b.cols());
+    }
+    Array_ref<T, 2> cref(c.rows(), c.cols(), c.leading_dim(), c.data());
+    gemm(transa, transb, alpha, a, b, beta, cref);
+}
 
-    for (size_type i = 0; i < x.size(); ++i) {
-        y(i) = a * x(i) + y(i);
+// Compute c.depth(l) = alpha * op(a.depth(l)) * op(b.depth(l)) +
+// beta * c.depth(l) for a batch of matrices of equal size. Cube c is resized
+// if empty.
+template <class T>
+void gemm_batched(char transa,
+                  char transb,
+                  const typename Array<T, 3>::value_type& alpha,
+                  const Array<T, 3>& a,
+                  const Array<T, 3>& b,
+                  const typename Array<T, 3>::value_type& beta,
+                  Array<T, 3>& c)
+{
+    const bool ta = (transa == 'T') || (transa == 't');
+    const bool tb = (transb == 'T') || (transb == 't');
+
+    MKL_INT m = ta ? a.cols() : a.rows();
+    MKL_INT k = ta ? a.rows() : a.cols();
+    MKL_INT n = tb ? b.rows() : b.cols();
+
+    Expects(k == (tb ? b.cols() : b.rows()));
+    Expects(b.depths() == a.depths());
+
+    if (c.empty()) {
+        c.resize(m, n, a.depths());
+    }
+    Expects(c.rows() == m && c.cols() == n && c.depths() == a.depths());
+
+    if (c.empty()) {
+        return;
     }
+
+    MKL_INT lda = std::max<MKL_INT>(1, a.rows());
+    MKL_INT ldb = std::max<MKL_INT>(1, b.rows());
+    MKL_INT ldc = std::max<MKL_INT>(1, c.rows());
+
+    // clang-format off
+    blas::gemm_batch_strided(
+        ta ? 'T' : 'N', tb ? 'T' : 'N', m, n, k, alpha, a.data(), lda,
+        a.rows() * a.cols(), b.data(), ldb, b.rows() * b.cols(), beta,
+        c.data(), ldc, c.rows() * c.cols(), a.depths());
+    // clang-format on
+}
+
+// Compute c[l] = alpha * op(a[l]) * op(b[l]) + beta * c[l] for a batch of
+// matrices, which may differ in size. The elements are Array or Array_ref
+// objects, and c[l] must have the dimensions of the product.
+template <class MA, class MB, class MC>
+void gemm_batched(char transa,
+                  char transb,
+                  const typename MC::value_type& alpha,
+                  const std::vector<MA>& a,
+                  const std::vector<MB>& b,
+                  const typename MC::value_type& beta,
+                  std::vector<MC>& c)
+{
+    using T = typename MC::value_type;
+
+    const bool ta = (transa == 'T') || (transa == 't');
+    const bool tb = (transb == 'T') || (transb == 't');
+
+    Expects(b.size() == a.size() && c.size() == a.size());
+
+    const MKL_INT nbatch = gsl::narrow_cast<MKL_INT>(a.size());
+
+    std::vector<MKL_INT> m(nbatch);
+    std::vector<MKL_INT> n(nbatch);
+    std::vector<MKL_INT> k(nbatch);
+    std::vector<MKL_INT> lda(nbatch);
+    std::vector<MKL_INT> ldb(nbatch);
+    std::vector<MKL_INT> ldc(nbatch);
+    std::vector<const T*> pa(nbatch);
+    std::vector<const T*> pb(nbatch);
+    std::vector<T*> pc(nbatch);
+
+    for (MKL_INT l = 0; l < nbatch; ++l) {
+        m[l] = ta ? a[l].cols() : a[l].rows();
+        k[l] = ta ? a[l].rows() : a[l].cols();
+        n[l] = tb ? b[l].rows() : b[l].cols();
+
+        Expects(k[l] == (tb ? b[l].cols() : b[l].rows()));
+        Expects(c[l].rows() == m[l] && c[l].cols() == n[l]);
+
+        lda[l] = std::max<MKL_INT>(1, a[l].leading_dim());
+        ldb[l] = std::max<MKL_INT>(1, b[l].leading_dim());
+        ldc[l] = std::max<MKL_INT>(1, c[l].leading_dim());
+        pa[l]  = a[l].data();
+        pb[l]  = b[l].data();
+        pc[l]  = c[l].data();
+    }
+
+    // clang-format off
+    blas::gemm_batch(
+        ta ? 'T' : 'N', tb ? 'T' : 'N', m.data(), n.data(), k.data(), alpha,
+        pa.data(), lda.data(), pb.data(), ldb.data(), beta, pc.data(),
+        ldc.data(), nbatch);
+    // clang-format on
 }
 
+#ifdef SRS_HAVE_LAPACK
+// Compute the symmetric rank-k update c = alpha * a * a^T + beta * c
+// (trans = 'N', a is n x k) or c = alpha * a^T * a + beta * c (trans = 'T',
+// a is k x n), where c is held in RFP storage. The product is formed by
+// level 3 BLAS operations on the blocks of c. If c is empty, it is resized
+// and zero-initialized.
+void sfrk(
+    char trans, double alpha, const dmatrix& a, double beta, rfp_dmatrix& c);
+#endif  // SRS_HAVE_LAPACK
+
 //------------------------------------------------------------------------------
 
 // Determinant of a matrix.
@@ -512,6 +727,32 @@ void inv(dmatrix& a);
 // Compute LU factorization.
 void lu(dmatrix& a, ivector& ipiv);
 
+#ifdef SRS_HAVE_LAPACK
+// Compute the thin singular value decomposition a = u * diag(s) * vt using
+// the divide and conquer method. With k = min(m, n), u is m x k, vt is k x n
+// and s holds the singular values in descending order. On exit, a is
+// destroyed.
+void svd(dmatrix& a, dmatrix& u, dvector& s, dmatrix& vt);
+
+// Compute singular values of a general matrix. On exit, a is destroyed.
+void svdvals(dmatrix& a, dvector& s);
+
+// Compute the k largest singular triplets of a using the randomized range
+// finder of Halko, Martinsson and Tropp, with p oversampling columns and q
+// power iterations. Requires O(mnk) operations.
+void svd_rand(const dmatrix& a,
+              dmatrix& u,
+              dvector& s,
+              dmatrix& vt,
+              int k,
+              int p = 10,
+              int q = 2);
+
+// Moore-Penrose pseudo-inverse. Singular values below tol are treated as
+// zero; if tol is negative, max(m, n) * eps * s(0) is used.
+dmatrix pinv(const dmatrix& a, double tol = -1.0);
+#endif  // SRS_HAVE_LAPACK
+
 //------------------------------------------------------------------------------
 
 // Eigensolvers:
@@ -519,6 +760,30 @@ void lu(dmatrix& a, ivector& ipiv);
 // Compute eigenvalues and eigenvectors of a real symmetric matrix.
 void eigs(dmatrix& a, dvector& wr);
 
+#ifdef SRS_HAVE_LAPACK
+// Compute the eigenvalues with indices il through iu (zero-based, eigenvalues
+// in ascending order) and the corresponding eigenvectors of a real symmetric
+// matrix. The eigenvectors are stored in the n x (iu - il + 1) matrix v, which
+// is only reallocated if it does not have the right size. On exit, a is
+// destroyed.
+void eigs(dmatrix& a, dmatrix& v, dvector& w, int il, int iu);
+
+// Compute the eigenvalues in the half-open interval (vl, vu] and the
+// corresponding eigenvectors of a real symmetric matrix. On exit, v holds the
+// m eigenvectors found and a is destroyed.
+void eigs(double vl, double vu, dmatrix& a, dmatrix& v, dvector& w);
+
+// Compute eigenvalues of a real symmetric matrix (no eigenvectors).
+void eigvals(dmatrix& a, dvector& w);
+
+// Compute the eigenvalues with indices il through iu (zero-based) of a real
+// symmetric matrix.
+void eigvals(dmatrix& a, dvector& w, int il, int iu);
+
+// Compute the eigenvalues in the half-open interval (vl, vu] of a real
+// symmetric matrix.
+void eigvals(double vl, double vu, dmatrix& a, dvector& w);
+
 // Compute eigenvalues and eigenvectors of a real symmetric band matrix.
 void eigs(band_dmatrix& ab, dmatrix& v, dvector& w);
 
@@ -526,9 +791,17 @@ void eigs(band_dmatrix& ab, dmatrix& v, dvector& w);
 // packed storage format.
 void eigs(packed_dmatrix& ap, dmatrix& v, dvector& w);
 
+// Compute eigenvalues and eigenvectors of a real symmetric matrix held in
+// RFP storage format. LAPACK has no RFP eigensolver, so the matrix is
+// unpacked with dtfttr and solved by dsyevr.
+void eigs(const rfp_dmatrix& a, dmatrix& v, dvector& w);
+
 // Compute eigenvalues and eigenvectors of a real non-symmetric matrix.
 void eig(dmatrix& a, zmatrix& v, zvector& w);
 
+#endif  // SRS_HAVE_LAPACK
+
+#ifdef SRS_USE_MKL
 // Compute eigenvalues and eigenvectors in the interval [emin, emax] for
 // a real band matrix.
 void eig(
@@ -539,6 +812,15 @@ void eig(
 void eig(
     double emin, double emax, const sparse_dmatrix& a, dmatrix& v, dvector& w);
 
+// Compute eigenvalues and eigenvectors in the interval [emin, emax] for
+// a real symmetric sparse matrix, passing only the upper triangle to FEAST.
+void eig(double emin,
+         double emax,
+         const sym_sparse_dmatrix& a,
+         dmatrix& v,
+         dvector& w);
+#endif  // SRS_USE_MKL
+
 // Compute eigenvalues and eigenvectors of a real symmetric matrix.
 void jacobi(dmatrix& a, dvector& wr);
 
@@ -547,17 +829,99 @@ void jacobi(dmatrix& a, dvector& wr);
 // Solve linear system of equations.
 void linsolve(dmatrix& a, dmatrix& b);
 
+#ifdef SRS_HAVE_LAPACK
+// Solve linear system of equations for a square band matrix using LU
+// factorization with partial pivoting, which requires O(n * kl * (kl + ku))
+// operations. Tridiagonal systems are solved with dgtsv. On exit, b holds
+// the solution.
+void linsolve(const band_dmatrix& a, dmatrix& b);
+void linsolve(const band_dmatrix& a, dvector& b);
+#endif
+
+// Solve tridiagonal system of equations (kl = ku = 1) in O(n) operations
+// with the Thomas algorithm, or in O(n log n) operations distributed over
+// the OpenMP threads with parallel cyclic reduction. No pivoting is done, so
+// a should be diagonally dominant or symmetric positive definite. On exit,
+// b holds the solution.
+void linsolve_tridiag(const band_dmatrix& a,
+                      dmatrix& b,
+                      Tridiag_t method = Thomas);
+void linsolve_tridiag(const band_dmatrix& a,
+                      dvector& b,
+                      Tridiag_t method = Thomas);
+
+#ifdef SRS_HAVE_LAPACK
+// Solve linear system of equations using a single precision LU factorization
+// and iterative refinement of the solution in double precision, as in
+// dsgesv. Refinement stops when each column satisfies ||r||_inf <= tol *
+// ||a||_inf * ||x||_inf, where tol = sqrt(n) * eps if negative. If the
+// single precision factorization fails, or the refinement stalls or does not
+// converge within max_iter iterations, a double precision factorization is
+// used instead. On exit, b holds the solution; a is not modified.
+//
+// Returns the number of refinement iterations k, or -(k + 1) if the double
+// precision factorization was used.
+int linsolve_mixed(const dmatrix& a,
+                   dmatrix& b,
+                   double tol   = -1.0,
+                   int max_iter = 30);
+#endif
+
+#ifdef SRS_USE_MKL
 // Solve linear system of equations for a real, nonsymmetric sparse matrix.
 void linsolve(const sparse_dmatrix& a, dvector& b, dvector& x);
 
+// Solve linear system of equations for a real symmetric indefinite sparse
+// matrix. PARDISO uses the upper triangle and Bunch-Kaufman pivoting.
+void linsolve(const sym_sparse_dmatrix& a, dvector& b, dvector& x);
+#endif
+
 //------------------------------------------------------------------------------
 
+#ifdef SRS_HAVE_LAPACK
+// Batched solvers for many small, independent problems:
+//
+// The n x n matrices are stored as the depths of a cube, i.e. a.depth(k) is
+// the k-th matrix of the batch. The batch is processed in parallel when
+// OpenMP is enabled, and LAPACK workspace is allocated once per thread.
+
+// Compute eigenvalues and eigenvectors of a batch of real symmetric
+// matrices. On exit, a.depth(k) holds the eigenvectors of the k-th matrix and
+// w.column(k) the eigenvalues in ascending order. 3 x 3 matrices are
+// diagonalized with an allocation-free Jacobi kernel.
+void eigs_batched(dcube& a, dmatrix& w);
+
+// Compute LU factorization of a batch of matrices. The pivot indices of the
+// k-th matrix are stored in ipiv.column(k).
+void lu_batched(dcube& a, imatrix& ipiv);
+
+// Solve a batch of linear systems of equations a.depth(k) * x = b.depth(k).
+// On exit, b holds the solutions and a the LU factors.
+void linsolve_batched(dcube& a, dcube& b);
+
+// Solve a batch of linear systems of equations with one right-hand side
+// each, a.depth(k) * x = b.column(k).
+void linsolve_batched(dcube& a, dmatrix& b);
+#endif  // SRS_HAVE_LAPACK
+
+//------------------------------------------------------------------------------
+
+// Orthonormalize the first n columns (orbitals) of a and fill up with unit
+// vectors until the first a.rows() columns of a form a complete orthonormal
+// basis. The Gram-Schmidt methods drop linearly dependent orbitals, while
+// Householder QR replaces them by vectors from the orthogonal complement.
+// Without LAPACK, Householder falls back on modified Gram-Schmidt.
+void orthonormalize(srs::dmatrix& a,
+                    srs::size_t n,
+                    srs::Ortho_t method = Householder);
+
 // Schmidt orthogonalization of n orbitals in a.
 void schmidt(srs::dmatrix& a, srs::size_t n);
 
 //------------------------------------------------------------------------------
 
-// Wrappers to Intel MKL for fast numerical performance for large arrays:
+// Wrappers to BLAS for fast numerical performance for large arrays. The
+// backend is selected at configure time (see backend.h):
 
 // Compute vector-scalar product and add the result to a vector.
 inline void mkl_daxpy(double a, const dvector& x, dvector& y)
@@ -566,7 +930,7 @@ inline void mkl_daxpy(double a, const dvector& x, dvector& y)
     MKL_INT n    = x.size();
     MKL_INT incx = 1;
     MKL_INT incy = 1;
-    cblas_daxpy(n, a, x.data(), incx, y.data(), incy);
+    srs::blas::axpy(n, a, x.data(), incx, y.data(), incy);
 }
 
 // Compute dot product.
@@ -576,7 +940,7 @@ inline double mkl_ddot(const dvector& x, const dvector& y)
     MKL_INT n    = x.size();
     MKL_INT incx = 1;
     MKL_INT incy = 1;
-    return cblas_ddot(n, x.data(), incx, y.data(), incy);
+    return srs::blas::dot(n, x.data(), incx, y.data(), incy);
 }
 
 // Matrix-matrix multiplication.
@@ -599,13 +963,14 @@ void mkl_dgemv(const std::string& transa,
 // Matrix transpose.
 inline void mkl_transpose(const dmatrix& a, dmatrix& b)
 {
-    MKL_INT nrows = a.cols();
-    MKL_INT ncols = a.rows();
-    MKL_INT lda   = a.rows();
-    MKL_INT ldb   = ncols;
+    MKL_INT nrows = a.rows();
+    MKL_INT ncols = a.cols();
+    MKL_INT lda   = nrows > 1 ? nrows : 1;
+    MKL_INT ldb   = ncols > 1 ? ncols : 1;
 
-    b.resize(nrows, ncols);
-    mkl_domatcopy('C', 'T', nrows, ncols, 1.0, a.data(), lda, b.data(), ldb);
+    b.resize(ncols, nrows);
+    srs::blas::omatcopy(
+        'T', nrows, ncols, 1.0, a.data(), lda, b.data(), ldb);
 }
 
 }  // namespace srs
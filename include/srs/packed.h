@@ -26,7 +26,7 @@
 
 namespace srs {
 
-typedef Packed_matrix<int> packed_imatrix;
+typedef Packed_matrix<Int_t> packed_imatrix;
 typedef Packed_matrix<double> packed_dmatrix;
 
 }  // namespace srs
@@ -46,10 +46,13 @@ public:
 
     Packed_matrix() : elems(), extent{0} {}
 
-    explicit Packed_matrix(size_type n) : elems(n * (n + 1) / 2), extent{n} {}
+    explicit Packed_matrix(size_type n)
+        : elems(checked_mul(n, n + 1) / 2), extent{n}
+    {
+    }
 
     Packed_matrix(size_type n, const T& value)
-        : elems(n * (n + 1) / 2, value), extent{n}
+        : elems(checked_mul(n, n + 1) / 2, value), extent{n}
     {
     }
 
@@ -152,7 +155,7 @@ Packed_matrix<T>::Packed_matrix(const Array<T, 1>& a) : elems(a.size())
 
 template <class T>
 Packed_matrix<T>::Packed_matrix(const Array<T, 2>& a)
-    : elems(a.rows() * (a.rows() + 1) / 2), extent{a.rows()}
+    : elems(checked_mul(a.rows(), a.rows() + 1) / 2), extent{a.rows()}
 {
     Expects(a.rows() == a.cols());
     for (size_type j = 0; j < a.cols(); ++j) {
@@ -215,7 +218,7 @@ inline void Packed_matrix<T>::swap(Packed_matrix& ap)
 template <class T>
 void Packed_matrix<T>::resize(size_type n)
 {
-    elems.resize(n * (n + 1) / 2);
+    elems.resize(checked_mul(n, n + 1) / 2);
     extent = n;
 }
 
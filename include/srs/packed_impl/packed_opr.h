@@ -17,7 +17,10 @@
 #ifndef SRS_PACKED_OPR_H
 #define SRS_PACKED_OPR_H
 
+#include <srs/array.h>
+#include <srs/math_impl/blas.h>
 #include <algorithm>
+#include <gsl/gsl>
 
 
 namespace srs {
@@ -140,6 +143,34 @@ inline Packed_matrix<T> operator*(const T& scalar, const Packed_matrix<T>& a)
 
 //------------------------------------------------------------------------------
 
+// Matrix-vector multiplication:
+//
+// The product requires O(n^2) operations and is dispatched to the spmv
+// routine of the BLAS backend, which reads the packed upper triangle once.
+
+// Compute w = a * v.
+template <class T>
+void pmv_mul(const Packed_matrix<T>& a, const Array<T, 1>& v, Array<T, 1>& w)
+{
+    Expects(v.size() == a.cols());
+    w.resize(a.rows());
+
+    // clang-format off
+    blas::spmv(
+        'U', a.rows(), T(1), a.data(), v.data(), 1, T(0), w.data(), 1);
+    // clang-format on
+}
+
+template <class T>
+inline Array<T, 1> operator*(const Packed_matrix<T>& a, const Array<T, 1>& v)
+{
+    Array<T, 1> result;
+    pmv_mul(a, v, result);
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
 // Matrix-matrix multiplication:
 
 template <class T>
@@ -150,28 +181,54 @@ inline Array<T, 2> operator*(const Packed_matrix<T>& a, const Array<T, 2>& b)
     return result;
 }
 
+// Compute c = a * b, where b is a dense matrix.
+//
+// Algorithm:
+// The packed upper triangle is traversed column by column. Column j holds
+// a(0:j, j), which contributes a(0:j-1, j) * b(j, k) to c(0:j-1, k) and,
+// by symmetry, a(0:j, j)^T * b(0:j, k) to c(j, k). Each packed column is
+// applied to a block of columns of b while it is in cache, so that the
+// packed matrix is streamed once per block instead of once per column.
+// The blocks are processed in parallel.
 template <class T>
 void pmm_mul(const Packed_matrix<T>& a, const Array<T, 2>& b, Array<T, 2>& c)
 {
-    // Function to form the matrix product
-    //     c = a * b
-    // where a is an n x n matrix stored in lower triangular compressed form,
-    // b is a full n x n matrix stored compressed column-wise. The output
-    // matrix c is a full n x n matrix stored compressed column-wise.
-
-    using value_type = typename Array<T, 2>::value_type;
-    using size_type  = typename Array<T, 2>::size_type;
+    using size_type = typename Array<T, 2>::size_type;
 
+    Expects(b.rows() == a.cols());
     c.resize(a.rows(), b.cols());
 
-	for (size_type j = 0; j < b.cols(); ++j) {
-		for (size_type i = 0; i < a.rows(); ++i) {
-			c(i, j) = value_type(0);
-			for (size_type k = 0; k < a.cols(); ++k) {
-				c(i, j) += a(i, k) * b(k, j);
-			}
-		}
-	}
+    const size_type n   = a.rows();
+    const size_type m   = b.cols();
+    const size_type ldb = b.leading_dim();
+    const size_type ldc = c.leading_dim();
+    const size_type nb  = 16;  // columns of b per block
+
+    const T* ap = a.data();
+    const T* bp = b.data();
+    T* cp       = c.data();
+
+#pragma omp parallel for schedule(static)
+    for (size_type kb = 0; kb < m; kb += nb) {
+        const size_type kend = std::min(kb + nb, m);
+        for (size_type k = kb; k < kend; ++k) {
+            std::fill_n(cp + k * ldc, n, T(0));
+        }
+        for (size_type j = 0; j < n; ++j) {
+            const T* aj = ap + j * (j + 1) / 2;
+            for (size_type k = kb; k < kend; ++k) {
+                const T* bk = bp + k * ldb;
+                T* ck       = cp + k * ldc;
+                T bjk       = bk[j];
+                T sum       = T(0);
+                for (size_type i = 0; i < j; ++i) {
+                    ck[i] += aj[i] * bjk;
+                    sum += aj[i] * bk[i];
+                }
+                ck[j] += aj[j] * bjk + sum;
+            }
+        }
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,47 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SRS_RFP_IO_H
+#define SRS_RFP_IO_H
+
+#include <srs/rfp_impl/rfp_matrix.h>
+#include <iomanip>
+#include <iostream>
+
+
+namespace srs {
+
+template <class T>
+std::ostream& operator<<(std::ostream& to, const Rfp_matrix<T>& a)
+{
+    using size_type = typename Rfp_matrix<T>::size_type;
+
+    to << a.rows() << " x " << a.cols() << "\n[";
+    for (size_type i = 0; i < a.rows(); ++i) {
+        for (size_type j = 0; j < a.cols(); ++j) {
+            to << std::setw(9) << a(i, j) << " ";
+        }
+        if (i != a.rows() - 1) {
+            to << "\n ";
+        }
+    }
+    to << "]\n";
+    return to;
+}
+
+}  // namespace srs
+
+#endif  // SRS_RFP_IO_H
@@ -0,0 +1,344 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SRS_RFP_MATRIX_H
+#define SRS_RFP_MATRIX_H
+
+#include <srs/array.h>
+#include <srs/array_impl/functors.h>
+#include <srs/packed.h>
+#include <srs/types.h>
+#include <gsl/gsl>
+#include <vector>
+
+
+namespace srs {
+
+//
+// Range-checked symmetric matrix in Rectangular Full Packed (RFP) storage
+// (zero-based indexing).
+//
+// The upper triangle of an n x n matrix is split into the leading n1 x n1
+// block a11, the trailing n2 x n2 block a22 and the n1 x n2 block a12,
+// where n1 = n / 2 and n2 = n - n1. The blocks are held in an ld x n2
+// column-major array, with ld = n + 1 if n is even and ld = n otherwise:
+//
+//     a12:  rows 0 to n1 - 1
+//     a22:  upper triangle of rows n1 to n - 1
+//     a11:  transposed into the lower triangle of rows n1 + 1 to ld - 1
+//
+// This is the LAPACK format with transr = 'N' and uplo = 'U', which uses
+// the same n * (n + 1) / 2 elements as Packed_matrix, but lets the blocks
+// be processed by level 3 BLAS.
+//
+template <class T>
+class Rfp_matrix {
+public:
+    typedef T value_type;
+    typedef Int_t size_type;
+    typedef typename std::vector<T>::iterator iterator;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+    // Constructors:
+
+    Rfp_matrix() : elems(), extent{0} {}
+
+    explicit Rfp_matrix(size_type n)
+        : elems(checked_mul(n, n + 1) / 2), extent{n}
+    {
+    }
+
+    Rfp_matrix(size_type n, const T& value)
+        : elems(checked_mul(n, n + 1) / 2, value), extent{n}
+    {
+    }
+
+    Rfp_matrix(const Packed_matrix<T>& ap);
+    Rfp_matrix(const Array<T, 2>& a);
+
+    // Iterators:
+
+    iterator begin() { return elems.begin(); }
+    const_iterator begin() const { return elems.begin(); }
+
+    iterator end() { return elems.end(); }
+    const_iterator end() const { return elems.end(); }
+
+    // Element access:
+
+    T& at(size_type i, size_type j);
+    const T& at(size_type i, size_type j) const;
+
+    T& operator()(size_type i, size_type j);
+    const T& operator()(size_type i, size_type j) const;
+
+    // Capacity:
+
+    bool empty() const { return elems.empty(); }
+    size_type rows() const { return extent; }
+    size_type cols() const { return extent; }
+    size_type dim1() const { return extent; }
+    size_type dim2() const { return extent; }
+    size_type size() const { return elems.size(); }
+
+    // Leading dimension of the RFP array.
+    size_type leading_dim() const
+    {
+        return (extent % 2 == 0) ? extent + 1 : extent;
+    }
+
+    // Modifiers:
+
+    void clear();
+    void swap(Rfp_matrix& a);
+    void resize(size_type n);
+
+    // Access underlying arrays:
+
+    T* data() { return elems.data(); }
+    const T* data() const { return elems.data(); }
+
+    // Element-wise operations:
+
+    template <class F>
+    Rfp_matrix& apply(F f);
+
+    template <class F>
+    Rfp_matrix& apply(F f, const T& value);
+
+    Rfp_matrix& operator=(const T& value);
+
+    Rfp_matrix& operator*=(const T& value);
+    Rfp_matrix& operator/=(const T& value);
+    Rfp_matrix& operator+=(const T& value);
+    Rfp_matrix& operator-=(const T& value);
+
+    Rfp_matrix& operator-();
+
+    Rfp_matrix& operator+=(const Rfp_matrix& a);
+    Rfp_matrix& operator-=(const Rfp_matrix& a);
+
+private:
+    std::vector<T> elems;
+    size_type extent;
+
+    T& ref(size_type i, size_type j);
+    const T& ref(size_type i, size_type j) const;
+
+    size_type index(size_type i, size_type j) const;
+};
+
+template <class T>
+Rfp_matrix<T>::Rfp_matrix(const Packed_matrix<T>& ap)
+    : elems(ap.size()), extent{ap.rows()}
+{
+    for (size_type j = 0; j < extent; ++j) {
+        for (size_type i = 0; i <= j; ++i) {
+            elems[index(i, j)] = ap(i, j);
+        }
+    }
+}
+
+template <class T>
+Rfp_matrix<T>::Rfp_matrix(const Array<T, 2>& a)
+    : elems(checked_mul(a.rows(), a.rows() + 1) / 2), extent{a.rows()}
+{
+    Expects(a.rows() == a.cols());
+    for (size_type j = 0; j < extent; ++j) {
+        for (size_type i = 0; i <= j; ++i) {
+            elems[index(i, j)] = a(i, j);
+        }
+    }
+}
+
+template <class T>
+inline T& Rfp_matrix<T>::at(size_type i, size_type j)
+{
+    Expects(i >= 0 && i < extent);
+    Expects(j >= 0 && j < extent);
+    return ref(i, j);
+}
+
+template <class T>
+inline const T& Rfp_matrix<T>::at(size_type i, size_type j) const
+{
+    Expects(i >= 0 && i < extent);
+    Expects(j >= 0 && j < extent);
+    return ref(i, j);
+}
+
+template <class T>
+inline T& Rfp_matrix<T>::operator()(size_type i, size_type j)
+{
+#ifndef NDEBUG
+    return at(i, j);
+#else
+    return ref(i, j);
+#endif
+}
+
+template <class T>
+inline const T& Rfp_matrix<T>::operator()(size_type i, size_type j) const
+{
+#ifndef NDEBUG
+    return at(i, j);
+#else
+    return ref(i, j);
+#endif
+}
+
+template <class T>
+inline void Rfp_matrix<T>::clear()
+{
+    elems.clear();
+    extent = 0;
+}
+
+template <class T>
+inline void Rfp_matrix<T>::swap(Rfp_matrix& a)
+{
+    elems.swap(a.elems);
+    std::swap(extent, a.extent);
+}
+
+template <class T>
+void Rfp_matrix<T>::resize(size_type n)
+{
+    elems.resize(checked_mul(n, n + 1) / 2);
+    extent = n;
+}
+
+template <class T>
+template <class F>
+Rfp_matrix<T>& Rfp_matrix<T>::apply(F f)
+{
+    for (auto& v : elems) {
+        f(v);
+    }
+    return *this;
+}
+
+template <class T>
+template <class F>
+Rfp_matrix<T>& Rfp_matrix<T>::apply(F f, const T& value)
+{
+    for (auto& v : elems) {
+        f(v, value);
+    }
+    return *this;
+}
+
+template <class T>
+inline Rfp_matrix<T>& Rfp_matrix<T>::operator=(const T& value)
+{
+    apply(Assign<T>(), value);
+    return *this;
+}
+
+template <class T>
+inline Rfp_matrix<T>& Rfp_matrix<T>::operator*=(const T& value)
+{
+    apply(Mul_assign<T>(), value);
+    return *this;
+}
+
+template <class T>
+inline Rfp_matrix<T>& Rfp_matrix<T>::operator/=(const T& value)
+{
+    apply(Div_assign<T>(), value);
+    return *this;
+}
+
+template <class T>
+inline Rfp_matrix<T>& Rfp_matrix<T>::operator+=(const T& value)
+{
+    apply(Add_assign<T>(), value);
+    return *this;
+}
+
+template <class T>
+inline Rfp_matrix<T>& Rfp_matrix<T>::operator-=(const T& value)
+{
+    apply(Minus_assign<T>(), value);
+    return *this;
+}
+
+template <class T>
+inline Rfp_matrix<T>& Rfp_matrix<T>::operator-()
+{
+    apply(Unary_minus<T>());
+    return *this;
+}
+
+template <class T>
+Rfp_matrix<T>& Rfp_matrix<T>::operator+=(const Rfp_matrix<T>& a)
+{
+    Expects(extent == a.extent);
+    for (size_type i = 0; i < size(); ++i) {
+        elems[i] += a.data()[i];
+    }
+    return *this;
+}
+
+template <class T>
+Rfp_matrix<T>& Rfp_matrix<T>::operator-=(const Rfp_matrix<T>& a)
+{
+    Expects(extent == a.extent);
+    for (size_type i = 0; i < size(); ++i) {
+        elems[i] -= a.data()[i];
+    }
+    return *this;
+}
+
+template <class T>
+inline T& Rfp_matrix<T>::ref(size_type i, size_type j)
+{
+    if (j < i) {
+        return elems[index(j, i)];
+    }
+    else {
+        return elems[index(i, j)];
+    }
+}
+
+template <class T>
+inline const T& Rfp_matrix<T>::ref(size_type i, size_type j) const
+{
+    if (j < i) {
+        return elems[index(j, i)];
+    }
+    else {
+        return elems[index(i, j)];
+    }
+}
+
+template <class T>
+inline Int_t Rfp_matrix<T>::index(size_type i, size_type j) const
+{
+    // Element (i, j) of the upper triangle, i <= j.
+    const size_type n1 = extent / 2;
+    const size_type ld = leading_dim();
+    if (j >= n1) {  // a12 or a22
+        return i + (j - n1) * ld;
+    }
+    else {  // a11
+        return n1 + 1 + j + i * ld;
+    }
+}
+
+}  // namespace srs
+
+#endif  // SRS_RFP_MATRIX_H
@@ -0,0 +1,225 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SRS_RFP_OPR_H
+#define SRS_RFP_OPR_H
+
+#include <srs/array.h>
+#include <srs/math_impl/blas.h>
+#include <srs/packed.h>
+#include <srs/rfp_impl/rfp_matrix.h>
+#include <algorithm>
+#include <gsl/gsl>
+
+
+namespace srs {
+
+// Comparison operators:
+
+template <class T>
+inline bool operator==(const Rfp_matrix<T>& a, const Rfp_matrix<T>& b)
+{
+    return a.rows() == b.rows() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template <class T>
+inline bool operator!=(const Rfp_matrix<T>& a, const Rfp_matrix<T>& b)
+{
+    return !(a == b);
+}
+
+//------------------------------------------------------------------------------
+
+// Matrix addition:
+
+template <class T>
+inline Rfp_matrix<T> operator+(const Rfp_matrix<T>& a, const Rfp_matrix<T>& b)
+{
+    Rfp_matrix<T> result(a);
+    return result += b;
+}
+
+//------------------------------------------------------------------------------
+
+// Matrix subtraction:
+
+template <class T>
+inline Rfp_matrix<T> operator-(const Rfp_matrix<T>& a, const Rfp_matrix<T>& b)
+{
+    Rfp_matrix<T> result(a);
+    return result -= b;
+}
+
+//------------------------------------------------------------------------------
+
+// Scalar multiplication:
+
+template <class T>
+inline Rfp_matrix<T> operator*(const Rfp_matrix<T>& a, const T& scalar)
+{
+    Rfp_matrix<T> result(a);
+    return result *= scalar;
+}
+
+template <class T>
+inline Rfp_matrix<T> operator*(const T& scalar, const Rfp_matrix<T>& a)
+{
+    Rfp_matrix<T> result(a);
+    return result *= scalar;
+}
+
+//------------------------------------------------------------------------------
+
+// Conversions:
+
+// Copy to packed storage.
+template <class T>
+Packed_matrix<T> to_packed(const Rfp_matrix<T>& a)
+{
+    using size_type = typename Rfp_matrix<T>::size_type;
+
+    Packed_matrix<T> result(a.rows());
+    for (size_type j = 0; j < a.cols(); ++j) {
+        for (size_type i = 0; i <= j; ++i) {
+            result(i, j) = a(i, j);
+        }
+    }
+    return result;
+}
+
+// Copy to full storage, with both triangles set.
+template <class T>
+Array<T, 2> to_dense(const Rfp_matrix<T>& a)
+{
+    using size_type = typename Rfp_matrix<T>::size_type;
+
+    Array<T, 2> result(a.rows(), a.cols());
+    for (size_type j = 0; j < a.cols(); ++j) {
+        for (size_type i = 0; i <= j; ++i) {
+            result(i, j) = a(i, j);
+            result(j, i) = a(i, j);
+        }
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+// Matrix-vector and matrix-matrix multiplication:
+//
+// With a split into the blocks a11, a12 and a22 (see rfp_matrix.h), the
+// products are formed as
+//
+//     c1 = a11 * b1 + a12 * b2
+//     c2 = a12^T * b1 + a22 * b2
+//
+// where b1 and c1 are the leading n1 rows of b and c. The symmetric blocks
+// are handled by symv and symm, and a12 by gemv and gemm, directly on the
+// RFP array.
+
+// Compute w = a * v.
+template <class T>
+void mv_mul(const Rfp_matrix<T>& a, const Array<T, 1>& v, Array<T, 1>& w)
+{
+    using size_type = typename Rfp_matrix<T>::size_type;
+
+    Expects(v.size() == a.cols());
+    w.resize(a.rows());
+    if (a.empty()) {
+        return;
+    }
+    const size_type n1 = a.rows() / 2;
+    const size_type n2 = a.rows() - n1;
+    const size_type ld = a.leading_dim();
+
+    const T* ap = a.data();
+    const T* v1 = v.data();
+    const T* v2 = v.data() + n1;
+    T* w1       = w.data();
+    T* w2       = w.data() + n1;
+
+    blas::symv('L', n1, T(1), ap + n1 + 1, ld, v1, 1, T(0), w1, 1);
+    blas::gemv('N', n1, n2, T(1), ap, ld, v2, 1, T(1), w1, 1);
+    blas::symv('U', n2, T(1), ap + n1, ld, v2, 1, T(0), w2, 1);
+    blas::gemv('T', n1, n2, T(1), ap, ld, v1, 1, T(1), w2, 1);
+}
+
+template <class T>
+inline Array<T, 1> operator*(const Rfp_matrix<T>& a, const Array<T, 1>& v)
+{
+    Array<T, 1> result;
+    mv_mul(a, v, result);
+    return result;
+}
+
+// Compute c = a * b, where b is a dense matrix.
+template <class T>
+void mm_mul(const Rfp_matrix<T>& a, const Array<T, 2>& b, Array<T, 2>& c)
+{
+    using size_type = typename Rfp_matrix<T>::size_type;
+
+    Expects(b.rows() == a.cols());
+    c.resize(a.rows(), b.cols());
+    if (c.empty()) {
+        return;
+    }
+    const size_type n1  = a.rows() / 2;
+    const size_type n2  = a.rows() - n1;
+    const size_type m   = b.cols();
+    const size_type ld  = a.leading_dim();
+    const size_type ldb = b.leading_dim();
+    const size_type ldc = c.leading_dim();
+
+    const T* ap = a.data();
+    const T* b1 = b.data();
+    const T* b2 = b.data() + n1;
+    T* c1       = c.data();
+    T* c2       = c.data() + n1;
+
+    // clang-format off
+    blas::symm(
+        'L', 'L', n1, m, T(1), ap + n1 + 1, ld, b1, ldb, T(0), c1, ldc);
+    blas::gemm(
+        'N', 'N', n1, m, n2, T(1), ap, ld, b2, ldb, T(1), c1, ldc);
+    blas::symm(
+        'L', 'U', n2, m, T(1), ap + n1, ld, b2, ldb, T(0), c2, ldc);
+    blas::gemm(
+        'T', 'N', n2, m, n1, T(1), ap, ld, b1, ldb, T(1), c2, ldc);
+    // clang-format on
+}
+
+template <class T>
+inline Array<T, 2> operator*(const Rfp_matrix<T>& a, const Array<T, 2>& b)
+{
+    Array<T, 2> result;
+    mm_mul(a, b, result);
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+// Algorithms:
+
+// Swap matrices.
+template <class T>
+inline void swap(Rfp_matrix<T>& a, Rfp_matrix<T>& b)
+{
+    a.swap(b);
+}
+
+}  // namespace srs
+
+#endif  // SRS_RFP_OPR_H
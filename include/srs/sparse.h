@@ -20,19 +20,27 @@
 //
 // Provides sparse vector and matrix class.
 //
+#include <srs/sparse_impl/block_sparse_matrix.h>
+#include <srs/sparse_impl/sell_matrix.h>
+#include <srs/sparse_impl/sparse_builder.h>
 #include <srs/sparse_impl/sparse_io.h>
 #include <srs/sparse_impl/sparse_matrix.h>
+#include <srs/sparse_impl/sparse_mv.h>
 #include <srs/sparse_impl/sparse_opr.h>
+#include <srs/sparse_impl/sparse_reorder.h>
 #include <srs/sparse_impl/sparse_vector.h>
+#include <srs/sparse_impl/sym_sparse_matrix.h>
 
 namespace srs {
 
-typedef Sparse_vector<int> sparse_ivector;
+typedef Sparse_vector<Int_t> sparse_ivector;
 typedef Sparse_vector<double> sparse_dvector;
 
-typedef Sparse_matrix<int> sparse_imatrix;
+typedef Sparse_matrix<Int_t> sparse_imatrix;
 typedef Sparse_matrix<double> sparse_dmatrix;
 
+typedef Sym_sparse_matrix<double> sym_sparse_dmatrix;
+
 }  // namespace srs
 
 #endif  // SRS_SPARSE_H
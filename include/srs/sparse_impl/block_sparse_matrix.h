@@ -0,0 +1,519 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SRS_BLOCK_SPARSE_MATRIX_H
+#define SRS_BLOCK_SPARSE_MATRIX_H
+
+#include <srs/array.h>
+#include <srs/math_impl/core.h>
+#include <srs/sparse_impl/sparse_matrix.h>
+#include <srs/types.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <gsl/gsl>
+#include <vector>
+
+
+namespace srs {
+
+//
+// Sparse matrix in block compressed sparse row (BSR) format with R x C
+// blocks fixed at compile time.
+//
+// Note:
+// - The block pattern is stored in CSR3 format with one column index per
+//   block, which cuts index memory traffic by a factor R * C compared to
+//   Sparse_matrix.
+// - Blocks are stored contiguously in row-major order (the zero-based BSR
+//   layout of Intel MKL). Zeros inside a nonzero block are stored.
+// - The number of rows and columns must be multiples of R and C.
+//
+template <class T, Int_t R, Int_t C>
+class Block_sparse_matrix {
+public:
+    typedef T value_type;
+    typedef Int_t size_type;
+
+    static constexpr size_type block_rows = R;
+    static constexpr size_type block_cols = C;
+    static constexpr size_type block_size = R * C;
+
+    // Constructors:
+
+    Block_sparse_matrix()
+        : elems(), col_indx(), row_ptr(1, 0), extents{0, 0}, zero{T(0)}
+    {
+    }
+
+    explicit Block_sparse_matrix(const Sparse_matrix<T>& a);
+
+    // Element access:
+
+    const T& operator()(size_type i, size_type j) const;
+
+    // Capacity:
+
+    size_type rows() const { return extents[0]; }
+    size_type cols() const { return extents[1]; }
+    size_type num_block_rows() const { return extents[0] / R; }
+    size_type num_block_cols() const { return extents[1] / C; }
+    size_type num_blocks() const { return col_indx.size(); }
+
+    // Access underlying arrays:
+
+    T* data() { return elems.data(); }
+    const T* data() const { return elems.data(); }
+
+    // Block k, stored row-major.
+    T* block(size_type k) { return elems.data() + k * block_size; }
+    const T* block(size_type k) const
+    {
+        return elems.data() + k * block_size;
+    }
+
+    // Block column indices and block row pointers.
+    const auto& columns() const { return col_indx; }
+    const auto& row_index() const { return row_ptr; }
+
+    // Position of block (bi, bj), or -1 if it is not stored.
+    size_type find_block(size_type bi, size_type bj) const;
+
+private:
+    std::vector<T> elems;
+    std::vector<size_type> col_indx;
+    std::vector<size_type> row_ptr;
+    std::array<size_type, 2> extents;
+    T zero;
+};
+
+template <class T, Int_t R, Int_t C>
+Block_sparse_matrix<T, R, C>::Block_sparse_matrix(const Sparse_matrix<T>& a)
+    : elems(), col_indx(), row_ptr(), extents{a.rows(), a.cols()}, zero{T(0)}
+{
+    Expects(a.rows() % R == 0 && a.cols() % C == 0);
+
+    const size_type nbr = a.rows() / R;
+    const auto& rowptr  = a.row_index();
+    const auto& colind  = a.columns();
+
+    // Block columns of each block row, sorted.
+    std::vector<std::vector<size_type>> pattern(nbr);
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (size_type bi = 0; bi < nbr; ++bi) {
+        auto& p = pattern[bi];
+        for (size_type i = bi * R; i < (bi + 1) * R; ++i) {
+            for (size_type k = rowptr[i]; k < rowptr[i + 1]; ++k) {
+                p.push_back(colind[k] / C);
+            }
+        }
+        std::sort(p.begin(), p.end());
+        p.erase(std::unique(p.begin(), p.end()), p.end());
+    }
+
+    row_ptr.resize(nbr + 1);
+    row_ptr[0] = 0;
+    for (size_type bi = 0; bi < nbr; ++bi) {
+        row_ptr[bi + 1] = row_ptr[bi] + pattern[bi].size();
+    }
+    col_indx.resize(row_ptr[nbr]);
+    elems.assign(row_ptr[nbr] * block_size, T(0));
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (size_type bi = 0; bi < nbr; ++bi) {
+        const auto& p = pattern[bi];
+        std::copy(p.begin(), p.end(), col_indx.begin() + row_ptr[bi]);
+        for (size_type r = 0; r < R; ++r) {
+            const size_type i = bi * R + r;
+            for (size_type k = rowptr[i]; k < rowptr[i + 1]; ++k) {
+                const size_type bj = colind[k] / C;
+                auto pos = std::lower_bound(p.begin(), p.end(), bj);
+                size_type kb = row_ptr[bi] + (pos - p.begin());
+                elems[kb * block_size + r * C + colind[k] % C] =
+                    a.values()[k];
+            }
+        }
+    }
+}
+
+template <class T, Int_t R, Int_t C>
+inline const T& Block_sparse_matrix<T, R, C>::
+operator()(size_type i, size_type j) const
+{
+    Expects(i >= 0 && i < extents[0]);
+    Expects(j >= 0 && j < extents[1]);
+    size_type k = find_block(i / R, j / C);
+    return (k < 0) ? zero : elems[k * block_size + (i % R) * C + j % C];
+}
+
+template <class T, Int_t R, Int_t C>
+typename Block_sparse_matrix<T, R, C>::size_type
+Block_sparse_matrix<T, R, C>::find_block(size_type bi, size_type bj) const
+{
+    auto first = col_indx.begin() + row_ptr[bi];
+    auto last  = col_indx.begin() + row_ptr[bi + 1];
+    auto pos   = std::lower_bound(first, last, bj);
+    if (pos != last && *pos == bj) {
+        return gsl::narrow_cast<size_type>(pos - col_indx.begin());
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+
+// Matrix-vector multiplication:
+//
+// The block products have compile-time trip counts and are fully unrolled
+// by the compiler, keeping the R partial sums in registers.
+
+// Compute y = alpha * a * x + beta * y. If y is empty, it is resized and
+// beta is ignored. The block rows are processed in parallel.
+template <class T, Int_t R, Int_t C>
+void mv_mul(const T& alpha,
+            const Block_sparse_matrix<T, R, C>& a,
+            const Array<T, 1>& x,
+            const T& beta,
+            Array<T, 1>& y)
+{
+    using size_type = typename Block_sparse_matrix<T, R, C>::size_type;
+
+    Expects(x.size() == a.cols());
+    T b = beta;
+    if (y.empty()) {
+        y.resize(a.rows());
+        b = T(0);
+    }
+    Expects(y.size() == a.rows());
+
+    const auto& col = a.columns();
+    const auto& ptr = a.row_index();
+    const T* px     = x.data();
+    T* py           = y.data();
+
+#pragma omp parallel for schedule(static)
+    for (size_type bi = 0; bi < a.num_block_rows(); ++bi) {
+        T sum[R] = {};
+        for (size_type k = ptr[bi]; k < ptr[bi + 1]; ++k) {
+            const T* blk = a.block(k);
+            const T* xb  = px + col[k] * C;
+            for (size_type r = 0; r < R; ++r) {
+                for (size_type c = 0; c < C; ++c) {
+                    sum[r] += blk[r * C + c] * xb[c];
+                }
+            }
+        }
+        T* yb = py + bi * R;
+        for (size_type r = 0; r < R; ++r) {
+            yb[r] = (b == T(0)) ? alpha * sum[r] : alpha * sum[r] + b * yb[r];
+        }
+    }
+}
+
+// Compute y = a * x.
+template <class T, Int_t R, Int_t C>
+inline void mv_mul(const Block_sparse_matrix<T, R, C>& a,
+                   const Array<T, 1>& x,
+                   Array<T, 1>& y)
+{
+    y.resize(a.rows());
+    mv_mul(T(1), a, x, T(0), y);
+}
+
+template <class T, Int_t R, Int_t C>
+inline Array<T, 1> operator*(const Block_sparse_matrix<T, R, C>& a,
+                             const Array<T, 1>& x)
+{
+    Array<T, 1> result(a.rows());
+    mv_mul(a, x, result);
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+// Matrix-matrix multiplication:
+
+// Compute c = a * b, where b is a dense matrix. Each block is loaded once
+// and applied to all columns of b.
+template <class T, Int_t R, Int_t C>
+void mm_mul(const Block_sparse_matrix<T, R, C>& a,
+            const Array<T, 2>& b,
+            Array<T, 2>& c)
+{
+    using size_type = typename Block_sparse_matrix<T, R, C>::size_type;
+
+    Expects(b.rows() == a.cols());
+    c.resize(a.rows(), b.cols());
+
+    const size_type m   = b.cols();
+    const size_type ldb = b.leading_dim();
+    const size_type ldc = c.leading_dim();
+
+    const auto& col = a.columns();
+    const auto& ptr = a.row_index();
+    const T* pb     = b.data();
+    T* pc           = c.data();
+
+#pragma omp parallel for schedule(static)
+    for (size_type bi = 0; bi < a.num_block_rows(); ++bi) {
+        for (size_type j = 0; j < m; ++j) {
+            std::fill_n(pc + j * ldc + bi * R, R, T(0));
+        }
+        for (size_type k = ptr[bi]; k < ptr[bi + 1]; ++k) {
+            const T* blk = a.block(k);
+            for (size_type j = 0; j < m; ++j) {
+                const T* bj = pb + j * ldb + col[k] * C;
+                T* cj       = pc + j * ldc + bi * R;
+                for (size_type r = 0; r < R; ++r) {
+                    T sum = T(0);
+                    for (size_type q = 0; q < C; ++q) {
+                        sum += blk[r * C + q] * bj[q];
+                    }
+                    cj[r] += sum;
+                }
+            }
+        }
+    }
+}
+
+template <class T, Int_t R, Int_t C>
+inline Array<T, 2> operator*(const Block_sparse_matrix<T, R, C>& a,
+                             const Array<T, 2>& b)
+{
+    Array<T, 2> result;
+    mm_mul(a, b, result);
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+//
+// Block incomplete LU factorization with zero fill-in, BILU(0), of a block
+// sparse matrix with square N x N blocks, for use as a preconditioner.
+//
+// The factors keep the block pattern of the matrix: the strictly lower
+// blocks hold l (with identity diagonal blocks) and the remaining blocks
+// hold u. The inverses of the diagonal blocks of u are stored separately.
+//
+// Note:
+// - Every diagonal block must be stored and remain nonsingular during the
+//   factorization, otherwise Math_error is thrown.
+//
+template <class T, Int_t N>
+class Block_ilu {
+public:
+    typedef T value_type;
+    typedef Int_t size_type;
+
+    Block_ilu() : lu(), diag(), dinv() {}
+
+    explicit Block_ilu(const Block_sparse_matrix<T, N, N>& a) { factorize(a); }
+
+    // Compute factorization of a new matrix.
+    void factorize(const Block_sparse_matrix<T, N, N>& a);
+
+    // Solve l * u * x = b. On exit, b holds the solution.
+    void solve(Array<T, 1>& b) const;
+
+    // Block factors l and u.
+    const Block_sparse_matrix<T, N, N>& factor() const { return lu; }
+
+    size_type rows() const { return lu.rows(); }
+    size_type cols() const { return lu.cols(); }
+
+private:
+    Block_sparse_matrix<T, N, N> lu;
+    std::vector<size_type> diag;  // position of the diagonal blocks
+    std::vector<T> dinv;          // inverses of the diagonal blocks of u
+
+    // Compute c -= a * b for N x N blocks.
+    static void block_mul_sub(const T* a, const T* b, T* c);
+
+    // Compute c = a * b for N x N blocks.
+    static void block_mul(const T* a, const T* b, T* c);
+
+    // Invert an N x N block by Gauss-Jordan elimination with partial
+    // pivoting.
+    static void block_inv(const T* a, T* ainv);
+};
+
+template <class T, Int_t N>
+void Block_ilu<T, N>::factorize(const Block_sparse_matrix<T, N, N>& a)
+{
+    constexpr size_type bs = N * N;
+
+    lu = a;
+
+    const size_type nbr = lu.num_block_rows();
+    const auto& col     = lu.columns();
+    const auto& ptr     = lu.row_index();
+
+    diag.resize(nbr);
+    dinv.resize(nbr * bs);
+    for (size_type i = 0; i < nbr; ++i) {
+        diag[i] = lu.find_block(i, i);
+        if (diag[i] < 0) {
+            throw Math_error("Block_ilu: missing diagonal block");
+        }
+    }
+
+    T lik[bs];
+    for (size_type i = 0; i < nbr; ++i) {
+        for (size_type k = ptr[i]; k < diag[i]; ++k) {
+            // l(i, kc) = a(i, kc) * u(kc, kc)^-1
+            const size_type kc = col[k];
+            block_mul(lu.block(k), dinv.data() + kc * bs, lik);
+            std::copy_n(lik, bs, lu.block(k));
+
+            // a(i, j) -= l(i, kc) * u(kc, j) for j > kc in both patterns.
+            size_type p = diag[kc] + 1;
+            size_type q = k + 1;
+            while (p < ptr[kc + 1] && q < ptr[i + 1]) {
+                if (col[p] < col[q]) {
+                    ++p;
+                }
+                else if (col[q] < col[p]) {
+                    ++q;
+                }
+                else {
+                    block_mul_sub(lik, lu.block(p), lu.block(q));
+                    ++p;
+                    ++q;
+                }
+            }
+        }
+        block_inv(lu.block(diag[i]), dinv.data() + i * bs);
+    }
+}
+
+template <class T, Int_t N>
+void Block_ilu<T, N>::solve(Array<T, 1>& b) const
+{
+    constexpr size_type bs = N * N;
+
+    Expects(b.size() == lu.rows());
+
+    const size_type nbr = lu.num_block_rows();
+    const auto& col     = lu.columns();
+    const auto& ptr     = lu.row_index();
+    T* x                = b.data();
+
+    // Forward substitution with l (unit diagonal blocks).
+    for (size_type i = 0; i < nbr; ++i) {
+        T* xi = x + i * N;
+        for (size_type k = ptr[i]; k < diag[i]; ++k) {
+            const T* lk = lu.block(k);
+            const T* xk = x + col[k] * N;
+            for (size_type r = 0; r < N; ++r) {
+                for (size_type c = 0; c < N; ++c) {
+                    xi[r] -= lk[r * N + c] * xk[c];
+                }
+            }
+        }
+    }
+
+    // Backward substitution with u.
+    T tmp[N];
+    for (size_type i = nbr - 1; i >= 0; --i) {
+        T* xi = x + i * N;
+        for (size_type k = diag[i] + 1; k < ptr[i + 1]; ++k) {
+            const T* uk = lu.block(k);
+            const T* xk = x + col[k] * N;
+            for (size_type r = 0; r < N; ++r) {
+                for (size_type c = 0; c < N; ++c) {
+                    xi[r] -= uk[r * N + c] * xk[c];
+                }
+            }
+        }
+        const T* di = dinv.data() + i * bs;
+        for (size_type r = 0; r < N; ++r) {
+            tmp[r] = T(0);
+            for (size_type c = 0; c < N; ++c) {
+                tmp[r] += di[r * N + c] * xi[c];
+            }
+        }
+        std::copy_n(tmp, N, xi);
+    }
+}
+
+template <class T, Int_t N>
+inline void Block_ilu<T, N>::block_mul_sub(const T* a, const T* b, T* c)
+{
+    for (size_type r = 0; r < N; ++r) {
+        for (size_type k = 0; k < N; ++k) {
+            for (size_type q = 0; q < N; ++q) {
+                c[r * N + q] -= a[r * N + k] * b[k * N + q];
+            }
+        }
+    }
+}
+
+template <class T, Int_t N>
+inline void Block_ilu<T, N>::block_mul(const T* a, const T* b, T* c)
+{
+    std::fill_n(c, N * N, T(0));
+    for (size_type r = 0; r < N; ++r) {
+        for (size_type k = 0; k < N; ++k) {
+            for (size_type q = 0; q < N; ++q) {
+                c[r * N + q] += a[r * N + k] * b[k * N + q];
+            }
+        }
+    }
+}
+
+template <class T, Int_t N>
+void Block_ilu<T, N>::block_inv(const T* a, T* ainv)
+{
+    T w[N * N];
+    std::copy_n(a, N * N, w);
+    std::fill_n(ainv, N * N, T(0));
+    for (size_type r = 0; r < N; ++r) {
+        ainv[r * N + r] = T(1);
+    }
+    for (size_type c = 0; c < N; ++c) {
+        size_type piv = c;
+        for (size_type r = c + 1; r < N; ++r) {
+            if (std::abs(w[r * N + c]) > std::abs(w[piv * N + c])) {
+                piv = r;
+            }
+        }
+        if (w[piv * N + c] == T(0)) {
+            throw Math_error("Block_ilu: singular diagonal block");
+        }
+        if (piv != c) {
+            std::swap_ranges(w + c * N, w + (c + 1) * N, w + piv * N);
+            std::swap_ranges(ainv + c * N, ainv + (c + 1) * N, ainv + piv * N);
+        }
+        const T d = w[c * N + c];
+        for (size_type q = 0; q < N; ++q) {
+            w[c * N + q] /= d;
+            ainv[c * N + q] /= d;
+        }
+        for (size_type r = 0; r < N; ++r) {
+            if (r != c && w[r * N + c] != T(0)) {
+                const T f = w[r * N + c];
+                for (size_type q = 0; q < N; ++q) {
+                    w[r * N + q] -= f * w[c * N + q];
+                    ainv[r * N + q] -= f * ainv[c * N + q];
+                }
+            }
+        }
+    }
+}
+
+}  // namespace srs
+
+#endif  // SRS_BLOCK_SPARSE_MATRIX_H
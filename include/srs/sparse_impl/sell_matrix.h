@@ -0,0 +1,280 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SRS_SELL_MATRIX_H
+#define SRS_SELL_MATRIX_H
+
+#include <srs/array.h>
+#include <srs/sparse_impl/sparse_matrix.h>
+#include <srs/types.h>
+#include <algorithm>
+#include <gsl/gsl>
+#include <numeric>
+#include <vector>
+
+
+namespace srs {
+
+//
+// Sparse matrix in the sliced ELLPACK (SELL-C-sigma) format.
+//
+// The rows are sorted by decreasing length within windows of sigma rows,
+// and then grouped into chunks of C consecutive rows. Each chunk is padded
+// to its longest row and stored column-major, so that element j of the C
+// rows of a chunk are contiguous. The products then process C rows at a
+// time in lockstep, which maps onto SIMD lanes, while sorting keeps the
+// padding small.
+//
+// Note:
+// - C should be a multiple of the SIMD width, e.g. 4 or 8 for double
+//   precision with AVX2 and 8 or 16 with AVX-512.
+// - Larger sigma reduces padding but reorders x accesses more.
+// - Padded entries hold zero with a valid column index, so that the
+//   gathers never read outside x.
+//
+template <class T>
+class Sell_matrix {
+public:
+    typedef T value_type;
+    typedef Int_t size_type;
+
+    // Largest supported chunk size.
+    static constexpr size_type max_chunk = 32;
+
+    Sell_matrix()
+        : elems(),
+          col_indx(),
+          chunk_ptr(1, 0),
+          chunk_len(),
+          perm(),
+          nrows{0},
+          ncols{0},
+          nnz{0},
+          c{8},
+          sig{1}
+    {
+    }
+
+    explicit Sell_matrix(const Sparse_matrix<T>& a,
+                         size_type chunk = 8,
+                         size_type sigma = 256);
+
+    size_type rows() const { return nrows; }
+    size_type cols() const { return ncols; }
+    size_type num_nonzero() const { return nnz; }
+    size_type chunk_size() const { return c; }
+    size_type sigma() const { return sig; }
+    size_type num_chunks() const { return chunk_len.size(); }
+
+    // Number of stored elements, including padding.
+    size_type num_stored() const { return elems.size(); }
+
+    // Access underlying arrays:
+
+    const auto& values() const { return elems; }
+    const auto& columns() const { return col_indx; }
+
+    // Offset of chunk k in values() and columns().
+    const auto& chunk_index() const { return chunk_ptr; }
+
+    // Padded row length of chunk k.
+    const auto& chunk_length() const { return chunk_len; }
+
+    // Original index of the row at sorted position k.
+    const auto& permutation() const { return perm; }
+
+private:
+    std::vector<T> elems;
+    std::vector<size_type> col_indx;
+    std::vector<size_type> chunk_ptr;
+    std::vector<size_type> chunk_len;
+    std::vector<size_type> perm;
+    size_type nrows;
+    size_type ncols;
+    size_type nnz;
+    size_type c;
+    size_type sig;
+};
+
+template <class T>
+Sell_matrix<T>::Sell_matrix(const Sparse_matrix<T>& a,
+                            size_type chunk,
+                            size_type sigma)
+    : elems(),
+      col_indx(),
+      chunk_ptr(),
+      chunk_len(),
+      perm(a.rows()),
+      nrows{a.rows()},
+      ncols{a.cols()},
+      nnz{0},
+      c{chunk},
+      sig{sigma}
+{
+    Expects(chunk >= 1 && chunk <= max_chunk);
+    Expects(sigma >= 1);
+
+    const auto& rowptr = a.row_index();
+    auto row_len       = [&](size_type i) { return rowptr[i + 1] - rowptr[i]; };
+
+    // Sort the rows by decreasing length within each sigma window.
+    std::iota(perm.begin(), perm.end(), 0);
+    for (size_type w = 0; w < nrows; w += sigma) {
+        auto first = perm.begin() + w;
+        auto last  = perm.begin() + std::min(w + sigma, nrows);
+        std::stable_sort(first, last, [&](size_type i, size_type j) {
+            return row_len(i) > row_len(j);
+        });
+    }
+
+    // Chunk offsets and padded lengths.
+    const size_type nchunks = (nrows + c - 1) / c;
+    chunk_ptr.resize(nchunks + 1);
+    chunk_len.resize(nchunks);
+    chunk_ptr[0] = 0;
+    for (size_type k = 0; k < nchunks; ++k) {
+        // The rows of a chunk may straddle two sigma windows, so the first
+        // row is not necessarily the longest.
+        size_type len = 0;
+        for (size_type r = k * c; r < std::min((k + 1) * c, nrows); ++r) {
+            len = std::max(len, row_len(perm[r]));
+        }
+        chunk_len[k]     = len;
+        chunk_ptr[k + 1] = chunk_ptr[k] + chunk_len[k] * c;
+    }
+    elems.assign(chunk_ptr[nchunks], T(0));
+    col_indx.assign(chunk_ptr[nchunks], 0);
+
+#pragma omp parallel for schedule(static)
+    for (size_type k = 0; k < nchunks; ++k) {
+        for (size_type r = 0; r < c && k * c + r < nrows; ++r) {
+            const size_type i    = perm[k * c + r];
+            const size_type len  = row_len(i);
+            const size_type base = chunk_ptr[k] + r;
+            for (size_type j = 0; j < len; ++j) {
+                elems[base + j * c]    = a.values()[rowptr[i] + j];
+                col_indx[base + j * c] = a.columns()[rowptr[i] + j];
+            }
+            // Padding repeats the last column index of the row.
+            size_type pad = (len > 0) ? a.columns()[rowptr[i] + len - 1] : 0;
+            for (size_type j = len; j < chunk_len[k]; ++j) {
+                col_indx[base + j * c] = pad;
+            }
+        }
+    }
+    nnz = nrows > 0 ? rowptr[nrows] : 0;
+}
+
+//------------------------------------------------------------------------------
+
+// Kernel for y = alpha * a * x + b * y with chunk size C known at compile
+// time, so that the lane loop and the accumulators fit in SIMD registers.
+// C = 0 selects a generic kernel that reads the chunk size at run time.
+template <Int_t C, class T>
+void sell_mv_kernel(const T& alpha,
+                    const Sell_matrix<T>& a,
+                    const T* px,
+                    const T& b,
+                    T* py)
+{
+    using size_type = typename Sell_matrix<T>::size_type;
+
+    const size_type c       = (C > 0) ? C : a.chunk_size();
+    const size_type nrows   = a.rows();
+    const size_type nchunks = a.num_chunks();
+
+    const T* val         = a.values().data();
+    const size_type* col = a.columns().data();
+    const size_type* ptr = a.chunk_index().data();
+    const size_type* len = a.chunk_length().data();
+    const size_type* pi  = a.permutation().data();
+
+#pragma omp parallel for schedule(dynamic, 16)
+    for (size_type k = 0; k < nchunks; ++k) {
+        T sum[(C > 0) ? C : Sell_matrix<T>::max_chunk];
+        std::fill_n(sum, c, T(0));
+        const T* vk         = val + ptr[k];
+        const size_type* ck = col + ptr[k];
+        for (size_type j = 0; j < len[k]; ++j) {
+            const T* vj         = vk + j * c;
+            const size_type* cj = ck + j * c;
+#pragma omp simd
+            for (size_type r = 0; r < c; ++r) {
+                sum[r] += vj[r] * px[cj[r]];
+            }
+        }
+        const size_type rend = std::min(c, nrows - k * c);
+        for (size_type r = 0; r < rend; ++r) {
+            T& yi = py[pi[k * c + r]];
+            yi    = (b == T(0)) ? alpha * sum[r] : alpha * sum[r] + b * yi;
+        }
+    }
+}
+
+// Compute y = alpha * a * x + beta * y. If y is empty, it is resized and
+// beta is ignored. The chunks are processed in parallel, with fixed-width
+// kernels for the chunk sizes that match common SIMD widths.
+template <class T>
+void mv_mul(const T& alpha,
+            const Sell_matrix<T>& a,
+            const Array<T, 1>& x,
+            const T& beta,
+            Array<T, 1>& y)
+{
+    Expects(x.size() == a.cols());
+    T b = beta;
+    if (y.empty()) {
+        y.resize(a.rows());
+        b = T(0);
+    }
+    Expects(y.size() == a.rows());
+
+    switch (a.chunk_size()) {
+    case 4:
+        sell_mv_kernel<4>(alpha, a, x.data(), b, y.data());
+        break;
+    case 8:
+        sell_mv_kernel<8>(alpha, a, x.data(), b, y.data());
+        break;
+    case 16:
+        sell_mv_kernel<16>(alpha, a, x.data(), b, y.data());
+        break;
+    default:
+        sell_mv_kernel<0>(alpha, a, x.data(), b, y.data());
+        break;
+    }
+}
+
+// Compute y = a * x.
+template <class T>
+inline void
+mv_mul(const Sell_matrix<T>& a, const Array<T, 1>& x, Array<T, 1>& y)
+{
+    y.resize(a.rows());
+    mv_mul(T(1), a, x, T(0), y);
+}
+
+template <class T>
+inline Array<T, 1> operator*(const Sell_matrix<T>& a, const Array<T, 1>& x)
+{
+    Array<T, 1> result(a.rows());
+    mv_mul(a, x, result);
+    return result;
+}
+
+}  // namespace srs
+
+#endif  // SRS_SELL_MATRIX_H
@@ -0,0 +1,219 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SRS_SPARSE_BUILDER_H
+#define SRS_SPARSE_BUILDER_H
+
+#include <srs/sparse_impl/sparse_matrix.h>
+#include <srs/types.h>
+#include <algorithm>
+#include <array>
+#include <gsl/gsl>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+namespace srs {
+
+//
+// Assembly of sparse matrices from (i, j, value) triplets in coordinate
+// (COO) format.
+//
+// Triplets can be added in any order, and duplicates are summed when the
+// matrix is compressed. Each OpenMP thread appends to its own buffer, so
+// that add() can be called concurrently from a parallel region, e.g. for
+// finite element assembly.
+//
+// Note:
+// - Compression to CSR3 requires O(nnz log(nnz / rows)) operations; the
+//   triplets are bucketed by row with a counting sort, and the rows are
+//   then sorted and merged in parallel.
+// - Summed duplicates are kept even if they are zero, so that the sparsity
+//   pattern does not depend on the values.
+// - Use this class rather than Sparse_matrix::insert(), which requires
+//   O(nnz) operations per element.
+//
+template <class T>
+class Sparse_builder {
+public:
+    typedef T value_type;
+    typedef Int_t size_type;
+
+    Sparse_builder(size_type nrows, size_type ncols);
+
+    // Reserve space for nnz triplets, spread over the thread buffers.
+    void reserve(size_type nnz);
+
+    // Add value to element (i, j). Thread-safe within a parallel region
+    // with no more threads than omp_get_max_threads() at construction.
+    void add(size_type i, size_type j, const T& value);
+
+    // Compress the triplets to a sparse matrix in CSR3 format.
+    Sparse_matrix<T> compress() const;
+
+    // Discard all triplets.
+    void clear();
+
+    size_type rows() const { return extents[0]; }
+    size_type cols() const { return extents[1]; }
+
+    // Number of triplets added, including duplicates.
+    size_type num_triplets() const;
+
+private:
+    struct Triplet {
+        size_type row;
+        size_type col;
+        T value;
+    };
+
+    std::vector<std::vector<Triplet>> buffers;
+    std::array<size_type, 2> extents;
+};
+
+template <class T>
+Sparse_builder<T>::Sparse_builder(size_type nrows, size_type ncols)
+    : buffers(), extents{nrows, ncols}
+{
+    Expects(nrows >= 0 && ncols >= 0);
+#ifdef _OPENMP
+    buffers.resize(omp_get_max_threads());
+#else
+    buffers.resize(1);
+#endif
+}
+
+template <class T>
+void Sparse_builder<T>::reserve(size_type nnz)
+{
+    const size_type nbuf = gsl::narrow_cast<size_type>(buffers.size());
+    for (auto& buf : buffers) {
+        buf.reserve(nnz / nbuf + 1);
+    }
+}
+
+template <class T>
+inline void Sparse_builder<T>::add(size_type i, size_type j, const T& value)
+{
+    Expects(i >= 0 && i < extents[0]);
+    Expects(j >= 0 && j < extents[1]);
+#ifdef _OPENMP
+    const std::size_t tid = omp_get_thread_num();
+#else
+    const std::size_t tid = 0;
+#endif
+    Expects(tid < buffers.size());
+    buffers[tid].push_back({i, j, value});
+}
+
+template <class T>
+Sparse_matrix<T> Sparse_builder<T>::compress() const
+{
+    const size_type nrows = extents[0];
+    const size_type nnz   = num_triplets();
+
+    // Bucket the triplets by row (counting sort).
+    std::vector<size_type> row_ptr(nrows + 1, 0);
+    for (const auto& buf : buffers) {
+        for (const auto& t : buf) {
+            ++row_ptr[t.row + 1];
+        }
+    }
+    for (size_type i = 0; i < nrows; ++i) {
+        row_ptr[i + 1] += row_ptr[i];
+    }
+    std::vector<std::pair<size_type, T>> entries(nnz);
+    {
+        std::vector<size_type> next(row_ptr.begin(), row_ptr.end() - 1);
+        for (const auto& buf : buffers) {
+            for (const auto& t : buf) {
+                entries[next[t.row]++] = {t.col, t.value};
+            }
+        }
+    }
+
+    // Sort each row by column and sum duplicates in place.
+    std::vector<size_type> row_nnz(nrows + 1, 0);
+
+#pragma omp parallel for schedule(dynamic, 256)
+    for (size_type i = 0; i < nrows; ++i) {
+        auto first = entries.begin() + row_ptr[i];
+        auto last  = entries.begin() + row_ptr[i + 1];
+        std::sort(first, last, [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+        auto out = first;
+        for (auto it = first; it != last; ++it) {
+            if (out != first && (out - 1)->first == it->first) {
+                (out - 1)->second += it->second;
+            }
+            else {
+                *out++ = *it;
+            }
+        }
+        row_nnz[i + 1] = gsl::narrow_cast<size_type>(out - first);
+    }
+
+    // Copy the merged rows to the CSR3 arrays.
+    for (size_type i = 0; i < nrows; ++i) {
+        row_nnz[i + 1] += row_nnz[i];
+    }
+    std::vector<T> elems(row_nnz[nrows]);
+    std::vector<size_type> col_indx(row_nnz[nrows]);
+
+#pragma omp parallel for schedule(static)
+    for (size_type i = 0; i < nrows; ++i) {
+        size_type k = row_nnz[i];
+        for (size_type p = row_ptr[i]; k < row_nnz[i + 1]; ++p, ++k) {
+            col_indx[k] = entries[p].first;
+            elems[k]    = entries[p].second;
+        }
+    }
+
+    return Sparse_matrix<T>(nrows,
+                            extents[1],
+                            std::move(elems),
+                            std::move(col_indx),
+                            std::move(row_nnz));
+}
+
+template <class T>
+void Sparse_builder<T>::clear()
+{
+    for (auto& buf : buffers) {
+        buf.clear();
+    }
+}
+
+template <class T>
+typename Sparse_builder<T>::size_type Sparse_builder<T>::num_triplets() const
+{
+    std::size_t nnz = 0;
+    for (const auto& buf : buffers) {
+        nnz += buf.size();
+    }
+    Expects(nnz <= static_cast<std::size_t>(
+                       std::numeric_limits<size_type>::max()));
+    return static_cast<size_type>(nnz);
+}
+
+}  // namespace srs
+
+#endif  // SRS_SPARSE_BUILDER_H
@@ -17,9 +17,27 @@
 #ifndef SRS_SPARSE_IO_H
 #define SRS_SPARSE_IO_H
 
+#include <srs/sparse_impl/sparse_builder.h>
 #include <srs/sparse_impl/sparse_matrix.h>
 #include <srs/sparse_impl/sparse_vector.h>
+#include <srs/types.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <gsl/gsl>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 
 namespace srs {
@@ -47,9 +65,11 @@ std::ostream& operator<<(std::ostream& to, const Sparse_matrix<T>& mat)
     to << "[matrix size: " << mat.rows() << " x " << mat.cols()
        << "; number of non-zero elements: " << mat.num_nonzero() << "]\n\n";
     for (size_type i = 0; i < mat.rows(); ++i) {
-        for (size_type j = 0; j < mat.cols(); ++j) {
-            if (mat(i, j) != T(0)) {
-                to << "(" << i << ", " << j << ")\t" << mat(i, j) << '\n';
+        for (size_type k = mat.row_index()[i]; k < mat.row_index()[i + 1];
+             ++k) {
+            if (mat.values()[k] != T(0)) {
+                to << "(" << i << ", " << mat.columns()[k] << ")\t"
+                   << mat.values()[k] << '\n';
             }
         }
     }
@@ -57,6 +77,519 @@ std::ostream& operator<<(std::ostream& to, const Sparse_matrix<T>& mat)
     return to;
 }
 
+//------------------------------------------------------------------------------
+
+// Error reporting:
+
+struct Sparse_io_error : std::runtime_error {
+    Sparse_io_error(std::string s) : std::runtime_error(s) {}
+};
+
+//------------------------------------------------------------------------------
+
+// Matrix Market I/O:
+
+// Header and size line of a Matrix Market file.
+struct Matrix_market_header {
+    enum Symmetry_t { general, symmetric, skew_symmetric };
+
+    bool coordinate;      // coordinate or array format
+    bool pattern;         // no values; the elements are set to one
+    Symmetry_t symmetry;  // only the lower triangle is stored if symmetric
+    Int_t rows;
+    Int_t cols;
+    Int_t entries;  // number of stored entries (coordinate format)
+};
+
+// Read the banner, comments and size line of a Matrix Market file. Only
+// real, integer and pattern matrices are supported.
+inline Matrix_market_header read_matrix_market_header(std::istream& from)
+{
+    std::string line;
+    if (!std::getline(from, line)) {
+        throw Sparse_io_error("read_matrix_market: empty file");
+    }
+    std::transform(line.begin(), line.end(), line.begin(), [](char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    });
+
+    std::istringstream banner(line);
+    std::string tag;
+    std::string object;
+    std::string format;
+    std::string field;
+    std::string symmetry;
+    banner >> tag >> object >> format >> field >> symmetry;
+    if (tag != "%%matrixmarket" || object != "matrix") {
+        throw Sparse_io_error("read_matrix_market: bad banner");
+    }
+
+    Matrix_market_header hdr;
+    if (format == "coordinate") {
+        hdr.coordinate = true;
+    }
+    else if (format == "array") {
+        hdr.coordinate = false;
+    }
+    else {
+        throw Sparse_io_error("read_matrix_market: bad format " + format);
+    }
+    if (field == "real" || field == "double" || field == "integer") {
+        hdr.pattern = false;
+    }
+    else if (field == "pattern" && hdr.coordinate) {
+        hdr.pattern = true;
+    }
+    else {
+        throw Sparse_io_error("read_matrix_market: bad field " + field);
+    }
+    if (symmetry == "general") {
+        hdr.symmetry = Matrix_market_header::general;
+    }
+    else if (symmetry == "symmetric") {
+        hdr.symmetry = Matrix_market_header::symmetric;
+    }
+    else if (symmetry == "skew-symmetric") {
+        hdr.symmetry = Matrix_market_header::skew_symmetric;
+    }
+    else {
+        throw Sparse_io_error("read_matrix_market: bad symmetry " + symmetry);
+    }
+
+    // Skip comments and blank lines up to the size line:
+    while (std::getline(from, line)) {
+        auto first = line.find_first_not_of(" \t\r");
+        if (first != std::string::npos && line[first] != '%') {
+            break;
+        }
+    }
+    std::istringstream size_line(line);
+    long long m = -1;
+    long long n = -1;
+    long long nz;
+    size_line >> m >> n;
+    if (hdr.coordinate) {
+        size_line >> nz;
+    }
+    else if (hdr.symmetry == Matrix_market_header::general) {
+        nz = m * n;
+    }
+    else if (hdr.symmetry == Matrix_market_header::symmetric) {
+        nz = m * (m + 1) / 2;
+    }
+    else {
+        nz = m * (m - 1) / 2;
+    }
+    if (!size_line || m < 0 || n < 0 || nz < 0
+        || (hdr.symmetry != Matrix_market_header::general && m != n)) {
+        throw Sparse_io_error("read_matrix_market: bad size line");
+    }
+    if (m > std::numeric_limits<Int_t>::max()
+        || n > std::numeric_limits<Int_t>::max()
+        || nz > std::numeric_limits<Int_t>::max()) {
+        throw Sparse_io_error("read_matrix_market: matrix too large");
+    }
+    hdr.rows    = gsl::narrow_cast<Int_t>(m);
+    hdr.cols    = gsl::narrow_cast<Int_t>(n);
+    hdr.entries = gsl::narrow_cast<Int_t>(nz);
+    return hdr;
+}
+
+// Read a sparse matrix in Matrix Market format. Symmetric and
+// skew-symmetric matrices are expanded to both triangles, and zeros of
+// matrices in array format are dropped.
+//
+// The file is read in chunks of chunk_size bytes, which are split at line
+// boundaries into one piece per thread. The pieces are parsed in parallel
+// into a Sparse_builder, so that neither the file nor a dense matrix is
+// held in memory.
+template <class T>
+void read_matrix_market(std::istream& from,
+                        Sparse_matrix<T>& a,
+                        std::size_t chunk_size = std::size_t(1) << 26)
+{
+    using size_type = typename Sparse_matrix<T>::size_type;
+    using Symmetry  = Matrix_market_header;
+
+    const Matrix_market_header hdr = read_matrix_market_header(from);
+    const long long m              = hdr.rows;
+    const bool general             = hdr.symmetry == Symmetry::general;
+    const T sign = (hdr.symmetry == Symmetry::skew_symmetric) ? T(-1) : T(1);
+
+    Sparse_builder<T> builder(hdr.rows, hdr.cols);
+    builder.reserve(hdr.entries);
+
+#ifdef _OPENMP
+    const size_type nparts = std::max(1, omp_get_max_threads());
+#else
+    const size_type nparts = 1;
+#endif
+
+    // Position (i, j) of entry k of an array file, which stores the columns
+    // of the matrix, or of its lower triangle, in order. The diagonal is
+    // omitted if skew-symmetric.
+    const long long skip = (hdr.symmetry == Symmetry::skew_symmetric) ? 1 : 0;
+    auto array_position = [&](long long k, long long& i, long long& j) {
+        if (general) {
+            i = k % m;
+            j = k / m;
+            return;
+        }
+        j = 0;
+        while (k >= m - j - skip) {
+            k -= m - j - skip;
+            ++j;
+        }
+        i = j + skip + k;
+    };
+    auto array_next = [&](long long& i, long long& j) {
+        if (++i == m) {
+            ++j;
+            i = general ? 0 : j + skip;
+        }
+    };
+
+    auto add = [&](long long i, long long j, const T& v) {
+        builder.add(gsl::narrow_cast<size_type>(i),
+                    gsl::narrow_cast<size_type>(j),
+                    v);
+        if (!general && i != j) {
+            builder.add(gsl::narrow_cast<size_type>(j),
+                        gsl::narrow_cast<size_type>(i),
+                        sign * v);
+        }
+    };
+
+    // Data line, i.e. not blank and not a comment.
+    auto is_entry = [](const char* p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            ++p;
+        }
+        return p < end && *p != '\n' && *p != '%';
+    };
+
+    std::vector<char> buf;
+    std::size_t carry = 0;
+    long long nread   = 0;
+    bool eof          = false;
+
+    std::vector<std::size_t> first(nparts + 1);
+    std::vector<long long> count(nparts + 1);
+    std::vector<char> bad(nparts);
+
+    while (!eof) {
+        buf.resize(carry + chunk_size + 1);
+        from.read(buf.data() + carry,
+                  gsl::narrow_cast<std::streamsize>(chunk_size));
+        std::size_t len = carry + gsl::narrow_cast<std::size_t>(from.gcount());
+        eof             = !from;
+        if (eof && len > 0 && buf[len - 1] != '\n') {
+            buf[len++] = '\n';
+        }
+
+        // Parse up to the last complete line:
+        std::size_t end = len;
+        while (end > 0 && buf[end - 1] != '\n') {
+            --end;
+        }
+
+        // Split into pieces at line boundaries, and count the entries of
+        // each piece to number the entries of array files:
+        first[0]      = 0;
+        first[nparts] = end;
+        for (size_type t = 1; t < nparts; ++t) {
+            std::size_t pos = std::max<std::size_t>(
+                first[t - 1], static_cast<std::size_t>(t) * end / nparts);
+            while (pos > 0 && pos < end && buf[pos - 1] != '\n') {
+                ++pos;
+            }
+            first[t] = pos;
+        }
+        count[0] = nread;
+
+#pragma omp parallel for schedule(static, 1)
+        for (size_type t = 0; t < nparts; ++t) {
+            long long n    = 0;
+            const char* p  = buf.data() + first[t];
+            const char* pe = buf.data() + first[t + 1];
+            while (p < pe) {
+                const char* eol
+                    = static_cast<const char*>(std::memchr(p, '\n', pe - p));
+                n += is_entry(p, eol);
+                p = eol + 1;
+            }
+            count[t + 1] = n;
+        }
+        for (size_type t = 0; t < nparts; ++t) {
+            count[t + 1] += count[t];
+        }
+        if (count[nparts] > hdr.entries) {
+            throw Sparse_io_error("read_matrix_market: too many entries");
+        }
+
+#pragma omp parallel for schedule(static, 1)
+        for (size_type t = 0; t < nparts; ++t) {
+            const char* p  = buf.data() + first[t];
+            const char* pe = buf.data() + first[t + 1];
+            long long ai   = 0;
+            long long aj   = 0;
+            if (!hdr.coordinate && count[t] < count[t + 1]) {
+                array_position(count[t], ai, aj);
+            }
+            while (p < pe) {
+                const char* eol
+                    = static_cast<const char*>(std::memchr(p, '\n', pe - p));
+                if (is_entry(p, eol)) {
+                    char* q     = const_cast<char*>(p);
+                    long long i = ai;
+                    long long j = aj;
+                    if (hdr.coordinate) {
+                        i = std::strtoll(q, &q, 10) - 1;
+                        j = std::strtoll(q, &q, 10) - 1;
+                    }
+                    else {
+                        array_next(ai, aj);
+                    }
+                    T v = T(1);
+                    if (!hdr.pattern) {
+                        char* last = nullptr;
+                        v          = static_cast<T>(std::strtod(q, &last));
+                        if (last == q) {
+                            bad[t] = 1;
+                            break;
+                        }
+                        q = last;
+                    }
+                    if (q > eol || i < 0 || i >= hdr.rows || j < 0
+                        || j >= hdr.cols) {
+                        bad[t] = 1;
+                        break;
+                    }
+                    if (hdr.coordinate || v != T(0)) {
+                        add(i, j, v);
+                    }
+                }
+                p = eol + 1;
+            }
+        }
+        if (std::find(bad.begin(), bad.end(), 1) != bad.end()) {
+            throw Sparse_io_error("read_matrix_market: bad entry");
+        }
+        nread = count[nparts];
+
+        // Keep the incomplete last line for the next chunk:
+        std::copy(buf.begin() + end, buf.begin() + len, buf.begin());
+        carry = len - end;
+    }
+    if (nread != hdr.entries) {
+        throw Sparse_io_error("read_matrix_market: too few entries");
+    }
+    a = builder.compress();
+}
+
+// Write a sparse matrix in Matrix Market coordinate format.
+template <class T>
+void write_matrix_market(std::ostream& to, const Sparse_matrix<T>& a)
+{
+    using size_type = typename Sparse_matrix<T>::size_type;
+
+    const auto& val = a.values();
+    const auto& col = a.columns();
+    const auto& ptr = a.row_index();
+
+    const char* field
+        = std::numeric_limits<T>::is_integer ? "integer" : "real";
+    to << "%%MatrixMarket matrix coordinate " << field << " general\n";
+    to << a.rows() << ' ' << a.cols() << ' ' << a.num_nonzero() << '\n';
+
+    const auto precision = to.precision(std::numeric_limits<T>::max_digits10);
+    for (size_type i = 0; i < a.rows(); ++i) {
+        for (size_type k = ptr[i]; k < ptr[i + 1]; ++k) {
+            to << i + 1 << ' ' << col[k] + 1 << ' ' << val[k] << '\n';
+        }
+    }
+    to.precision(precision);
+}
+
+//------------------------------------------------------------------------------
+
+// Binary I/O:
+
+//
+// Compact binary CSR format. All fields are in native byte order:
+//
+//   magic        8 bytes "SRSCSR01"
+//   value size   uint32, sizeof(T)
+//   index width  uint32, 4 or 8 bytes per row pointer
+//   rows         uint64
+//   cols         uint64
+//   nnz          uint64
+//   row pointers (rows + 1) x index width bytes
+//   col bytes    uint64, length of the column stream
+//   columns      varint (LEB128) stream; the first column of each row as is
+//                and the others as the difference to the previous column
+//   values       nnz x value size bytes
+//
+// Row pointers use 32 bits if nnz < 2^32. Since the column indices of a row
+// are sorted, most differences fit in one or two bytes.
+//
+
+// Write a sparse matrix in binary CSR format.
+template <class T>
+void write_binary(std::ostream& to, const Sparse_matrix<T>& a)
+{
+    using size_type = typename Sparse_matrix<T>::size_type;
+
+    const auto& val = a.values();
+    const auto& col = a.columns();
+    const auto& ptr = a.row_index();
+
+    const std::uint64_t rows   = a.rows();
+    const std::uint64_t cols   = a.cols();
+    const std::uint64_t nnz    = a.num_nonzero();
+    const std::uint32_t vsize  = sizeof(T);
+    const std::uint32_t iwidth = (nnz >> 32) ? 8 : 4;
+
+    to.write("SRSCSR01", 8);
+    to.write(reinterpret_cast<const char*>(&vsize), sizeof(vsize));
+    to.write(reinterpret_cast<const char*>(&iwidth), sizeof(iwidth));
+    to.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+    to.write(reinterpret_cast<const char*>(&cols), sizeof(cols));
+    to.write(reinterpret_cast<const char*>(&nnz), sizeof(nnz));
+
+    if (rows > 0) {
+        if (iwidth == 4) {
+            std::vector<std::uint32_t> rp(ptr.begin(), ptr.end());
+            to.write(reinterpret_cast<const char*>(rp.data()),
+                     rp.size() * sizeof(std::uint32_t));
+        }
+        else {
+            std::vector<std::uint64_t> rp(ptr.begin(), ptr.end());
+            to.write(reinterpret_cast<const char*>(rp.data()),
+                     rp.size() * sizeof(std::uint64_t));
+        }
+    }
+
+    std::vector<unsigned char> stream;
+    stream.reserve(nnz + nnz / 2);
+    for (size_type i = 0; i < a.rows(); ++i) {
+        std::uint64_t prev = 0;
+        for (size_type k = ptr[i]; k < ptr[i + 1]; ++k) {
+            std::uint64_t d = static_cast<std::uint64_t>(col[k]) - prev;
+            prev            = col[k];
+            while (d >= 0x80) {
+                stream.push_back(static_cast<unsigned char>(d | 0x80));
+                d >>= 7;
+            }
+            stream.push_back(static_cast<unsigned char>(d));
+        }
+    }
+    const std::uint64_t nbytes = stream.size();
+    to.write(reinterpret_cast<const char*>(&nbytes), sizeof(nbytes));
+    to.write(reinterpret_cast<const char*>(stream.data()), nbytes);
+    to.write(reinterpret_cast<const char*>(val.data()), nnz * sizeof(T));
+    if (!to) {
+        throw Sparse_io_error("write_binary: write failed");
+    }
+}
+
+// Read a sparse matrix in binary CSR format.
+template <class T>
+void read_binary(std::istream& from, Sparse_matrix<T>& a)
+{
+    using size_type = typename Sparse_matrix<T>::size_type;
+
+    char magic[8];
+    std::uint32_t vsize  = 0;
+    std::uint32_t iwidth = 0;
+    std::uint64_t rows   = 0;
+    std::uint64_t cols   = 0;
+    std::uint64_t nnz    = 0;
+
+    from.read(magic, 8);
+    from.read(reinterpret_cast<char*>(&vsize), sizeof(vsize));
+    from.read(reinterpret_cast<char*>(&iwidth), sizeof(iwidth));
+    from.read(reinterpret_cast<char*>(&rows), sizeof(rows));
+    from.read(reinterpret_cast<char*>(&cols), sizeof(cols));
+    from.read(reinterpret_cast<char*>(&nnz), sizeof(nnz));
+    if (!from || std::memcmp(magic, "SRSCSR01", 8) != 0) {
+        throw Sparse_io_error("read_binary: bad header");
+    }
+    if (vsize != sizeof(T) || (iwidth != 4 && iwidth != 8)) {
+        throw Sparse_io_error("read_binary: bad value size or index width");
+    }
+    const std::uint64_t max_index = std::numeric_limits<size_type>::max();
+    if (rows > max_index || cols > max_index || nnz > max_index) {
+        throw Sparse_io_error("read_binary: matrix too large");
+    }
+
+    const size_type m = gsl::narrow_cast<size_type>(rows);
+    const size_type n = gsl::narrow_cast<size_type>(cols);
+    std::vector<size_type> row_ptr(m + 1, 0);
+    if (m > 0) {
+        if (iwidth == 4) {
+            std::vector<std::uint32_t> rp(m + 1);
+            from.read(reinterpret_cast<char*>(rp.data()),
+                      rp.size() * sizeof(std::uint32_t));
+            std::copy(rp.begin(), rp.end(), row_ptr.begin());
+        }
+        else {
+            std::vector<std::uint64_t> rp(m + 1);
+            from.read(reinterpret_cast<char*>(rp.data()),
+                      rp.size() * sizeof(std::uint64_t));
+            std::copy(rp.begin(), rp.end(), row_ptr.begin());
+        }
+    }
+
+    std::uint64_t nbytes = 0;
+    from.read(reinterpret_cast<char*>(&nbytes), sizeof(nbytes));
+    std::vector<unsigned char> stream(nbytes);
+    from.read(reinterpret_cast<char*>(stream.data()), nbytes);
+
+    std::vector<T> elems(nnz);
+    from.read(reinterpret_cast<char*>(elems.data()), nnz * sizeof(T));
+    if (!from) {
+        throw Sparse_io_error("read_binary: truncated file");
+    }
+    for (size_type i = 0; i < m; ++i) {
+        if (row_ptr[i] > row_ptr[i + 1]) {
+            throw Sparse_io_error("read_binary: bad row pointers");
+        }
+    }
+    if (row_ptr[0] != 0 || row_ptr[m] != gsl::narrow_cast<size_type>(nnz)) {
+        throw Sparse_io_error("read_binary: bad row pointers");
+    }
+
+    std::vector<size_type> col_indx(nnz);
+    std::size_t pos = 0;
+    for (size_type i = 0; i < m; ++i) {
+        std::uint64_t prev = 0;
+        for (size_type k = row_ptr[i]; k < row_ptr[i + 1]; ++k) {
+            std::uint64_t d = 0;
+            int shift       = 0;
+            while (pos < nbytes && (stream[pos] & 0x80)) {
+                d |= std::uint64_t(stream[pos++] & 0x7f) << shift;
+                shift += 7;
+            }
+            if (pos == nbytes) {
+                throw Sparse_io_error("read_binary: bad column stream");
+            }
+            d |= std::uint64_t(stream[pos++]) << shift;
+            prev += d;
+            if (prev >= cols) {
+                throw Sparse_io_error("read_binary: bad column index");
+            }
+            col_indx[k] = gsl::narrow_cast<size_type>(prev);
+        }
+    }
+
+    a = Sparse_matrix<T>(m,
+                         n,
+                         std::move(elems),
+                         std::move(col_indx),
+                         std::move(row_ptr));
+}
+
 }  // namespace srs
 
 #endif  // SRS_SPARSE_IO_H
@@ -17,13 +17,14 @@
 #ifndef SRS_SPARSE_MATRIX_H
 #define SRS_SPARSE_MATRIX_H
 
-#include <mkl.h>
+#include <srs/math_impl/backend.h>
 #include <srs/array.h>
 #include <srs/array_impl/functors.h>
 #include <srs/types.h>
 #include <algorithm>
 #include <array>
 #include <gsl/gsl>
+#include <utility>
 #include <vector>
 
 
@@ -37,8 +38,11 @@ namespace srs {
 //   sparse row (CSR3) format.
 // - It is assumed that the sparse vector is initialized with element indices
 //   sorted in ascending order.
-// - New elements are inserted so that the index order is preserved.
-// - Array indexing uses signed integers (int).
+// - New elements are inserted so that the index order is preserved. Each
+//   insertion requires O(nnz) operations; use Sparse_builder to assemble
+//   large matrices.
+// - Array indexing uses signed integers (Int_t, see types.h); the number of
+//   nonzeros is limited by the range of Int_t.
 // - This class provides a framework for implementing sparse matrix methods
 //   that utilize the Intel MKL library.
 //
@@ -58,9 +62,9 @@ public:
 
     Sparse_matrix(size_type nrows,
                   size_type ncols,
-                  const std::vector<T>& elems_,
-                  const std::vector<size_type>& colind,
-                  const std::vector<size_type>& rowptr);
+                  std::vector<T> elems_,
+                  std::vector<size_type> colind,
+                  std::vector<size_type> rowptr);
 
     template <Int_t n, Int_t nnz>
     Sparse_matrix(size_type nrows,
@@ -141,6 +145,9 @@ private:
 
     T& ref(size_type i, size_type j);
     const T& ref(size_type i, size_type j) const;
+
+    // Position of element (i, j) in elems, or -1 if it is not stored.
+    size_type find(size_type i, size_type j) const;
 };
 
 template <class T>
@@ -156,16 +163,18 @@ Sparse_matrix<T>::Sparse_matrix(size_type nrows, size_type ncols, size_type nnz)
 template <class T>
 Sparse_matrix<T>::Sparse_matrix(size_type nrows,
                                 size_type ncols,
-                                const std::vector<T>& elems_,
-                                const std::vector<size_type>& colind,
-                                const std::vector<size_type>& rowptr)
-    : elems(elems_),
-      col_indx(colind),
-      row_ptr(rowptr),
+                                std::vector<T> elems_,
+                                std::vector<size_type> colind,
+                                std::vector<size_type> rowptr)
+    : elems(std::move(elems_)),
+      col_indx(std::move(colind)),
+      row_ptr(std::move(rowptr)),
       extents{nrows, ncols},
       zero{T(0)}
 {
     Ensures(elems.size() == col_indx.size());
+    Ensures(elems.size() <= static_cast<std::size_t>(
+                                std::numeric_limits<size_type>::max()));
     Ensures(row_ptr.size() == gsl::narrow_cast<std::size_t>(nrows + 1));
 }
 
@@ -225,7 +234,8 @@ inline const T& Sparse_matrix<T>::operator()(size_type i, size_type j) const
 }
 
 template <class T>
-inline int Sparse_matrix<T>::extent(size_type dim) const
+inline typename Sparse_matrix<T>::size_type
+Sparse_matrix<T>::extent(size_type dim) const
 {
     Expects(dim >= 0 && dim < 2);
     return extents[dim];
@@ -244,15 +254,15 @@ template <class T>
 inline void Sparse_matrix<T>::swap(Sparse_matrix& m)
 {
     elems.swap(m.elems);
-    col_indx.swap(m.cols);
-    row_ptr.swap(m.row_indx);
+    col_indx.swap(m.col_indx);
+    row_ptr.swap(m.row_ptr);
     std::swap(extents, m.extents);
 }
 
 template <class T>
 void Sparse_matrix<T>::insert(size_type i, size_type j, const T& value)
 {
-    if (ref(i, j) == zero) {
+    if (find(i, j) < 0) {
         auto pos = std::upper_bound(col_indx.begin() + row_ptr[i],
                                     col_indx.begin() + row_ptr[i + 1],
                                     j);
@@ -339,23 +349,39 @@ inline Sparse_matrix<T>& Sparse_matrix<T>::operator-()
 template <class T>
 inline T& Sparse_matrix<T>::ref(size_type i, size_type j)
 {
-    for (size_type k = row_ptr[i]; k < row_ptr[i + 1]; ++k) {
-        if (col_indx[k] == j) {
-            return elems[k];
-        }
-    }
-    return zero;
+    size_type k = find(i, j);
+    return (k < 0) ? zero : elems[k];
 }
 
 template <class T>
 inline const T& Sparse_matrix<T>::ref(size_type i, size_type j) const
 {
-    for (size_type k = row_ptr[i]; k < row_ptr[i + 1]; ++k) {
-        if (col_indx[k] == j) {
-            return elems[k];
+    size_type k = find(i, j);
+    return (k < 0) ? zero : elems[k];
+}
+
+template <class T>
+inline typename Sparse_matrix<T>::size_type
+Sparse_matrix<T>::find(size_type i, size_type j) const
+{
+    // Short rows are scanned linearly, which vectorizes well; longer rows
+    // are searched by bisection since the column indices are sorted.
+    const size_type first = row_ptr[i];
+    const size_type last  = row_ptr[i + 1];
+    if (last - first <= 16) {
+        for (size_type k = first; k < last; ++k) {
+            if (col_indx[k] == j) {
+                return k;
+            }
         }
+        return -1;
+    }
+    auto pos = std::lower_bound(
+        col_indx.begin() + first, col_indx.begin() + last, j);
+    if (pos != col_indx.begin() + last && *pos == j) {
+        return gsl::narrow_cast<size_type>(pos - col_indx.begin());
     }
-    return zero;
+    return -1;
 }
 
 }  // namespace srs
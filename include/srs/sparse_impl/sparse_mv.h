@@ -0,0 +1,429 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SRS_SPARSE_MV_H
+#define SRS_SPARSE_MV_H
+
+#include <srs/math_impl/backend.h>
+#include <srs/array.h>
+#include <srs/math_impl/core.h>
+#include <srs/sparse_impl/sparse_matrix.h>
+#include <srs/types.h>
+#include <algorithm>
+#include <gsl/gsl>
+#include <memory>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+namespace srs {
+
+#ifdef SRS_USE_MKL
+//
+// Handle to a double precision CSR3 matrix analyzed by the MKL
+// inspector-executor sparse BLAS. The matrix must outlive the handle.
+//
+class Mkl_sparse_handle {
+public:
+    Mkl_sparse_handle(const Sparse_matrix<double>& a, Int_t expected_calls)
+    {
+        auto& rowptr = a.row_index();
+        // clang-format off
+        sparse_status_t stat = mkl_sparse_d_create_csr(
+            &h, SPARSE_INDEX_BASE_ZERO, a.rows(), a.cols(),
+            const_cast<MKL_INT*>(rowptr.data()),
+            const_cast<MKL_INT*>(rowptr.data() + 1),
+            const_cast<MKL_INT*>(a.columns().data()),
+            const_cast<double*>(a.data()));
+        // clang-format on
+        if (stat != SPARSE_STATUS_SUCCESS) {
+            throw Math_error("mkl_sparse_d_create_csr failed");
+        }
+        descr.type = SPARSE_MATRIX_TYPE_GENERAL;
+        // clang-format off
+        mkl_sparse_set_mv_hint(
+            h, SPARSE_OPERATION_NON_TRANSPOSE, descr, expected_calls);
+        // clang-format on
+        mkl_sparse_optimize(h);
+    }
+
+    Mkl_sparse_handle(const Mkl_sparse_handle&) = delete;
+    Mkl_sparse_handle& operator=(const Mkl_sparse_handle&) = delete;
+
+    ~Mkl_sparse_handle() { mkl_sparse_destroy(h); }
+
+    // Compute y = alpha * op(a) * x + beta * y.
+    void mv(char trans, double alpha, const double* x, double beta, double* y)
+        const
+    {
+        sparse_operation_t op = ((trans == 'T') || (trans == 't'))
+                                    ? SPARSE_OPERATION_TRANSPOSE
+                                    : SPARSE_OPERATION_NON_TRANSPOSE;
+
+        sparse_status_t stat = mkl_sparse_d_mv(op, alpha, h, descr, x, beta, y);
+        if (stat != SPARSE_STATUS_SUCCESS) {
+            throw Math_error("mkl_sparse_d_mv failed");
+        }
+    }
+
+private:
+    sparse_matrix_t h;
+    matrix_descr descr;
+};
+#endif  // SRS_USE_MKL
+
+//
+// Sparse matrix-vector product engine for matrices in CSR3 format.
+//
+// The rows are split into one block per thread with roughly the same
+// number of nonzeros, which is computed once and reused for every product.
+// The inner loops keep four independent partial sums, which lets the
+// compiler vectorize the gathers from x.
+//
+// Note:
+// - The engine keeps a reference to the matrix, which must not be changed
+//   or destroyed while the engine is used.
+// - If expected_calls > 0 and the backend is Intel MKL, double precision
+//   products are handed to the inspector-executor sparse BLAS, which is
+//   told how many products to optimize for.
+// - Transposed products accumulate into one buffer of length cols() per
+//   thread, which are then summed.
+//
+template <class T>
+class Sparse_mv {
+public:
+    typedef T value_type;
+    typedef Int_t size_type;
+
+    explicit Sparse_mv(const Sparse_matrix<T>& a, size_type expected_calls = 0);
+
+    // Compute y = alpha * op(a) * x + beta * y, where op(a) = a for trans =
+    // 'N' and op(a) = a^T for trans = 'T'. If y is empty, it is resized and
+    // beta is ignored.
+    void mv(char trans,
+            const T& alpha,
+            const Array<T, 1>& x,
+            const T& beta,
+            Array<T, 1>& y) const;
+
+    // Compute c = alpha * a * b + beta * c for a dense matrix b. If c is
+    // empty, it is resized and beta is ignored.
+    void mm(const T& alpha,
+            const Array<T, 2>& b,
+            const T& beta,
+            Array<T, 2>& c) const;
+
+    // First row of each block; block t holds rows partition()[t] to
+    // partition()[t + 1] - 1.
+    const std::vector<size_type>& partition() const { return parts; }
+
+private:
+    const Sparse_matrix<T>& mat;
+    std::vector<size_type> parts;
+
+#ifdef SRS_USE_MKL
+    std::unique_ptr<Mkl_sparse_handle> handle;
+
+    template <class U>
+    static Mkl_sparse_handle* backend(const Sparse_matrix<U>&, size_type)
+    {
+        return nullptr;
+    }
+
+    static Mkl_sparse_handle* backend(const Sparse_matrix<double>& a,
+                                      size_type expected_calls)
+    {
+        if (expected_calls <= 0 || a.rows() == 0 || a.cols() == 0) {
+            return nullptr;
+        }
+        return new Mkl_sparse_handle(a, expected_calls);
+    }
+
+    template <class U>
+    static void backend_mv(const Mkl_sparse_handle&,
+                           char,
+                           const U&,
+                           const U*,
+                           const U&,
+                           U*)
+    {
+    }
+
+    static void backend_mv(const Mkl_sparse_handle& h,
+                           char trans,
+                           const double& alpha,
+                           const double* x,
+                           const double& beta,
+                           double* y)
+    {
+        h.mv(trans, alpha, x, beta, y);
+    }
+#endif
+
+    void mv_rows(size_type rfirst,
+                 size_type rlast,
+                 const T& alpha,
+                 const T* x,
+                 const T& beta,
+                 T* y) const;
+
+    void mv_trans_rows(size_type rfirst,
+                       size_type rlast,
+                       const T& alpha,
+                       const T* x,
+                       T* y) const;
+};
+
+template <class T>
+Sparse_mv<T>::Sparse_mv(const Sparse_matrix<T>& a, size_type expected_calls)
+    : mat(a), parts()
+{
+#ifdef _OPENMP
+    const size_type nparts = std::max(1, omp_get_max_threads());
+#else
+    const size_type nparts = 1;
+#endif
+    const auto& rowptr  = a.row_index();
+    const size_type nnz = a.rows() > 0 ? rowptr[a.rows()] : 0;
+
+    parts.resize(nparts + 1);
+    parts[0]      = 0;
+    parts[nparts] = a.rows();
+    for (size_type t = 1; t < nparts; ++t) {
+        // First row starting at or after t / nparts of the nonzeros.
+        size_type target = gsl::narrow_cast<size_type>(
+            static_cast<double>(nnz) * t / nparts);
+        auto pos = std::lower_bound(
+            rowptr.begin(), rowptr.begin() + a.rows(), target);
+        parts[t] = std::max(
+            parts[t - 1], gsl::narrow_cast<size_type>(pos - rowptr.begin()));
+    }
+
+#ifdef SRS_USE_MKL
+    handle.reset(backend(a, expected_calls));
+#else
+    (void) expected_calls;
+#endif
+}
+
+template <class T>
+void Sparse_mv<T>::mv(char trans,
+                      const T& alpha,
+                      const Array<T, 1>& x,
+                      const T& beta,
+                      Array<T, 1>& y) const
+{
+    const bool ta = (trans == 'T') || (trans == 't');
+
+    const size_type m = ta ? mat.cols() : mat.rows();
+    const size_type n = ta ? mat.rows() : mat.cols();
+
+    Expects(x.size() == n);
+    T b = beta;
+    if (y.empty()) {
+        y.resize(m);
+        b = T(0);
+    }
+    Expects(y.size() == m);
+    if (m == 0) {
+        return;
+    }
+
+#ifdef SRS_USE_MKL
+    if (handle) {
+        backend_mv(*handle, ta ? 'T' : 'N', alpha, x.data(), b, y.data());
+        return;
+    }
+#endif
+
+    const size_type nparts = gsl::narrow_cast<size_type>(parts.size()) - 1;
+    const T* px            = x.data();
+    T* py                  = y.data();
+
+    if (!ta) {
+#pragma omp parallel for schedule(static, 1)
+        for (size_type t = 0; t < nparts; ++t) {
+            mv_rows(parts[t], parts[t + 1], alpha, px, b, py);
+        }
+        return;
+    }
+
+    // Transposed product: scale y, then add the contributions of the
+    // blocks, using a private buffer for each block but the first.
+    for (size_type j = 0; j < m; ++j) {
+        py[j] = (b == T(0)) ? T(0) : b * py[j];
+    }
+    if (nparts == 1) {
+        mv_trans_rows(0, mat.rows(), alpha, px, py);
+        return;
+    }
+    std::vector<T> work((nparts - 1) * m, T(0));
+
+#pragma omp parallel for schedule(static, 1)
+    for (size_type t = 0; t < nparts; ++t) {
+        T* yt = (t == 0) ? py : work.data() + (t - 1) * m;
+        mv_trans_rows(parts[t], parts[t + 1], alpha, px, yt);
+    }
+
+#pragma omp parallel for schedule(static)
+    for (size_type j = 0; j < m; ++j) {
+        T sum = T(0);
+        for (size_type t = 1; t < nparts; ++t) {
+            sum += work[(t - 1) * m + j];
+        }
+        py[j] += sum;
+    }
+}
+
+template <class T>
+void Sparse_mv<T>::mm(const T& alpha,
+                      const Array<T, 2>& b,
+                      const T& beta,
+                      Array<T, 2>& c) const
+{
+    // The columns of b are processed in panels of nb columns, which are
+    // copied to a row-major buffer. Each nonzero a(i, k) then updates nb
+    // contiguous partial sums of row i of c from row k of the panel, so
+    // that the indices of a are loaded once per panel rather than once
+    // per column, and the inner loop vectorizes without gathers.
+    constexpr size_type nb = 8;
+
+    Expects(b.rows() == mat.cols());
+    T beta_ = beta;
+    if (c.empty()) {
+        c.resize(mat.rows(), b.cols());
+        beta_ = T(0);
+    }
+    Expects(c.rows() == mat.rows() && c.cols() == b.cols());
+
+    const size_type n      = b.rows();
+    const size_type m      = b.cols();
+    const size_type ldb    = b.leading_dim();
+    const size_type ldc    = c.leading_dim();
+    const size_type nparts = gsl::narrow_cast<size_type>(parts.size()) - 1;
+
+    const T* val         = mat.data();
+    const size_type* col = mat.columns().data();
+    const size_type* ptr = mat.row_index().data();
+
+    std::vector<T> panel(n * nb);
+
+    for (size_type jb = 0; jb < m; jb += nb) {
+        const size_type w = std::min(nb, m - jb);
+        const T* pb       = b.data() + jb * ldb;
+        T* pc             = c.data() + jb * ldc;
+
+#pragma omp parallel for schedule(static)
+        for (size_type k = 0; k < n; ++k) {
+            for (size_type q = 0; q < nb; ++q) {
+                panel[k * nb + q] = (q < w) ? pb[k + q * ldb] : T(0);
+            }
+        }
+
+#pragma omp parallel for schedule(static, 1)
+        for (size_type t = 0; t < nparts; ++t) {
+            T acc[nb];
+            for (size_type i = parts[t]; i < parts[t + 1]; ++i) {
+                std::fill_n(acc, nb, T(0));
+                for (size_type p = ptr[i]; p < ptr[i + 1]; ++p) {
+                    const T aik = val[p];
+                    const T* bk = panel.data() + col[p] * nb;
+                    for (size_type q = 0; q < nb; ++q) {
+                        acc[q] += aik * bk[q];
+                    }
+                }
+                for (size_type q = 0; q < w; ++q) {
+                    T& cij = pc[i + q * ldc];
+                    cij    = (beta_ == T(0)) ? alpha * acc[q]
+                                             : alpha * acc[q] + beta_ * cij;
+                }
+            }
+        }
+    }
+}
+
+template <class T>
+void Sparse_mv<T>::mv_rows(size_type rfirst,
+                           size_type rlast,
+                           const T& alpha,
+                           const T* x,
+                           const T& beta,
+                           T* y) const
+{
+    const T* val         = mat.data();
+    const size_type* col = mat.columns().data();
+    const size_type* ptr = mat.row_index().data();
+
+    for (size_type i = rfirst; i < rlast; ++i) {
+        size_type k    = ptr[i];
+        size_type kend = ptr[i + 1];
+
+        T s0 = T(0);
+        T s1 = T(0);
+        T s2 = T(0);
+        T s3 = T(0);
+        for (; k + 3 < kend; k += 4) {
+            s0 += val[k] * x[col[k]];
+            s1 += val[k + 1] * x[col[k + 1]];
+            s2 += val[k + 2] * x[col[k + 2]];
+            s3 += val[k + 3] * x[col[k + 3]];
+        }
+        for (; k < kend; ++k) {
+            s0 += val[k] * x[col[k]];
+        }
+        T sum = (s0 + s1) + (s2 + s3);
+        y[i]  = (beta == T(0)) ? alpha * sum : alpha * sum + beta * y[i];
+    }
+}
+
+template <class T>
+void Sparse_mv<T>::mv_trans_rows(
+    size_type rfirst, size_type rlast, const T& alpha, const T* x, T* y) const
+{
+    const T* val         = mat.data();
+    const size_type* col = mat.columns().data();
+    const size_type* ptr = mat.row_index().data();
+
+    for (size_type i = rfirst; i < rlast; ++i) {
+        T xi = alpha * x[i];
+        for (size_type k = ptr[i]; k < ptr[i + 1]; ++k) {
+            y[col[k]] += val[k] * xi;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Compute y = alpha * op(a) * x + beta * y for a sparse matrix, see
+// Sparse_mv. For repeated products with the same matrix, construct a
+// Sparse_mv object once instead.
+template <class T>
+inline void mv_mul(char trans,
+                   const T& alpha,
+                   const Sparse_matrix<T>& a,
+                   const Array<T, 1>& x,
+                   const T& beta,
+                   Array<T, 1>& y)
+{
+    Sparse_mv<T>(a).mv(trans, alpha, x, beta, y);
+}
+
+}  // namespace srs
+
+#endif  // SRS_SPARSE_MV_H
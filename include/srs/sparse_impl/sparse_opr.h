@@ -17,70 +17,164 @@
 #ifndef SRS_SPARSE_OPR_H
 #define SRS_SPARSE_OPR_H
 
-#include <mkl.h>
+#include <srs/math_impl/backend.h>
 #include <srs/array.h>
 #include <srs/sparse_impl/sparse_matrix.h>
+#include <srs/sparse_impl/sparse_mv.h>
 #include <srs/sparse_impl/sparse_vector.h>
+#include <algorithm>
+#include <gsl/gsl>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 namespace srs {
 
 // Convert formats:
 
-// Gather a sparse full-storage vector into compressed form.
+// Gather a sparse full-storage vector into compressed form. The vector is
+// split into one block per thread; each block counts its nonzeros, and the
+// blocks then fill their part of the result in parallel.
 template <class T>
 Sparse_vector<T> sparse_gather(const Array<T, 1>& y)
 {
     using size_type = typename Sparse_vector<T>::size_type;
 
-    std::vector<T> val;
-    std::vector<size_type> loc;
-    for (std::size_t i = 0; i < y.size(); ++i) {
-        if (y(i) != T(0)) {
-            val.push_back(y(i));
-            loc.push_back(i);
+    const size_type n = y.size();
+    const T* py       = y.data();
+
+#ifdef _OPENMP
+    const size_type nparts
+        = std::max<size_type>(1, std::min<size_type>(omp_get_max_threads(), n));
+#else
+    const size_type nparts = 1;
+#endif
+    std::vector<size_type> offset(nparts + 1, 0);
+
+#pragma omp parallel for schedule(static, 1)
+    for (size_type t = 0; t < nparts; ++t) {
+        size_type count = 0;
+        for (size_type i = t * n / nparts; i < (t + 1) * n / nparts; ++i) {
+            count += (py[i] != T(0));
+        }
+        offset[t + 1] = count;
+    }
+    for (size_type t = 0; t < nparts; ++t) {
+        offset[t + 1] += offset[t];
+    }
+
+    std::vector<T> val(offset[nparts]);
+    std::vector<size_type> loc(offset[nparts]);
+
+#pragma omp parallel for schedule(static, 1)
+    for (size_type t = 0; t < nparts; ++t) {
+        size_type pos = offset[t];
+        for (size_type i = t * n / nparts; i < (t + 1) * n / nparts; ++i) {
+            if (py[i] != T(0)) {
+                val[pos] = py[i];
+                loc[pos] = i;
+                ++pos;
+            }
         }
     }
-    return {val, loc};
+    return Sparse_vector<T>(std::move(val), std::move(loc));
 }
 
-// Gather a sparse full-storage matrix into sparse CSR3 format.
+// Gather the elements of y at the indices of x into x (gthr).
+template <class T>
+void sparse_gather(const Array<T, 1>& y, Sparse_vector<T>& x)
+{
+    using size_type = typename Sparse_vector<T>::size_type;
+
+    Expects(x.size() <= y.size());
+
+    const size_type nnz  = x.num_nonzero();
+    const size_type* idx = x.index().data();
+    const T* py          = y.data();
+    T* px                = x.data();
+
+#pragma omp simd
+    for (size_type k = 0; k < nnz; ++k) {
+        px[k] = py[idx[k]];
+    }
+}
+
+// Gather a sparse full-storage matrix into sparse CSR3 format. The rows are
+// counted and then filled in parallel.
 template <class T>
 Sparse_matrix<T> sparse_gather(const Array<T, 2>& a)
 {
     using size_type = typename Sparse_matrix<T>::size_type;
 
-    std::vector<T> elems;
-    std::vector<size_type> col_indx;
-    std::vector<size_type> row_ptr(a.rows() + 1);
-    size_type nnz = 0;
-    for (size_type i = 0; i < a.rows(); ++i) {
-        size_type inz = 0;
-        for (size_type j = 0; j < a.cols(); ++j) {
+    const size_type m = a.rows();
+    const size_type n = a.cols();
+
+    std::vector<size_type> row_ptr(m + 1, 0);
+
+#pragma omp parallel for schedule(static)
+    for (size_type i = 0; i < m; ++i) {
+        size_type count = 0;
+        for (size_type j = 0; j < n; ++j) {
+            count += (a(i, j) != T(0));
+        }
+        row_ptr[i + 1] = count;
+    }
+    for (size_type i = 0; i < m; ++i) {
+        row_ptr[i + 1] += row_ptr[i];
+    }
+
+    std::vector<T> elems(row_ptr[m]);
+    std::vector<size_type> col_indx(row_ptr[m]);
+
+#pragma omp parallel for schedule(static)
+    for (size_type i = 0; i < m; ++i) {
+        size_type pos = row_ptr[i];
+        for (size_type j = 0; j < n; ++j) {
             if (a(i, j) != T(0)) {
-                elems.push_back(a(i, j));
-                col_indx.push_back(j);
-                nnz++;
-                inz++;
+                elems[pos]    = a(i, j);
+                col_indx[pos] = j;
+                ++pos;
             }
         }
-        row_ptr[i] = nnz - inz;
     }
-    row_ptr[row_ptr.size() - 1] = nnz;
-    return {a.rows(), a.cols(), elems, col_indx, row_ptr};
+
+    return Sparse_matrix<T>(m,
+                            n,
+                            std::move(elems),
+                            std::move(col_indx),
+                            std::move(row_ptr));
 }
 
-// Scatter a sparse vector into full-storage form.
+// Scatter the elements of x into y, leaving the other elements of y
+// unchanged (sctr).
 template <class T>
-Array<T, 1> sparse_scatter(const Sparse_vector<T>& x)
+void sparse_scatter(const Sparse_vector<T>& x, Array<T, 1>& y)
 {
     using size_type = typename Sparse_vector<T>::size_type;
 
-    Array<T, 1> result(x.size());
-    for (size_type i = 0; i < result.size(); ++i) {
-        result(i) = x(i);
+    Expects(x.size() <= y.size());
+
+    const size_type nnz  = x.num_nonzero();
+    const size_type* idx = x.index().data();
+    const T* px          = x.data();
+    T* py                = y.data();
+
+    // The indices are distinct, so the stores do not conflict.
+#pragma omp simd
+    for (size_type k = 0; k < nnz; ++k) {
+        py[idx[k]] = px[k];
     }
+}
+
+// Scatter a sparse vector into full-storage form.
+template <class T>
+Array<T, 1> sparse_scatter(const Sparse_vector<T>& x)
+{
+    Array<T, 1> result(x.size(), T(0));
+    sparse_scatter(x, result);
     return result;
 }
 
@@ -90,10 +184,14 @@ Array<T, 2> sparse_scatter(const Sparse_matrix<T>& a)
 {
     using size_type = typename Sparse_matrix<T>::size_type;
 
-    Array<T, 2> result(a.rows(), a.cols());
-    for (size_type i = 0; i < result.rows(); ++i) {
-        for (size_type j = 0; j < result.cols(); ++j) {
-            result(i, j) = a(i, j);
+    const auto& val     = a.values();
+    const auto& colind  = a.columns();
+    const auto& row_ptr = a.row_index();
+
+    Array<T, 2> result(a.rows(), a.cols(), T(0));
+    for (size_type i = 0; i < a.rows(); ++i) {
+        for (size_type k = row_ptr[i]; k < row_ptr[i + 1]; ++k) {
+            result(i, colind[k]) = val[k];
         }
     }
     return result;
@@ -133,6 +231,75 @@ inline T dot(const std::vector<T>& y, const Sparse_vector<T>& x)
     return x.dot(y);
 }
 
+template <class T>
+inline T dot(const Sparse_vector<T>& x, const Sparse_vector<T>& y)
+{
+    return x.dot(y);
+}
+
+// Compute y = a * x + y in place for a sparse vector x (axpyi).
+template <class T>
+void axpyi(const T& a, const Sparse_vector<T>& x, Array<T, 1>& y)
+{
+    using size_type = typename Sparse_vector<T>::size_type;
+
+    Expects(x.size() <= y.size());
+
+    const size_type nnz  = x.num_nonzero();
+    const size_type* idx = x.index().data();
+    const T* px          = x.data();
+    T* py                = y.data();
+
+    // The indices are distinct, so the updates do not conflict.
+#pragma omp simd
+    for (size_type k = 0; k < nnz; ++k) {
+        py[idx[k]] += a * px[k];
+    }
+}
+
+// Compute alpha * x + beta * y for sparse vectors by merging the index
+// lists. The pattern of the result is the union of the patterns of x and y.
+template <class T>
+Sparse_vector<T> sparse_add(const T& alpha,
+                            const Sparse_vector<T>& x,
+                            const T& beta,
+                            const Sparse_vector<T>& y)
+{
+    using size_type = typename Sparse_vector<T>::size_type;
+
+    const size_type nx  = x.num_nonzero();
+    const size_type ny  = y.num_nonzero();
+    const size_type* ix = x.index().data();
+    const size_type* iy = y.index().data();
+    const T* vx         = x.data();
+    const T* vy         = y.data();
+
+    std::vector<T> val;
+    std::vector<size_type> loc;
+    val.reserve(nx + ny);
+    loc.reserve(nx + ny);
+
+    size_type p = 0;
+    size_type q = 0;
+    while (p < nx || q < ny) {
+        const size_type i = (p < nx) ? ix[p] : iy[q] + 1;
+        const size_type j = (q < ny) ? iy[q] : ix[p] + 1;
+        if (i < j) {
+            val.push_back(alpha * vx[p++]);
+            loc.push_back(i);
+        }
+        else if (j < i) {
+            val.push_back(beta * vy[q++]);
+            loc.push_back(j);
+        }
+        else {
+            val.push_back(alpha * vx[p++] + beta * vy[q++]);
+            loc.push_back(i);
+        }
+    }
+    return Sparse_vector<T>(std::move(val), std::move(loc));
+}
+
 //------------------------------------------------------------------------------
 
 // Scalar multiplication:
@@ -172,35 +339,26 @@ Sparse_matrix<T> operator*(const T& scalar, const Sparse_matrix<T>& a)
 template <class T>
 Array<T, 1> operator+(const Sparse_vector<T>& x, const Array<T, 1>& y)
 {
-    Expects(x.size() <= y.size());
-
-    using size_type = typename Sparse_vector<T>::size_type;
-
     Array<T, 1> result(y);
-    size_type i = 0;
-    for (const auto& v : x) {
-        result(x.loc(i)) += v;
-        ++i;
-    }
+    axpyi(T(1), x, result);
     return result;
 }
 
 template <class T>
 Array<T, 1> operator+(const Array<T, 1>& y, const Sparse_vector<T>& x)
 {
-    Expects(x.size() <= y.size());
-
-    using size_type = typename Sparse_vector<T>::size_type;
-
     Array<T, 1> result(y);
-    size_type i = 0;
-    for (const auto& v : x) {
-        result(x.loc(i)) += v;
-        ++i;
-    }
+    axpyi(T(1), x, result);
     return result;
 }
 
+template <class T>
+inline Sparse_vector<T> operator+(const Sparse_vector<T>& x,
+                                  const Sparse_vector<T>& y)
+{
+    return sparse_add(T(1), x, T(1), y);
+}
+
 //------------------------------------------------------------------------------
 
 // Vector subtraction:
@@ -208,35 +366,27 @@ Array<T, 1> operator+(const Array<T, 1>& y, const Sparse_vector<T>& x)
 template <class T>
 Array<T, 1> operator-(const Sparse_vector<T>& x, const Array<T, 1>& y)
 {
-    Expects(x.size() <= y.size());
-
-    using size_type = typename Sparse_vector<T>::size_type;
-
     Array<T, 1> result(y);
-    size_type i = 0;
-    for (const auto& v : x) {
-        result(x.loc(i)) -= v;
-        ++i;
-    }
+    result *= T(-1);
+    axpyi(T(1), x, result);
     return result;
 }
 
 template <class T>
 Array<T, 1> operator-(const Array<T, 1>& y, const Sparse_vector<T>& x)
 {
-    Expects(x.size() <= y.size());
-
-    using size_type = typename Sparse_vector<T>::size_type;
-
     Array<T, 1> result(y);
-    size_type i = 0;
-    for (const auto& v : x) {
-        result(x.loc(i)) -= v;
-        ++i;
-    }
+    axpyi(T(-1), x, result);
     return result;
 }
 
+template <class T>
+inline Sparse_vector<T> operator-(const Sparse_vector<T>& x,
+                                  const Sparse_vector<T>& y)
+{
+    return sparse_add(T(1), x, T(-1), y);
+}
+
 //------------------------------------------------------------------------------
 
 // Matrix-vector product of a sparse matrix.
@@ -244,30 +394,314 @@ template <class T>
 inline Array<T, 1> operator*(const Sparse_matrix<T>& a, const Array<T, 1>& x)
 {
     Expects(x.size() == a.cols());
-    Array<T, 1> result(a.cols());
+    Array<T, 1> result(a.rows());
     mv_mul(a, x, result);
     return result;
 }
 
-// Matrix-vector product of a sparse matrix.
+// Matrix-vector product of a sparse matrix, see Sparse_mv.
 template <class T>
 void mv_mul(const Sparse_matrix<T>& a,
             const Array<T, 1>& x,
             Array<T, 1>& result)
 {
     Expects(x.size() == a.cols());
+    result.resize(a.rows());
+    Sparse_mv<T>(a).mv('N', T(1), x, T(0), result);
+}
 
-    using size_type = typename Array<T, 1>::size_type;
+//------------------------------------------------------------------------------
 
-    result.resize(a.cols());
+// Matrix-matrix product of a sparse and a dense matrix (SpMM), see
+// Sparse_mv::mm(). Computes c = a * b for all columns of b at once, which
+// is faster than one mv_mul() per column.
+template <class T>
+void mm_mul(const Sparse_matrix<T>& a, const Array<T, 2>& b, Array<T, 2>& c)
+{
+    Expects(b.rows() == a.cols());
+    c.resize(a.rows(), b.cols());
+    Sparse_mv<T>(a).mm(T(1), b, T(0), c);
+}
 
-    for (size_type i = 0; i < a.rows(); ++i) {
-        T sum = T(0);
-        for (size_type j = a.row_index()[i]; j < a.row_index()[i + 1]; ++j) {
-            sum += a.values()[j] * x(a.columns()[j]);
+template <class T>
+inline Array<T, 2> operator*(const Sparse_matrix<T>& a, const Array<T, 2>& b)
+{
+    Array<T, 2> result;
+    mm_mul(a, b, result);
+    return result;
+}
+
+// Matrix transpose:
+
+// Transpose of a sparse matrix, which is also the conversion between CSR
+// and CSC formats. Requires O(nnz) operations. The rows are split into one
+// block per thread; each block counts its column indices, and the blocks
+// then scatter their elements in parallel, so that the row indices of each
+// column of a remain sorted.
+template <class T>
+Sparse_matrix<T> transpose(const Sparse_matrix<T>& a)
+{
+    using size_type = typename Sparse_matrix<T>::size_type;
+
+    const size_type m = a.rows();
+    const size_type n = a.cols();
+    if (m == 0) {
+        return Sparse_matrix<T>(n, m, 0);
+    }
+    const auto& val = a.values();
+    const auto& col = a.columns();
+    const auto& ptr = a.row_index();
+
+#ifdef _OPENMP
+    const size_type nparts = std::min<size_type>(omp_get_max_threads(), m);
+#else
+    const size_type nparts = 1;
+#endif
+    // Counts of each column index in each block, stored column by column,
+    // and turned into offsets by a prefix sum in that order.
+    std::vector<size_type> offset(n * nparts + 1, 0);
+
+#pragma omp parallel for schedule(static, 1)
+    for (size_type t = 0; t < nparts; ++t) {
+        const size_type ifirst = t * m / nparts;
+        const size_type ilast  = (t + 1) * m / nparts;
+        for (size_type k = ptr[ifirst]; k < ptr[ilast]; ++k) {
+            ++offset[col[k] * nparts + t + 1];
+        }
+    }
+    for (size_type p = 0; p < n * nparts; ++p) {
+        offset[p + 1] += offset[p];
+    }
+    std::vector<size_type> col_ptr(n + 1);
+    for (size_type j = 0; j <= n; ++j) {
+        col_ptr[j] = offset[j * nparts];
+    }
+
+    std::vector<T> elems(val.size());
+    std::vector<size_type> row_indx(val.size());
+
+#pragma omp parallel for schedule(static, 1)
+    for (size_type t = 0; t < nparts; ++t) {
+        const size_type ifirst = t * m / nparts;
+        const size_type ilast  = (t + 1) * m / nparts;
+        for (size_type i = ifirst; i < ilast; ++i) {
+            for (size_type k = ptr[i]; k < ptr[i + 1]; ++k) {
+                size_type pos = offset[col[k] * nparts + t]++;
+                elems[pos]    = val[k];
+                row_indx[pos] = i;
+            }
+        }
+    }
+
+    return Sparse_matrix<T>(n,
+                            m,
+                            std::move(elems),
+                            std::move(row_indx),
+                            std::move(col_ptr));
+}
+
+//------------------------------------------------------------------------------
+
+// Matrix addition:
+
+// Compute alpha * a + beta * b. The sparsity pattern of the result is the
+// union of the patterns of a and b.
+template <class T>
+Sparse_matrix<T> sparse_add(const T& alpha,
+                            const Sparse_matrix<T>& a,
+                            const T& beta,
+                            const Sparse_matrix<T>& b)
+{
+    using size_type = typename Sparse_matrix<T>::size_type;
+
+    Expects(a.rows() == b.rows() && a.cols() == b.cols());
+
+    const size_type m = a.rows();
+    const auto& acol  = a.columns();
+    const auto& aptr  = a.row_index();
+    const auto& bcol  = b.columns();
+    const auto& bptr  = b.row_index();
+
+    // Merge the sorted column indices of each row; the first pass only
+    // counts, the second pass fills in the elements.
+    std::vector<size_type> row_ptr(m + 1, 0);
+
+#pragma omp parallel for schedule(static)
+    for (size_type i = 0; i < m; ++i) {
+        size_type p   = aptr[i];
+        size_type q   = bptr[i];
+        size_type cnt = 0;
+        while (p < aptr[i + 1] || q < bptr[i + 1]) {
+            if (q == bptr[i + 1]
+                || (p < aptr[i + 1] && acol[p] < bcol[q])) {
+                ++p;
+            }
+            else if (p == aptr[i + 1] || bcol[q] < acol[p]) {
+                ++q;
+            }
+            else {
+                ++p;
+                ++q;
+            }
+            ++cnt;
+        }
+        row_ptr[i + 1] = cnt;
+    }
+    for (size_type i = 0; i < m; ++i) {
+        row_ptr[i + 1] += row_ptr[i];
+    }
+
+    const auto& aval = a.values();
+    const auto& bval = b.values();
+    std::vector<T> elems(row_ptr[m]);
+    std::vector<size_type> col_indx(row_ptr[m]);
+
+#pragma omp parallel for schedule(static)
+    for (size_type i = 0; i < m; ++i) {
+        size_type p = aptr[i];
+        size_type q = bptr[i];
+        size_type k = row_ptr[i];
+        while (p < aptr[i + 1] || q < bptr[i + 1]) {
+            if (q == bptr[i + 1]
+                || (p < aptr[i + 1] && acol[p] < bcol[q])) {
+                col_indx[k] = acol[p];
+                elems[k]    = alpha * aval[p++];
+            }
+            else if (p == aptr[i + 1] || bcol[q] < acol[p]) {
+                col_indx[k] = bcol[q];
+                elems[k]    = beta * bval[q++];
+            }
+            else {
+                col_indx[k] = acol[p];
+                elems[k]    = alpha * aval[p++] + beta * bval[q++];
+            }
+            ++k;
+        }
+    }
+    return Sparse_matrix<T>(m,
+                            a.cols(),
+                            std::move(elems),
+                            std::move(col_indx),
+                            std::move(row_ptr));
+}
+
+template <class T>
+inline Sparse_matrix<T> operator+(const Sparse_matrix<T>& a,
+                                  const Sparse_matrix<T>& b)
+{
+    return sparse_add(T(1), a, T(1), b);
+}
+
+template <class T>
+inline Sparse_matrix<T> operator-(const Sparse_matrix<T>& a,
+                                  const Sparse_matrix<T>& b)
+{
+    return sparse_add(T(1), a, T(-1), b);
+}
+
+//------------------------------------------------------------------------------
+
+// Matrix-matrix product of sparse matrices:
+
+// Compute c = a * b (SpGEMM) in two phases. The symbolic phase counts the
+// nonzeros of each row of c, and the numeric phase accumulates each row in
+// a dense sparse accumulator (SPA) of length b.cols(), one per thread.
+// Both phases are parallel over the rows of a. Requires
+// O(flops + nnz(c) log(nnz(c) / rows)) operations, the log term coming
+// from sorting the column indices of each row.
+template <class T>
+void mm_mul(const Sparse_matrix<T>& a,
+            const Sparse_matrix<T>& b,
+            Sparse_matrix<T>& c)
+{
+    using size_type = typename Sparse_matrix<T>::size_type;
+
+    Expects(a.cols() == b.rows());
+
+    const size_type m = a.rows();
+    const size_type n = b.cols();
+    const auto& acol  = a.columns();
+    const auto& aptr  = a.row_index();
+    const auto& aval  = a.values();
+    const auto& bcol  = b.columns();
+    const auto& bptr  = b.row_index();
+    const auto& bval  = b.values();
+
+    std::vector<size_type> row_ptr(m + 1, 0);
+
+    // Symbolic phase.
+#pragma omp parallel
+    {
+        std::vector<size_type> mark(n, -1);
+
+#pragma omp for schedule(dynamic, 64)
+        for (size_type i = 0; i < m; ++i) {
+            size_type cnt = 0;
+            for (size_type p = aptr[i]; p < aptr[i + 1]; ++p) {
+                const size_type k = acol[p];
+                for (size_type q = bptr[k]; q < bptr[k + 1]; ++q) {
+                    if (mark[bcol[q]] != i) {
+                        mark[bcol[q]] = i;
+                        ++cnt;
+                    }
+                }
+            }
+            row_ptr[i + 1] = cnt;
+        }
+    }
+    for (size_type i = 0; i < m; ++i) {
+        row_ptr[i + 1] += row_ptr[i];
+    }
+
+    std::vector<T> elems(row_ptr[m]);
+    std::vector<size_type> col_indx(row_ptr[m]);
+
+    // Numeric phase.
+#pragma omp parallel
+    {
+        std::vector<size_type> mark(n, -1);
+        std::vector<T> spa(n, T(0));
+
+#pragma omp for schedule(dynamic, 64)
+        for (size_type i = 0; i < m; ++i) {
+            const size_type first = row_ptr[i];
+            size_type last        = first;
+            for (size_type p = aptr[i]; p < aptr[i + 1]; ++p) {
+                const size_type k = acol[p];
+                const T aik       = aval[p];
+                for (size_type q = bptr[k]; q < bptr[k + 1]; ++q) {
+                    const size_type j = bcol[q];
+                    if (mark[j] != i) {
+                        mark[j]          = i;
+                        spa[j]           = aik * bval[q];
+                        col_indx[last++] = j;
+                    }
+                    else {
+                        spa[j] += aik * bval[q];
+                    }
+                }
+            }
+            std::sort(col_indx.begin() + first, col_indx.begin() + last);
+            for (size_type k = first; k < last; ++k) {
+                elems[k] = spa[col_indx[k]];
+            }
         }
-        result(i) = sum;
     }
+
+    c = Sparse_matrix<T>(m,
+                         n,
+                         std::move(elems),
+                         std::move(col_indx),
+                         std::move(row_ptr));
+}
+
+template <class T>
+inline Sparse_matrix<T> operator*(const Sparse_matrix<T>& a,
+                                  const Sparse_matrix<T>& b)
+{
+    Sparse_matrix<T> result;
+    mm_mul(a, b, result);
+    return result;
 }
 
 }  // namespace srs
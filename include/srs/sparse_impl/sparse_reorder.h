@@ -0,0 +1,658 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SRS_SPARSE_REORDER_H
+#define SRS_SPARSE_REORDER_H
+
+#include <srs/array.h>
+#include <srs/band.h>
+#include <srs/sparse_impl/sparse_matrix.h>
+#include <srs/types.h>
+#include <algorithm>
+#include <array>
+#include <gsl/gsl>
+#include <numeric>
+#include <set>
+#include <utility>
+#include <vector>
+
+
+namespace srs {
+
+//
+// Adjacency graph of the symmetric sparsity pattern of a + a^T, without
+// self-loops, and fill- and bandwidth-reducing orderings computed on it.
+//
+// Note:
+// - An ordering is returned as a permutation perm, where perm[k] is the
+//   original index of the row and column at position k; see permute().
+// - rcm() is the reverse Cuthill-McKee ordering started from
+//   pseudo-peripheral vertices. It reduces the bandwidth and profile, which
+//   improves the locality of x in SpMV and allows conversion to band
+//   storage.
+// - amd() is a minimum degree ordering on the quotient graph using the
+//   approximate external degrees and element absorption of Amestoy, Davis
+//   and Duff, but without supervariable detection. It reduces the fill of
+//   sparse Cholesky and LU factorizations.
+// - nested_dissection() recursively splits the graph by level-structure
+//   separators and orders the separators last. It gives less fill than
+//   amd() on 2-D and 3-D meshes, and independent subtrees for parallel
+//   factorization.
+//
+class Sparse_graph {
+public:
+    typedef Int_t size_type;
+
+    Sparse_graph() : ptr(1, 0), adj() {}
+
+    template <class T>
+    explicit Sparse_graph(const Sparse_matrix<T>& a);
+
+    size_type num_vertices() const { return ptr.size() - 1; }
+    size_type num_edges() const { return adj.size() / 2; }
+    size_type degree(size_type v) const { return ptr[v + 1] - ptr[v]; }
+
+    // Access underlying arrays; the neighbours of v are adjacency()[k] for
+    // index()[v] <= k < index()[v + 1], in ascending order.
+    const auto& index() const { return ptr; }
+    const auto& adjacency() const { return adj; }
+
+    // Orderings:
+
+    std::vector<size_type> rcm() const;
+    std::vector<size_type> amd() const;
+
+    // Subgraphs with at most leaf_size vertices are not split further.
+    std::vector<size_type> nested_dissection(size_type leaf_size = 64) const;
+
+private:
+    std::vector<size_type> ptr;
+    std::vector<size_type> adj;
+
+    // Work arrays for breadth-first searches. A vertex is visited by the
+    // current search if seen[v] == stamp, so that the arrays need not be
+    // cleared between searches.
+    struct Workspace {
+        explicit Workspace(size_type n)
+            : order(), level_ptr(), seen(n, 0), stamp{0}
+        {
+        }
+        std::vector<size_type> order;      // vertices by level
+        std::vector<size_type> level_ptr;  // start of each level in order
+        std::vector<size_type> seen;
+        size_type stamp;
+    };
+
+    // Rooted level structure of the subgraph of vertices v with
+    // part[v] == id. Returns the number of levels.
+    size_type level_structure(size_type root,
+                              const std::vector<size_type>& part,
+                              size_type id,
+                              Workspace& ws) const;
+
+    // Pseudo-peripheral vertex of the component containing v, found by the
+    // algorithm of Gibbs, Poole and Stockmeyer as modified by George and
+    // Liu. On exit, ws holds the level structure rooted at the vertex.
+    size_type pseudo_peripheral(size_type v,
+                                const std::vector<size_type>& part,
+                                size_type id,
+                                Workspace& ws) const;
+};
+
+template <class T>
+Sparse_graph::Sparse_graph(const Sparse_matrix<T>& a) : ptr(), adj()
+{
+    Expects(a.rows() == a.cols());
+
+    const size_type n = a.rows();
+    const auto& col   = a.columns();
+    const auto& rptr  = a.row_index();
+
+    // Insert each off-diagonal element (i, j) as the edges i -> j and
+    // j -> i, and then remove the duplicates due to symmetric elements.
+    std::vector<size_type> pos(n + 1, 0);
+    for (size_type i = 0; i < n; ++i) {
+        for (size_type k = rptr[i]; k < rptr[i + 1]; ++k) {
+            if (col[k] != i) {
+                ++pos[i + 1];
+                ++pos[col[k] + 1];
+            }
+        }
+    }
+    std::partial_sum(pos.begin(), pos.end(), pos.begin());
+
+    std::vector<size_type> edges(pos[n]);
+    std::vector<size_type> next(pos.begin(), pos.end() - 1);
+    for (size_type i = 0; i < n; ++i) {
+        for (size_type k = rptr[i]; k < rptr[i + 1]; ++k) {
+            const size_type j = col[k];
+            if (j != i) {
+                edges[next[i]++] = j;
+                edges[next[j]++] = i;
+            }
+        }
+    }
+
+    std::vector<size_type> len(n);
+#pragma omp parallel for schedule(dynamic, 256)
+    for (size_type v = 0; v < n; ++v) {
+        auto first = edges.begin() + pos[v];
+        auto last  = edges.begin() + pos[v + 1];
+        std::sort(first, last);
+        len[v] = gsl::narrow_cast<size_type>(std::unique(first, last) - first);
+    }
+
+    ptr.assign(n + 1, 0);
+    for (size_type v = 0; v < n; ++v) {
+        ptr[v + 1] = ptr[v] + len[v];
+    }
+    adj.resize(ptr[n]);
+    for (size_type v = 0; v < n; ++v) {
+        std::copy_n(edges.begin() + pos[v], len[v], adj.begin() + ptr[v]);
+    }
+}
+
+inline Int_t Sparse_graph::level_structure(size_type root,
+                                           const std::vector<size_type>& part,
+                                           size_type id,
+                                           Workspace& ws) const
+{
+    ++ws.stamp;
+    ws.order.clear();
+    ws.level_ptr.assign(1, 0);
+
+    ws.order.push_back(root);
+    ws.seen[root] = ws.stamp;
+
+    size_type first = 0;
+    while (first < static_cast<size_type>(ws.order.size())) {
+        const size_type last = ws.order.size();
+        ws.level_ptr.push_back(last);
+        for (size_type k = first; k < last; ++k) {
+            const size_type v = ws.order[k];
+            for (size_type p = ptr[v]; p < ptr[v + 1]; ++p) {
+                const size_type u = adj[p];
+                if (part[u] == id && ws.seen[u] != ws.stamp) {
+                    ws.seen[u] = ws.stamp;
+                    ws.order.push_back(u);
+                }
+            }
+        }
+        first = last;
+    }
+    return ws.level_ptr.size() - 1;
+}
+
+inline Int_t Sparse_graph::pseudo_peripheral(size_type v,
+                                             const std::vector<size_type>& part,
+                                             size_type id,
+                                             Workspace& ws) const
+{
+    size_type root = v;
+    size_type nlev = level_structure(root, part, id, ws);
+    while (true) {
+        // Vertex of minimum degree in the last level:
+        size_type u = ws.order[ws.level_ptr[nlev - 1]];
+        for (size_type k = ws.level_ptr[nlev - 1]; k < ws.level_ptr[nlev];
+             ++k) {
+            if (degree(ws.order[k]) < degree(u)) {
+                u = ws.order[k];
+            }
+        }
+        // The eccentricity of u is at least nlev - 1, so the search stops
+        // when it does not increase.
+        const size_type nlev_u = level_structure(u, part, id, ws);
+        if (nlev_u <= nlev) {
+            return u;
+        }
+        root = u;
+        nlev = nlev_u;
+    }
+}
+
+inline std::vector<Int_t> Sparse_graph::rcm() const
+{
+    const size_type n = num_vertices();
+
+    std::vector<size_type> perm;
+    perm.reserve(n);
+    std::vector<size_type> part(n, 0);
+    std::vector<char> numbered(n, 0);
+    Workspace ws(n);
+
+    auto by_degree = [&](size_type u, size_type w) {
+        return degree(u) < degree(w) || (degree(u) == degree(w) && u < w);
+    };
+
+    // Cuthill-McKee ordering of each connected component, numbering the
+    // neighbours of each vertex by increasing degree:
+    for (size_type v = 0; v < n; ++v) {
+        if (numbered[v]) {
+            continue;
+        }
+        const size_type root = pseudo_peripheral(v, part, 0, ws);
+        perm.push_back(root);
+        numbered[root] = 1;
+        for (size_type k = perm.size() - 1;
+             k < static_cast<size_type>(perm.size());
+             ++k) {
+            const size_type u     = perm[k];
+            const size_type first = perm.size();
+            for (size_type p = ptr[u]; p < ptr[u + 1]; ++p) {
+                if (!numbered[adj[p]]) {
+                    numbered[adj[p]] = 1;
+                    perm.push_back(adj[p]);
+                }
+            }
+            std::sort(perm.begin() + first, perm.end(), by_degree);
+        }
+    }
+    std::reverse(perm.begin(), perm.end());
+    return perm;
+}
+
+inline std::vector<Int_t> Sparse_graph::amd() const
+{
+    const size_type n = num_vertices();
+
+    // Quotient graph: a variable i is adjacent to the variables vars[i]
+    // and the elements elts[i]; an element e (an eliminated variable) holds
+    // the variables vars[e] of its clique.
+    enum { variable, element, absorbed };
+
+    std::vector<std::vector<size_type>> vars(n);
+    std::vector<std::vector<size_type>> elts(n);
+    std::vector<char> status(n, variable);
+    std::vector<size_type> deg(n);
+    std::vector<size_type> mark(n, -1);
+    std::vector<size_type> wmark(n, -1);
+    std::vector<size_type> w(n);
+
+    std::set<std::pair<size_type, size_type>> queue;
+    for (size_type i = 0; i < n; ++i) {
+        vars[i].assign(adj.begin() + ptr[i], adj.begin() + ptr[i + 1]);
+        deg[i] = degree(i);
+        queue.emplace(deg[i], i);
+    }
+
+    std::vector<size_type> perm;
+    perm.reserve(n);
+    std::vector<size_type> lp;
+
+    for (size_type k = 0; k < n; ++k) {
+        const size_type p = queue.begin()->second;
+        queue.erase(queue.begin());
+        perm.push_back(p);
+
+        // Form the new element p from the variables adjacent to p, and
+        // absorb the elements adjacent to p:
+        lp.clear();
+        mark[p] = k;
+        for (auto i : vars[p]) {
+            if (mark[i] != k) {
+                mark[i] = k;
+                lp.push_back(i);
+            }
+        }
+        for (auto e : elts[p]) {
+            if (status[e] != element) {
+                continue;
+            }
+            for (auto i : vars[e]) {
+                if (status[i] == variable && mark[i] != k) {
+                    mark[i] = k;
+                    lp.push_back(i);
+                }
+            }
+            status[e] = absorbed;
+            std::vector<size_type>().swap(vars[e]);
+        }
+        vars[p] = lp;
+        std::vector<size_type>().swap(elts[p]);
+        status[p] = element;
+
+        // Prune the variables in lp, which are now reached through p, and
+        // compute w[e] = |vars[e] \ lp| for the other elements adjacent to
+        // the variables in lp:
+        for (auto i : lp) {
+            auto& vi = vars[i];
+            vi.erase(std::remove_if(vi.begin(),
+                                    vi.end(),
+                                    [&](size_type j) { return mark[j] == k; }),
+                     vi.end());
+            auto& ei = elts[i];
+            ei.erase(std::remove_if(ei.begin(),
+                                    ei.end(),
+                                    [&](size_type e) {
+                                        return status[e] != element;
+                                    }),
+                     ei.end());
+            for (auto e : ei) {
+                if (wmark[e] != k) {
+                    wmark[e] = k;
+                    w[e]     = vars[e].size();
+                }
+                --w[e];
+            }
+        }
+
+        // Approximate external degrees; elements whose variables all lie
+        // in lp are absorbed into p:
+        const size_type lp_size   = lp.size();
+        const size_type remaining = n - k - 1;
+        for (auto i : lp) {
+            size_type d = vars[i].size() + lp_size - 1;
+            auto& ei    = elts[i];
+            size_type m = 0;
+            for (auto e : ei) {
+                if (w[e] == 0) {
+                    status[e] = absorbed;
+                }
+                else {
+                    d += w[e];
+                    ei[m++] = e;
+                }
+            }
+            ei.resize(m);
+            ei.push_back(p);
+
+            d = std::min({d, deg[i] + lp_size - 1, remaining});
+            queue.erase(std::make_pair(deg[i], i));
+            deg[i] = d;
+            queue.emplace(deg[i], i);
+        }
+    }
+    return perm;
+}
+
+inline std::vector<Int_t>
+Sparse_graph::nested_dissection(size_type leaf_size) const
+{
+    const size_type n = num_vertices();
+
+    // Subgraph with its vertices, to be ordered at positions first,
+    // first + 1, ... of perm.
+    struct Subgraph {
+        std::vector<size_type> verts;
+        size_type first;
+    };
+
+    std::vector<size_type> perm(n);
+    std::vector<size_type> part(n, 0);
+    std::vector<size_type> level(n);
+    Workspace ws(n);
+
+    std::vector<Subgraph> stack;
+    if (n > 0) {
+        std::vector<size_type> all(n);
+        std::iota(all.begin(), all.end(), 0);
+        stack.push_back({std::move(all), 0});
+    }
+
+    size_type id = 0;
+    while (!stack.empty()) {
+        Subgraph g = std::move(stack.back());
+        stack.pop_back();
+
+        ++id;
+        for (auto v : g.verts) {
+            part[v] = id;
+        }
+        pseudo_peripheral(g.verts[0], part, id, ws);
+        const size_type nlev = ws.level_ptr.size() - 1;
+        const size_type size = g.verts.size();
+
+        // Split a disconnected subgraph into the component found by the
+        // search and the remaining vertices:
+        if (static_cast<size_type>(ws.order.size()) < size) {
+            std::vector<size_type> rest;
+            rest.reserve(size - ws.order.size());
+            for (auto v : g.verts) {
+                if (ws.seen[v] != ws.stamp) {
+                    rest.push_back(v);
+                }
+            }
+            const size_type first = g.first + ws.order.size();
+            stack.push_back({std::move(rest), first});
+            stack.push_back({ws.order, g.first});
+            continue;
+        }
+
+        // Small or nearly complete subgraphs are numbered in breadth-first
+        // order, which keeps neighbours close:
+        if (size <= leaf_size || nlev < 3) {
+            std::copy(ws.order.begin(), ws.order.end(), perm.begin() + g.first);
+            continue;
+        }
+
+        // The separator is the middle level, less the vertices without
+        // neighbours in the next level, which are moved to the first part:
+        for (size_type l = 0; l < nlev; ++l) {
+            for (size_type k = ws.level_ptr[l]; k < ws.level_ptr[l + 1]; ++k) {
+                level[ws.order[k]] = l;
+            }
+        }
+        const size_type mid = nlev / 2;
+
+        std::vector<size_type> a;
+        std::vector<size_type> b;
+        std::vector<size_type> sep;
+        for (auto v : ws.order) {
+            if (level[v] < mid) {
+                a.push_back(v);
+            }
+            else if (level[v] > mid) {
+                b.push_back(v);
+            }
+            else {
+                bool cut = false;
+                for (size_type p = ptr[v]; p < ptr[v + 1]; ++p) {
+                    if (part[adj[p]] == id && level[adj[p]] == mid + 1) {
+                        cut = true;
+                        break;
+                    }
+                }
+                if (cut) {
+                    sep.push_back(v);
+                }
+                else {
+                    a.push_back(v);
+                }
+            }
+        }
+
+        const size_type first_sep = g.first + size - sep.size();
+        std::copy(sep.begin(), sep.end(), perm.begin() + first_sep);
+        const size_type first_b = g.first + a.size();
+        stack.push_back({std::move(b), first_b});
+        stack.push_back({std::move(a), g.first});
+    }
+    return perm;
+}
+
+//------------------------------------------------------------------------------
+
+// Orderings of a square sparse matrix, see Sparse_graph.
+
+template <class T>
+inline std::vector<Int_t> rcm(const Sparse_matrix<T>& a)
+{
+    return Sparse_graph(a).rcm();
+}
+
+template <class T>
+inline std::vector<Int_t> amd(const Sparse_matrix<T>& a)
+{
+    return Sparse_graph(a).amd();
+}
+
+template <class T>
+inline std::vector<Int_t> nested_dissection(const Sparse_matrix<T>& a,
+                                            Int_t leaf_size = 64)
+{
+    return Sparse_graph(a).nested_dissection(leaf_size);
+}
+
+// Inverse of a permutation, iperm[perm[k]] = k.
+inline std::vector<Int_t> inverse_permutation(const std::vector<Int_t>& perm)
+{
+    std::vector<Int_t> iperm(perm.size());
+    for (std::size_t k = 0; k < perm.size(); ++k) {
+        iperm[perm[k]] = gsl::narrow_cast<Int_t>(k);
+    }
+    return iperm;
+}
+
+//------------------------------------------------------------------------------
+
+// Permutations:
+
+// Symmetric permutation b = p * a * p^T of a square matrix, that is,
+// b(k, l) = a(perm[k], perm[l]). Requires O(nnz) operations plus sorting
+// the column indices of each row.
+template <class T>
+Sparse_matrix<T> permute(const Sparse_matrix<T>& a,
+                         const std::vector<Int_t>& perm)
+{
+    using size_type = typename Sparse_matrix<T>::size_type;
+
+    Expects(a.rows() == a.cols());
+    Expects(perm.size() == gsl::narrow_cast<std::size_t>(a.rows()));
+
+    const size_type n = a.rows();
+    const auto& val   = a.values();
+    const auto& col   = a.columns();
+    const auto& ptr   = a.row_index();
+
+    const std::vector<size_type> iperm = inverse_permutation(perm);
+
+    std::vector<size_type> row_ptr(n + 1, 0);
+    for (size_type k = 0; k < n; ++k) {
+        row_ptr[k + 1] = row_ptr[k] + ptr[perm[k] + 1] - ptr[perm[k]];
+    }
+    std::vector<T> elems(val.size());
+    std::vector<size_type> col_indx(val.size());
+
+#pragma omp parallel
+    {
+        std::vector<std::pair<size_type, T>> row;
+#pragma omp for schedule(static)
+        for (size_type k = 0; k < n; ++k) {
+            const size_type i = perm[k];
+            row.clear();
+            for (size_type p = ptr[i]; p < ptr[i + 1]; ++p) {
+                row.emplace_back(iperm[col[p]], val[p]);
+            }
+            std::sort(row.begin(),
+                      row.end(),
+                      [](const auto& x, const auto& y) {
+                          return x.first < y.first;
+                      });
+            size_type q = row_ptr[k];
+            for (const auto& x : row) {
+                col_indx[q] = x.first;
+                elems[q]    = x.second;
+                ++q;
+            }
+        }
+    }
+
+    return Sparse_matrix<T>(n,
+                            n,
+                            std::move(elems),
+                            std::move(col_indx),
+                            std::move(row_ptr));
+}
+
+// Permute a vector, y(k) = x(perm[k]). Use this on the right-hand side of
+// a * x = b before solving with permute(a, perm).
+template <class T>
+Array<T, 1> permute(const Array<T, 1>& x, const std::vector<Int_t>& perm)
+{
+    Expects(perm.size() == gsl::narrow_cast<std::size_t>(x.size()));
+    const Int_t n = x.size();
+    Array<T, 1> y(n);
+    for (Int_t k = 0; k < n; ++k) {
+        y(k) = x(perm[k]);
+    }
+    return y;
+}
+
+// Undo a permutation, y(perm[k]) = x(k). Use this on the solution of the
+// permuted system.
+template <class T>
+Array<T, 1> inverse_permute(const Array<T, 1>& x,
+                            const std::vector<Int_t>& perm)
+{
+    Expects(perm.size() == gsl::narrow_cast<std::size_t>(x.size()));
+    const Int_t n = x.size();
+    Array<T, 1> y(n);
+    for (Int_t k = 0; k < n; ++k) {
+        y(perm[k]) = x(k);
+    }
+    return y;
+}
+
+//------------------------------------------------------------------------------
+
+// Conversion to band storage:
+
+// Lower and upper bandwidth {kl, ku} of a sparse matrix.
+template <class T>
+std::array<Int_t, 2> bandwidth(const Sparse_matrix<T>& a)
+{
+    const auto& col = a.columns();
+    const auto& ptr = a.row_index();
+
+    std::array<Int_t, 2> bw = {0, 0};
+    for (Int_t i = 0; i < a.rows(); ++i) {
+        if (ptr[i] < ptr[i + 1]) {
+            bw[0] = std::max(bw[0], i - col[ptr[i]]);
+            bw[1] = std::max(bw[1], col[ptr[i + 1] - 1] - i);
+        }
+    }
+    return bw;
+}
+
+// Convert a sparse matrix to band storage with the bandwidth of a. This
+// pays off after a bandwidth-reducing ordering, e.g.
+//
+//   auto b  = permute(a, rcm(a));
+//   auto bw = bandwidth(b);
+//   if (bw[0] + bw[1] < max_width) {
+//       auto ab = to_band(b);
+//   }
+//
+template <class T>
+Band_matrix<T> to_band(const Sparse_matrix<T>& a)
+{
+    const auto bw   = bandwidth(a);
+    const auto& val = a.values();
+    const auto& col = a.columns();
+    const auto& ptr = a.row_index();
+
+    Band_matrix<T> ab(a.rows(), a.cols(), bw[0], bw[1]);
+    for (Int_t i = 0; i < a.rows(); ++i) {
+        for (Int_t k = ptr[i]; k < ptr[i + 1]; ++k) {
+            ab(i, col[k]) = val[k];
+        }
+    }
+    return ab;
+}
+
+}  // namespace srs
+
+#endif  // SRS_SPARSE_REORDER_H
@@ -37,7 +37,7 @@ namespace srs {
 // - It is assumed that the sparse vector is initialized with element indices
 //   sorted in ascending order.
 // - New elements are inserted so that the index order is preserved.
-// - Array indexing uses signed integers (int).
+// - Array indexing uses signed integers (Int_t, see types.h).
 //
 template <class T>
 class Sparse_vector {
@@ -53,10 +53,12 @@ public:
 
     explicit Sparse_vector(size_type n) : elems(n), indx(n), zero{T(0)} {}
 
-    Sparse_vector(const std::vector<T>& val, const std::vector<size_type>& loc)
-        : elems(val), indx(loc), zero{T(0)}
+    Sparse_vector(std::vector<T> val, std::vector<size_type> loc)
+        : elems(std::move(val)), indx(std::move(loc)), zero{T(0)}
     {
-        Ensures(val.size() == indx.size());
+        Ensures(elems.size() == indx.size());
+        Ensures(elems.size() <= static_cast<std::size_t>(
+                                    std::numeric_limits<size_type>::max()));
     }
 
     template <Int_t n>
@@ -104,9 +106,11 @@ public:
     // Euclidean norm.
     T norm() const;
 
-    // Dot product.
-    T dot(const srs::Array<T, 1>& y);
-    T dot(const std::vector<T>& y);
+    // Dot product. The dense versions gather the elements of y at the
+    // stored indices; the sparse version merges the two index lists.
+    T dot(const srs::Array<T, 1>& y) const;
+    T dot(const std::vector<T>& y) const;
+    T dot(const Sparse_vector& y) const;
 
     // Access underlying arrays:
 
@@ -138,6 +142,9 @@ private:
 
     T& ref(size_type i);
     const T& ref(size_type i) const;
+
+    // Dot product with the dense vector y.
+    T doti(const T* y) const;
 };
 
 template <class T>
@@ -226,7 +233,7 @@ inline const T& Sparse_vector<T>::operator()(size_type i) const
 template <class T>
 inline Int_t Sparse_vector<T>::size() const
 {
-    return *std::max_element(indx.begin(), indx.end()) + 1;
+    return indx.empty() ? 0 : indx.back() + 1;
 }
 
 template <class T>
@@ -275,25 +282,40 @@ T Sparse_vector<T>::norm() const
 }
 
 template <class T>
-T Sparse_vector<T>::dot(const srs::Array<T, 1>& y)
+inline T Sparse_vector<T>::dot(const srs::Array<T, 1>& y) const
 {
-    T result(0);
-    size_type i = 0;
-    for (const auto& v : elems) {
-        result += v * y(indx[i]);
-        ++i;
-    }
-    return result;
+    Expects(size() <= y.size());
+    return doti(y.data());
+}
+
+template <class T>
+inline T Sparse_vector<T>::dot(const std::vector<T>& y) const
+{
+    Expects(size() <= static_cast<size_type>(y.size()));
+    return doti(y.data());
 }
 
 template <class T>
-T Sparse_vector<T>::dot(const std::vector<T>& y)
+T Sparse_vector<T>::dot(const Sparse_vector& y) const
 {
+    const size_type nx  = indx.size();
+    const size_type ny  = y.indx.size();
+    const size_type* ix = indx.data();
+    const size_type* iy = y.indx.data();
+    const T* vx         = elems.data();
+    const T* vy         = y.elems.data();
+
     T result(0);
-    size_type i = 0;
-    for (const auto& v : elems) {
-        result += v * y[indx[i]];
-        ++i;
+    size_type p = 0;
+    size_type q = 0;
+    while (p < nx && q < ny) {
+        const size_type i = ix[p];
+        const size_type j = iy[q];
+        if (i == j) {
+            result += vx[p] * vy[q];
+        }
+        p += (i <= j);
+        q += (j <= i);
     }
     return result;
 }
@@ -365,6 +387,21 @@ inline const T& Sparse_vector<T>::ref(size_type i) const
     return index >= 0 && index < num_nonzero() ? elems[index] : zero;
 }
 
+template <class T>
+inline T Sparse_vector<T>::doti(const T* y) const
+{
+    const size_type nnz  = elems.size();
+    const T* val         = elems.data();
+    const size_type* idx = indx.data();
+
+    T result(0);
+#pragma omp simd reduction(+ : result)
+    for (size_type k = 0; k < nnz; ++k) {
+        result += val[k] * y[idx[k]];
+    }
+    return result;
+}
+
 }  // namespace srs
 
 #endif  // SRS_SPARSE_VECTOR_H
@@ -0,0 +1,401 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SRS_SYM_SPARSE_MATRIX_H
+#define SRS_SYM_SPARSE_MATRIX_H
+
+#include <srs/array.h>
+#include <srs/sparse_impl/sparse_matrix.h>
+#include <srs/types.h>
+#include <algorithm>
+#include <gsl/gsl>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+namespace srs {
+
+//
+// Symmetric sparse matrix holding the upper triangle in CSR3 format
+// (zero-based indexing).
+//
+// Note:
+// - Only the elements (i, j) with i <= j are stored, which halves the
+//   memory and the bandwidth of products compared to Sparse_matrix.
+// - The diagonal is always stored, with explicit zeros where needed, as
+//   required by the symmetric PARDISO and FEAST solvers.
+// - The column indices of each row are sorted in ascending order.
+//
+template <class T>
+class Sym_sparse_matrix {
+public:
+    typedef T value_type;
+    typedef Int_t size_type;
+
+    // Constructors:
+
+    Sym_sparse_matrix() : elems(), col_indx(), row_ptr(1, 0), n{0}, zero{T(0)}
+    {
+    }
+
+    // Upper triangle of a square matrix, which is assumed to be symmetric.
+    explicit Sym_sparse_matrix(const Sparse_matrix<T>& a);
+
+    // Upper triangle in CSR3 format, including the diagonal.
+    Sym_sparse_matrix(size_type nrows,
+                      std::vector<T> elems_,
+                      std::vector<size_type> colind,
+                      std::vector<size_type> rowptr);
+
+    // Element access (both triangles):
+
+    const T& at(size_type i, size_type j) const;
+    const T& operator()(size_type i, size_type j) const;
+
+    // Capacity:
+
+    bool empty() const { return n == 0; }
+    size_type rows() const { return n; }
+    size_type cols() const { return n; }
+
+    // Number of stored elements in the upper triangle.
+    size_type num_nonzero() const { return elems.size(); }
+
+    // Access underlying arrays:
+
+    T* data() { return elems.data(); }
+    const T* data() const { return elems.data(); }
+
+    const auto& values() const { return elems; }
+    const auto& columns() const { return col_indx; }
+    const auto& row_index() const { return row_ptr; }
+
+    auto columns_one_based() const;
+    auto row_index_one_based() const;
+
+    void swap(Sym_sparse_matrix& m);
+
+private:
+    std::vector<T> elems;
+    std::vector<size_type> col_indx;
+    std::vector<size_type> row_ptr;
+    size_type n;
+    T zero;
+};
+
+template <class T>
+Sym_sparse_matrix<T>::Sym_sparse_matrix(const Sparse_matrix<T>& a)
+    : elems(), col_indx(), row_ptr(a.rows() + 1, 0), n{a.rows()}, zero{T(0)}
+{
+    Expects(a.rows() == a.cols());
+
+    const auto& val = a.values();
+    const auto& col = a.columns();
+    const auto& ptr = a.row_index();
+
+    for (size_type i = 0; i < n; ++i) {
+        auto first = std::lower_bound(
+            col.begin() + ptr[i], col.begin() + ptr[i + 1], i);
+        size_type len = col.begin() + ptr[i + 1] - first;
+        if (first == col.begin() + ptr[i + 1] || *first != i) {
+            ++len;  // explicit zero on the diagonal
+        }
+        row_ptr[i + 1] = row_ptr[i] + len;
+    }
+    elems.resize(row_ptr[n]);
+    col_indx.resize(row_ptr[n]);
+
+#pragma omp parallel for schedule(static)
+    for (size_type i = 0; i < n; ++i) {
+        size_type k = std::lower_bound(col.begin() + ptr[i],
+                                       col.begin() + ptr[i + 1],
+                                       i)
+                      - col.begin();
+        size_type q = row_ptr[i];
+        if (k == ptr[i + 1] || col[k] != i) {
+            elems[q]    = T(0);
+            col_indx[q] = i;
+            ++q;
+        }
+        for (; k < ptr[i + 1]; ++k, ++q) {
+            elems[q]    = val[k];
+            col_indx[q] = col[k];
+        }
+    }
+}
+
+template <class T>
+Sym_sparse_matrix<T>::Sym_sparse_matrix(size_type nrows,
+                                        std::vector<T> elems_,
+                                        std::vector<size_type> colind,
+                                        std::vector<size_type> rowptr)
+    : elems(std::move(elems_)),
+      col_indx(std::move(colind)),
+      row_ptr(std::move(rowptr)),
+      n{nrows},
+      zero{T(0)}
+{
+    Ensures(elems.size() == col_indx.size());
+    Ensures(row_ptr.size() == gsl::narrow_cast<std::size_t>(nrows + 1));
+}
+
+template <class T>
+inline const T& Sym_sparse_matrix<T>::at(size_type i, size_type j) const
+{
+    Expects(i >= 0 && i < n);
+    Expects(j >= 0 && j < n);
+    if (i > j) {
+        std::swap(i, j);
+    }
+    auto first = col_indx.begin() + row_ptr[i];
+    auto last  = col_indx.begin() + row_ptr[i + 1];
+    auto pos   = std::lower_bound(first, last, j);
+    if (pos != last && *pos == j) {
+        return elems[pos - col_indx.begin()];
+    }
+    return zero;
+}
+
+template <class T>
+inline const T& Sym_sparse_matrix<T>::operator()(size_type i,
+                                                 size_type j) const
+{
+    return at(i, j);
+}
+
+template <class T>
+auto Sym_sparse_matrix<T>::columns_one_based() const
+{
+    auto result = col_indx;
+    for (auto& i : result) {
+        i += 1;
+    }
+    return result;
+}
+
+template <class T>
+auto Sym_sparse_matrix<T>::row_index_one_based() const
+{
+    auto result = row_ptr;
+    for (auto& i : result) {
+        i += 1;
+    }
+    return result;
+}
+
+template <class T>
+inline void Sym_sparse_matrix<T>::swap(Sym_sparse_matrix& m)
+{
+    elems.swap(m.elems);
+    col_indx.swap(m.col_indx);
+    row_ptr.swap(m.row_ptr);
+    std::swap(n, m.n);
+}
+
+//------------------------------------------------------------------------------
+
+// Conversion to a sparse matrix holding both triangles.
+template <class T>
+Sparse_matrix<T> to_sparse(const Sym_sparse_matrix<T>& a)
+{
+    using size_type = typename Sym_sparse_matrix<T>::size_type;
+
+    const size_type n = a.rows();
+    const auto& val   = a.values();
+    const auto& col   = a.columns();
+    const auto& ptr   = a.row_index();
+
+    // Row i holds the strictly upper elements (j, i) of the rows j < i,
+    // followed by row i of the upper triangle.
+    std::vector<size_type> row_ptr(n + 1, 0);
+    for (size_type i = 0; i < n; ++i) {
+        row_ptr[i + 1] += ptr[i + 1] - ptr[i];
+        for (size_type k = ptr[i]; k < ptr[i + 1]; ++k) {
+            if (col[k] != i) {
+                ++row_ptr[col[k] + 1];
+            }
+        }
+    }
+    for (size_type i = 0; i < n; ++i) {
+        row_ptr[i + 1] += row_ptr[i];
+    }
+    std::vector<T> elems(row_ptr[n]);
+    std::vector<size_type> col_indx(row_ptr[n]);
+    std::vector<size_type> next(row_ptr.begin(), row_ptr.end() - 1);
+
+    // Visiting the rows in order keeps the lower elements of each row
+    // sorted by column.
+    for (size_type i = 0; i < n; ++i) {
+        for (size_type k = ptr[i]; k < ptr[i + 1]; ++k) {
+            const size_type j = col[k];
+            if (j != i) {
+                elems[next[j]]    = val[k];
+                col_indx[next[j]] = i;
+                ++next[j];
+            }
+        }
+    }
+#pragma omp parallel for schedule(static)
+    for (size_type i = 0; i < n; ++i) {
+        std::copy(val.begin() + ptr[i],
+                  val.begin() + ptr[i + 1],
+                  elems.begin() + next[i]);
+        std::copy(col.begin() + ptr[i],
+                  col.begin() + ptr[i + 1],
+                  col_indx.begin() + next[i]);
+    }
+
+    return Sparse_matrix<T>(n,
+                            n,
+                            std::move(elems),
+                            std::move(col_indx),
+                            std::move(row_ptr));
+}
+
+//------------------------------------------------------------------------------
+
+// Symmetric matrix-vector product y = alpha * a * x + beta * y. If y is
+// empty, it is resized and beta is ignored.
+//
+// Each stored element a(i, j) contributes to both y(i) and y(j). The rows
+// are split into nnz-balanced blocks, one per thread; contributions to rows
+// of the own block are added directly to y, and those to later blocks go to
+// a private buffer for each block. The buffers are then added to y in a
+// second pass, so that no two threads write the same element.
+template <class T>
+void mv_mul(const T& alpha,
+            const Sym_sparse_matrix<T>& a,
+            const Array<T, 1>& x,
+            const T& beta,
+            Array<T, 1>& y)
+{
+    using size_type = typename Sym_sparse_matrix<T>::size_type;
+
+    const size_type n = a.rows();
+    Expects(x.size() == n);
+    T b = beta;
+    if (y.empty()) {
+        y.resize(n);
+        b = T(0);
+    }
+    Expects(y.size() == n);
+    if (n == 0) {
+        return;
+    }
+
+    const T* val         = a.data();
+    const size_type* col = a.columns().data();
+    const auto& ptr      = a.row_index();
+    const T* px          = x.data();
+    T* py                = y.data();
+
+#ifdef _OPENMP
+    const size_type nparts = std::min<size_type>(omp_get_max_threads(), n);
+#else
+    const size_type nparts = 1;
+#endif
+    std::vector<size_type> parts(nparts + 1);
+    parts[0]      = 0;
+    parts[nparts] = n;
+    for (size_type t = 1; t < nparts; ++t) {
+        size_type target = gsl::narrow_cast<size_type>(
+            static_cast<double>(ptr[n]) * t / nparts);
+        auto pos = std::lower_bound(ptr.begin(), ptr.begin() + n, target);
+        parts[t] = std::max(
+            parts[t - 1], gsl::narrow_cast<size_type>(pos - ptr.begin()));
+    }
+
+    // Buffer t holds the contributions of block t to the rows
+    // parts[t + 1] to last[t] - 1.
+    std::vector<size_type> last(nparts);
+    std::vector<size_type> offset(nparts + 1, 0);
+    for (size_type t = 0; t < nparts; ++t) {
+        last[t] = parts[t + 1];
+        for (size_type i = parts[t]; i < parts[t + 1]; ++i) {
+            if (ptr[i] < ptr[i + 1]) {
+                last[t] = std::max(last[t], col[ptr[i + 1] - 1] + 1);
+            }
+        }
+        offset[t + 1] = offset[t] + last[t] - parts[t + 1];
+    }
+    std::vector<T> work(offset[nparts]);
+
+#pragma omp parallel for schedule(static, 1)
+    for (size_type t = 0; t < nparts; ++t) {
+        const size_type iend = parts[t + 1];
+        T* wt                = work.data() + offset[t];
+        std::fill(work.begin() + offset[t], work.begin() + offset[t + 1], T(0));
+        for (size_type i = parts[t]; i < iend; ++i) {
+            py[i] = (b == T(0)) ? T(0) : b * py[i];
+        }
+        for (size_type i = parts[t]; i < iend; ++i) {
+            const T axi = alpha * px[i];
+            T sum       = T(0);
+            for (size_type k = ptr[i]; k < ptr[i + 1]; ++k) {
+                const size_type j = col[k];
+                sum += val[k] * px[j];
+                if (j == i) {
+                    continue;
+                }
+                if (j < iend) {
+                    py[j] += val[k] * axi;
+                }
+                else {
+                    wt[j - iend] += val[k] * axi;
+                }
+            }
+            py[i] += alpha * sum;
+        }
+    }
+
+    if (nparts > 1) {
+#pragma omp parallel for schedule(static, 1)
+        for (size_type t = 1; t < nparts; ++t) {
+            for (size_type s = 0; s < t; ++s) {
+                const T* ws          = work.data() + offset[s];
+                const size_type base = parts[s + 1];
+                const size_type jend = std::min(parts[t + 1], last[s]);
+                for (size_type j = std::max(parts[t], base); j < jend; ++j) {
+                    py[j] += ws[j - base];
+                }
+            }
+        }
+    }
+}
+
+template <class T>
+void mv_mul(const Sym_sparse_matrix<T>& a, const Array<T, 1>& x, Array<T, 1>& y)
+{
+    y.resize(a.rows());
+    mv_mul(T(1), a, x, T(0), y);
+}
+
+template <class T>
+inline Array<T, 1> operator*(const Sym_sparse_matrix<T>& a,
+                             const Array<T, 1>& x)
+{
+    Array<T, 1> result;
+    mv_mul(a, x, result);
+    return result;
+}
+
+}  // namespace srs
+
+#endif  // SRS_SYM_SPARSE_MATRIX_H
@@ -17,11 +17,26 @@
 #ifndef SRS_TYPES_H
 #define SRS_TYPES_H
 
+#include <cstdint>
+#include <gsl/gsl>
+#include <limits>
+
 
 namespace srs {
 
-// Integer type.
-#ifdef MKL_INT
+// Integer type of all extents, strides and sparse indices, which is the
+// integer type of the BLAS/LAPACK interface (MKL_INT, see backend.h).
+//
+// Int_t is 32-bit by default, which limits arrays to 2^31 - 1 elements
+// and sparse matrices to 2^31 - 1 nonzeros. Defining SRS_USE_ILP64 selects
+// 64-bit integers and the ILP64 interface of the backend.
+#if defined(SRS_USE_ILP64)
+#if defined(SRS_USE_OPENBLAS)
+typedef std::int64_t Int_t;  // lapack_int with LAPACK_ILP64
+#else
+typedef long long Int_t;  // MKL_INT with MKL_ILP64
+#endif
+#elif defined(MKL_INT)
 typedef MKL_INT Int_t;
 #else
 typedef int Int_t;
@@ -30,6 +45,25 @@ typedef int Int_t;
 // Size type.
 typedef Int_t size_t;
 
+// Number of elements of an array with extents m, n, ..., checked for
+// overflow of Int_t.
+inline Int_t checked_mul(Int_t m, Int_t n)
+{
+    Expects(m >= 0 && n >= 0);
+    Expects(n == 0 || m <= std::numeric_limits<Int_t>::max() / n);
+    return m * n;
+}
+
+inline Int_t checked_mul(Int_t n1, Int_t n2, Int_t n3)
+{
+    return checked_mul(checked_mul(n1, n2), n3);
+}
+
+inline Int_t checked_mul(Int_t n1, Int_t n2, Int_t n3, Int_t n4)
+{
+    return checked_mul(checked_mul(n1, n2, n3), n4);
+}
+
 //------------------------------------------------------------------------------
 
 // Vector and matrix norm types.
@@ -40,6 +74,23 @@ enum Norm_t {
     Inf = 100,
 };
 
+//------------------------------------------------------------------------------
+
+// Orthogonalization methods.
+enum Ortho_t {
+    Mgs         = 0,  // blocked modified Gram-Schmidt
+    Cgs2        = 1,  // classical Gram-Schmidt with reorthogonalization
+    Householder = 2,  // Householder QR
+};
+
+//------------------------------------------------------------------------------
+
+// Tridiagonal solver methods.
+enum Tridiag_t {
+    Thomas = 0,  // Thomas algorithm (sequential Gaussian elimination)
+    Pcr    = 1,  // parallel cyclic reduction
+};
+
 }  // namespace srs
 
 #endif  // SRS_TYPES_H
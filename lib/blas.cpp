@@ -0,0 +1,1002 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <srs/math_impl/backend.h>
+#include <srs/math_impl/blas.h>
+#include <vector>
+
+
+#ifndef SRS_USE_NATIVE
+namespace {
+
+inline CBLAS_TRANSPOSE cblas_trans(char trans)
+{
+    return ((trans == 'T') || (trans == 't')) ? CblasTrans : CblasNoTrans;
+}
+
+inline CBLAS_UPLO cblas_uplo(char uplo)
+{
+    return ((uplo == 'U') || (uplo == 'u')) ? CblasUpper : CblasLower;
+}
+
+inline CBLAS_SIDE cblas_side(char side)
+{
+    return ((side == 'L') || (side == 'l')) ? CblasLeft : CblasRight;
+}
+
+}  // namespace
+#endif
+
+void srs::blas::gemm(char transa,
+                     char transb,
+                     MKL_INT m,
+                     MKL_INT n,
+                     MKL_INT k,
+                     double alpha,
+                     const double* a,
+                     MKL_INT lda,
+                     const double* b,
+                     MKL_INT ldb,
+                     double beta,
+                     double* c,
+                     MKL_INT ldc)
+{
+#ifdef SRS_USE_NATIVE
+    native_gemm(
+        transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+#else
+    // clang-format off
+    cblas_dgemm(
+        CblasColMajor, cblas_trans(transa), cblas_trans(transb), m, n, k,
+        alpha, a, lda, b, ldb, beta, c, ldc);
+    // clang-format on
+#endif
+}
+
+void srs::blas::gemv(char transa,
+                     MKL_INT m,
+                     MKL_INT n,
+                     double alpha,
+                     const double* a,
+                     MKL_INT lda,
+                     const double* x,
+                     MKL_INT incx,
+                     double beta,
+                     double* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    native_gemv(transa, m, n, alpha, a, lda, x, incx, beta, y, incy);
+#else
+    // clang-format off
+    cblas_dgemv(
+        CblasColMajor, cblas_trans(transa), m, n, alpha, a, lda, x, incx,
+        beta, y, incy);
+    // clang-format on
+#endif
+}
+
+void srs::blas::axpy(MKL_INT n,
+                     double alpha,
+                     const double* x,
+                     MKL_INT incx,
+                     double* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    native_axpy(n, alpha, x, incx, y, incy);
+#else
+    cblas_daxpy(n, alpha, x, incx, y, incy);
+#endif
+}
+
+double srs::blas::dot(
+    MKL_INT n, const double* x, MKL_INT incx, const double* y, MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    return native_dot(n, x, incx, y, incy);
+#else
+    return cblas_ddot(n, x, incx, y, incy);
+#endif
+}
+
+void srs::blas::scal(MKL_INT n, double alpha, double* x, MKL_INT incx)
+{
+#ifdef SRS_USE_NATIVE
+    native_scal(n, alpha, x, incx);
+#else
+    cblas_dscal(n, alpha, x, incx);
+#endif
+}
+
+void srs::blas::copy(
+    MKL_INT n, const double* x, MKL_INT incx, double* y, MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    native_copy(n, x, incx, y, incy);
+#else
+    cblas_dcopy(n, x, incx, y, incy);
+#endif
+}
+
+double srs::blas::nrm2(MKL_INT n, const double* x, MKL_INT incx)
+{
+#ifdef SRS_USE_NATIVE
+    return native_nrm2(n, x, incx);
+#else
+    return cblas_dnrm2(n, x, incx);
+#endif
+}
+
+void srs::blas::omatcopy(char trans,
+                         MKL_INT rows,
+                         MKL_INT cols,
+                         double alpha,
+                         const double* a,
+                         MKL_INT lda,
+                         double* b,
+                         MKL_INT ldb)
+{
+#if defined(SRS_USE_MKL)
+    mkl_domatcopy('C', trans, rows, cols, alpha, a, lda, b, ldb);
+#elif defined(SRS_USE_OPENBLAS)
+    // clang-format off
+    cblas_domatcopy(
+        CblasColMajor, cblas_trans(trans), rows, cols, alpha, a, lda, b, ldb);
+    // clang-format on
+#else
+    native_omatcopy(trans, rows, cols, alpha, a, lda, b, ldb);
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+void srs::blas::gemm(char transa,
+                     char transb,
+                     MKL_INT m,
+                     MKL_INT n,
+                     MKL_INT k,
+                     float alpha,
+                     const float* a,
+                     MKL_INT lda,
+                     const float* b,
+                     MKL_INT ldb,
+                     float beta,
+                     float* c,
+                     MKL_INT ldc)
+{
+#ifdef SRS_USE_NATIVE
+    native_gemm(
+        transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+#else
+    // clang-format off
+    cblas_sgemm(
+        CblasColMajor, cblas_trans(transa), cblas_trans(transb), m, n, k,
+        alpha, a, lda, b, ldb, beta, c, ldc);
+    // clang-format on
+#endif
+}
+
+void srs::blas::gemv(char transa,
+                     MKL_INT m,
+                     MKL_INT n,
+                     float alpha,
+                     const float* a,
+                     MKL_INT lda,
+                     const float* x,
+                     MKL_INT incx,
+                     float beta,
+                     float* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    native_gemv(transa, m, n, alpha, a, lda, x, incx, beta, y, incy);
+#else
+    // clang-format off
+    cblas_sgemv(
+        CblasColMajor, cblas_trans(transa), m, n, alpha, a, lda, x, incx,
+        beta, y, incy);
+    // clang-format on
+#endif
+}
+
+void srs::blas::axpy(MKL_INT n,
+                     float alpha,
+                     const float* x,
+                     MKL_INT incx,
+                     float* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    native_axpy(n, alpha, x, incx, y, incy);
+#else
+    cblas_saxpy(n, alpha, x, incx, y, incy);
+#endif
+}
+
+float srs::blas::dot(
+    MKL_INT n, const float* x, MKL_INT incx, const float* y, MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    return native_dot(n, x, incx, y, incy);
+#else
+    return cblas_sdot(n, x, incx, y, incy);
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+void srs::blas::gemm(char transa,
+                     char transb,
+                     MKL_INT m,
+                     MKL_INT n,
+                     MKL_INT k,
+                     std::complex<float> alpha,
+                     const std::complex<float>* a,
+                     MKL_INT lda,
+                     const std::complex<float>* b,
+                     MKL_INT ldb,
+                     std::complex<float> beta,
+                     std::complex<float>* c,
+                     MKL_INT ldc)
+{
+#ifdef SRS_USE_NATIVE
+    native_gemm(
+        transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+#else
+    // clang-format off
+    cblas_cgemm(
+        CblasColMajor, cblas_trans(transa), cblas_trans(transb), m, n, k,
+        &alpha, a, lda, b, ldb, &beta, c, ldc);
+    // clang-format on
+#endif
+}
+
+void srs::blas::gemv(char transa,
+                     MKL_INT m,
+                     MKL_INT n,
+                     std::complex<float> alpha,
+                     const std::complex<float>* a,
+                     MKL_INT lda,
+                     const std::complex<float>* x,
+                     MKL_INT incx,
+                     std::complex<float> beta,
+                     std::complex<float>* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    native_gemv(transa, m, n, alpha, a, lda, x, incx, beta, y, incy);
+#else
+    // clang-format off
+    cblas_cgemv(
+        CblasColMajor, cblas_trans(transa), m, n, &alpha, a, lda, x, incx,
+        &beta, y, incy);
+    // clang-format on
+#endif
+}
+
+void srs::blas::axpy(MKL_INT n,
+                     std::complex<float> alpha,
+                     const std::complex<float>* x,
+                     MKL_INT incx,
+                     std::complex<float>* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    native_axpy(n, alpha, x, incx, y, incy);
+#else
+    cblas_caxpy(n, &alpha, x, incx, y, incy);
+#endif
+}
+
+std::complex<float> srs::blas::dot(MKL_INT n,
+                                   const std::complex<float>* x,
+                                   MKL_INT incx,
+                                   const std::complex<float>* y,
+                                   MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    return native_dot(n, x, incx, y, incy);
+#else
+    std::complex<float> result;
+    cblas_cdotu_sub(n, x, incx, y, incy, &result);
+    return result;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+void srs::blas::gemm(char transa,
+                     char transb,
+                     MKL_INT m,
+                     MKL_INT n,
+                     MKL_INT k,
+                     std::complex<double> alpha,
+                     const std::complex<double>* a,
+                     MKL_INT lda,
+                     const std::complex<double>* b,
+                     MKL_INT ldb,
+                     std::complex<double> beta,
+                     std::complex<double>* c,
+                     MKL_INT ldc)
+{
+#ifdef SRS_USE_NATIVE
+    native_gemm(
+        transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+#else
+    // clang-format off
+    cblas_zgemm(
+        CblasColMajor, cblas_trans(transa), cblas_trans(transb), m, n, k,
+        &alpha, a, lda, b, ldb, &beta, c, ldc);
+    // clang-format on
+#endif
+}
+
+void srs::blas::gemv(char transa,
+                     MKL_INT m,
+                     MKL_INT n,
+                     std::complex<double> alpha,
+                     const std::complex<double>* a,
+                     MKL_INT lda,
+                     const std::complex<double>* x,
+                     MKL_INT incx,
+                     std::complex<double> beta,
+                     std::complex<double>* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    native_gemv(transa, m, n, alpha, a, lda, x, incx, beta, y, incy);
+#else
+    // clang-format off
+    cblas_zgemv(
+        CblasColMajor, cblas_trans(transa), m, n, &alpha, a, lda, x, incx,
+        &beta, y, incy);
+    // clang-format on
+#endif
+}
+
+void srs::blas::axpy(MKL_INT n,
+                     std::complex<double> alpha,
+                     const std::complex<double>* x,
+                     MKL_INT incx,
+                     std::complex<double>* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    native_axpy(n, alpha, x, incx, y, incy);
+#else
+    cblas_zaxpy(n, &alpha, x, incx, y, incy);
+#endif
+}
+
+std::complex<double> srs::blas::dot(MKL_INT n,
+                                    const std::complex<double>* x,
+                                    MKL_INT incx,
+                                    const std::complex<double>* y,
+                                    MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    return native_dot(n, x, incx, y, incy);
+#else
+    std::complex<double> result;
+    cblas_zdotu_sub(n, x, incx, y, incy, &result);
+    return result;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+// Batched matrix-matrix products:
+
+void srs::blas::gemm_batch_strided(char transa,
+                                   char transb,
+                                   MKL_INT m,
+                                   MKL_INT n,
+                                   MKL_INT k,
+                                   float alpha,
+                                   const float* a,
+                                   MKL_INT lda,
+                                   MKL_INT stridea,
+                                   const float* b,
+                                   MKL_INT ldb,
+                                   MKL_INT strideb,
+                                   float beta,
+                                   float* c,
+                                   MKL_INT ldc,
+                                   MKL_INT stridec,
+                                   MKL_INT batch_size)
+{
+#ifdef SRS_USE_MKL
+    // clang-format off
+    cblas_sgemm_batch_strided(
+        CblasColMajor, cblas_trans(transa), cblas_trans(transb), m, n, k,
+        alpha, a, lda, stridea, b, ldb, strideb, beta, c, ldc, stridec,
+        batch_size);
+    // clang-format on
+#else
+    // clang-format off
+    native_gemm_batch_strided(
+        transa, transb, m, n, k, alpha, a, lda, stridea, b, ldb, strideb,
+        beta, c, ldc, stridec, batch_size);
+    // clang-format on
+#endif
+}
+
+void srs::blas::gemm_batch(char transa,
+                           char transb,
+                           const MKL_INT* m,
+                           const MKL_INT* n,
+                           const MKL_INT* k,
+                           float alpha,
+                           const float* const* a,
+                           const MKL_INT* lda,
+                           const float* const* b,
+                           const MKL_INT* ldb,
+                           float beta,
+                           float* const* c,
+                           const MKL_INT* ldc,
+                           MKL_INT batch_size)
+{
+#ifdef SRS_USE_MKL
+    // Each product forms a group of its own, since the dimensions may vary.
+    std::vector<CBLAS_TRANSPOSE> ta(batch_size, cblas_trans(transa));
+    std::vector<CBLAS_TRANSPOSE> tb(batch_size, cblas_trans(transb));
+    std::vector<float> alphas(batch_size, alpha);
+    std::vector<float> betas(batch_size, beta);
+    std::vector<MKL_INT> group_size(batch_size, 1);
+
+    std::vector<const float*> pa(a, a + batch_size);
+    std::vector<const float*> pb(b, b + batch_size);
+    std::vector<float*> pc(c, c + batch_size);
+
+    // clang-format off
+    cblas_sgemm_batch(
+        CblasColMajor, ta.data(), tb.data(), m, n, k, alphas.data(), pa.data(),
+        lda, pb.data(), ldb, betas.data(), pc.data(), ldc, batch_size,
+        group_size.data());
+    // clang-format on
+#else
+    // clang-format off
+    native_gemm_batch(
+        transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+        batch_size);
+    // clang-format on
+#endif
+}
+
+void srs::blas::gemm_batch_strided(char transa,
+                                   char transb,
+                                   MKL_INT m,
+                                   MKL_INT n,
+                                   MKL_INT k,
+                                   double alpha,
+                                   const double* a,
+                                   MKL_INT lda,
+                                   MKL_INT stridea,
+                                   const double* b,
+                                   MKL_INT ldb,
+                                   MKL_INT strideb,
+                                   double beta,
+                                   double* c,
+                                   MKL_INT ldc,
+                                   MKL_INT stridec,
+                                   MKL_INT batch_size)
+{
+#ifdef SRS_USE_MKL
+    // clang-format off
+    cblas_dgemm_batch_strided(
+        CblasColMajor, cblas_trans(transa), cblas_trans(transb), m, n, k,
+        alpha, a, lda, stridea, b, ldb, strideb, beta, c, ldc, stridec,
+        batch_size);
+    // clang-format on
+#else
+    // clang-format off
+    native_gemm_batch_strided(
+        transa, transb, m, n, k, alpha, a, lda, stridea, b, ldb, strideb,
+        beta, c, ldc, stridec, batch_size);
+    // clang-format on
+#endif
+}
+
+void srs::blas::gemm_batch(char transa,
+                           char transb,
+                           const MKL_INT* m,
+                           const MKL_INT* n,
+                           const MKL_INT* k,
+                           double alpha,
+                           const double* const* a,
+                           const MKL_INT* lda,
+                           const double* const* b,
+                           const MKL_INT* ldb,
+                           double beta,
+                           double* const* c,
+                           const MKL_INT* ldc,
+                           MKL_INT batch_size)
+{
+#ifdef SRS_USE_MKL
+    // Each product forms a group of its own, since the dimensions may vary.
+    std::vector<CBLAS_TRANSPOSE> ta(batch_size, cblas_trans(transa));
+    std::vector<CBLAS_TRANSPOSE> tb(batch_size, cblas_trans(transb));
+    std::vector<double> alphas(batch_size, alpha);
+    std::vector<double> betas(batch_size, beta);
+    std::vector<MKL_INT> group_size(batch_size, 1);
+
+    std::vector<const double*> pa(a, a + batch_size);
+    std::vector<const double*> pb(b, b + batch_size);
+    std::vector<double*> pc(c, c + batch_size);
+
+    // clang-format off
+    cblas_dgemm_batch(
+        CblasColMajor, ta.data(), tb.data(), m, n, k, alphas.data(), pa.data(),
+        lda, pb.data(), ldb, betas.data(), pc.data(), ldc, batch_size,
+        group_size.data());
+    // clang-format on
+#else
+    // clang-format off
+    native_gemm_batch(
+        transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+        batch_size);
+    // clang-format on
+#endif
+}
+
+void srs::blas::gemm_batch_strided(char transa,
+                                   char transb,
+                                   MKL_INT m,
+                                   MKL_INT n,
+                                   MKL_INT k,
+                                   std::complex<float> alpha,
+                                   const std::complex<float>* a,
+                                   MKL_INT lda,
+                                   MKL_INT stridea,
+                                   const std::complex<float>* b,
+                                   MKL_INT ldb,
+                                   MKL_INT strideb,
+                                   std::complex<float> beta,
+                                   std::complex<float>* c,
+                                   MKL_INT ldc,
+                                   MKL_INT stridec,
+                                   MKL_INT batch_size)
+{
+#ifdef SRS_USE_MKL
+    // clang-format off
+    cblas_cgemm_batch_strided(
+        CblasColMajor, cblas_trans(transa), cblas_trans(transb), m, n, k,
+        &alpha, a, lda, stridea, b, ldb, strideb, &beta, c, ldc, stridec,
+        batch_size);
+    // clang-format on
+#else
+    // clang-format off
+    native_gemm_batch_strided(
+        transa, transb, m, n, k, alpha, a, lda, stridea, b, ldb, strideb,
+        beta, c, ldc, stridec, batch_size);
+    // clang-format on
+#endif
+}
+
+void srs::blas::gemm_batch(char transa,
+                           char transb,
+                           const MKL_INT* m,
+                           const MKL_INT* n,
+                           const MKL_INT* k,
+                           std::complex<float> alpha,
+                           const std::complex<float>* const* a,
+                           const MKL_INT* lda,
+                           const std::complex<float>* const* b,
+                           const MKL_INT* ldb,
+                           std::complex<float> beta,
+                           std::complex<float>* const* c,
+                           const MKL_INT* ldc,
+                           MKL_INT batch_size)
+{
+#ifdef SRS_USE_MKL
+    // Each product forms a group of its own, since the dimensions may vary.
+    std::vector<CBLAS_TRANSPOSE> ta(batch_size, cblas_trans(transa));
+    std::vector<CBLAS_TRANSPOSE> tb(batch_size, cblas_trans(transb));
+    std::vector<std::complex<float>> alphas(batch_size, alpha);
+    std::vector<std::complex<float>> betas(batch_size, beta);
+    std::vector<MKL_INT> group_size(batch_size, 1);
+
+    std::vector<const void*> pa(a, a + batch_size);
+    std::vector<const void*> pb(b, b + batch_size);
+    std::vector<void*> pc(c, c + batch_size);
+
+    // clang-format off
+    cblas_cgemm_batch(
+        CblasColMajor, ta.data(), tb.data(), m, n, k, alphas.data(), pa.data(),
+        lda, pb.data(), ldb, betas.data(), pc.data(), ldc, batch_size,
+        group_size.data());
+    // clang-format on
+#else
+    // clang-format off
+    native_gemm_batch(
+        transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+        batch_size);
+    // clang-format on
+#endif
+}
+
+void srs::blas::gemm_batch_strided(char transa,
+                                   char transb,
+                                   MKL_INT m,
+                                   MKL_INT n,
+                                   MKL_INT k,
+                                   std::complex<double> alpha,
+                                   const std::complex<double>* a,
+                                   MKL_INT lda,
+                                   MKL_INT stridea,
+                                   const std::complex<double>* b,
+                                   MKL_INT ldb,
+                                   MKL_INT strideb,
+                                   std::complex<double> beta,
+                                   std::complex<double>* c,
+                                   MKL_INT ldc,
+                                   MKL_INT stridec,
+                                   MKL_INT batch_size)
+{
+#ifdef SRS_USE_MKL
+    // clang-format off
+    cblas_zgemm_batch_strided(
+        CblasColMajor, cblas_trans(transa), cblas_trans(transb), m, n, k,
+        &alpha, a, lda, stridea, b, ldb, strideb, &beta, c, ldc, stridec,
+        batch_size);
+    // clang-format on
+#else
+    // clang-format off
+    native_gemm_batch_strided(
+        transa, transb, m, n, k, alpha, a, lda, stridea, b, ldb, strideb,
+        beta, c, ldc, stridec, batch_size);
+    // clang-format on
+#endif
+}
+
+void srs::blas::gemm_batch(char transa,
+                           char transb,
+                           const MKL_INT* m,
+                           const MKL_INT* n,
+                           const MKL_INT* k,
+                           std::complex<double> alpha,
+                           const std::complex<double>* const* a,
+                           const MKL_INT* lda,
+                           const std::complex<double>* const* b,
+                           const MKL_INT* ldb,
+                           std::complex<double> beta,
+                           std::complex<double>* const* c,
+                           const MKL_INT* ldc,
+                           MKL_INT batch_size)
+{
+#ifdef SRS_USE_MKL
+    // Each product forms a group of its own, since the dimensions may vary.
+    std::vector<CBLAS_TRANSPOSE> ta(batch_size, cblas_trans(transa));
+    std::vector<CBLAS_TRANSPOSE> tb(batch_size, cblas_trans(transb));
+    std::vector<std::complex<double>> alphas(batch_size, alpha);
+    std::vector<std::complex<double>> betas(batch_size, beta);
+    std::vector<MKL_INT> group_size(batch_size, 1);
+
+    std::vector<const void*> pa(a, a + batch_size);
+    std::vector<const void*> pb(b, b + batch_size);
+    std::vector<void*> pc(c, c + batch_size);
+
+    // clang-format off
+    cblas_zgemm_batch(
+        CblasColMajor, ta.data(), tb.data(), m, n, k, alphas.data(), pa.data(),
+        lda, pb.data(), ldb, betas.data(), pc.data(), ldc, batch_size,
+        group_size.data());
+    // clang-format on
+#else
+    // clang-format off
+    native_gemm_batch(
+        transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+        batch_size);
+    // clang-format on
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+// Band matrix-vector products:
+
+void srs::blas::gbmv(char transa,
+                     MKL_INT m,
+                     MKL_INT n,
+                     MKL_INT kl,
+                     MKL_INT ku,
+                     float alpha,
+                     const float* a,
+                     MKL_INT lda,
+                     const float* x,
+                     MKL_INT incx,
+                     float beta,
+                     float* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    // clang-format off
+    native_gbmv(
+        transa, m, n, kl, ku, alpha, a, lda, x, incx, beta, y, incy);
+    // clang-format on
+#else
+    // clang-format off
+    cblas_sgbmv(
+        CblasColMajor, cblas_trans(transa), m, n, kl, ku, alpha, a, lda, x,
+        incx, beta, y, incy);
+    // clang-format on
+#endif
+}
+
+void srs::blas::sbmv(char uplo,
+                     MKL_INT n,
+                     MKL_INT k,
+                     float alpha,
+                     const float* a,
+                     MKL_INT lda,
+                     const float* x,
+                     MKL_INT incx,
+                     float beta,
+                     float* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    native_sbmv(uplo, n, k, alpha, a, lda, x, incx, beta, y, incy);
+#else
+    // clang-format off
+    cblas_ssbmv(
+        CblasColMajor, cblas_uplo(uplo), n, k, alpha, a, lda, x, incx, beta,
+        y, incy);
+    // clang-format on
+#endif
+}
+
+void srs::blas::gbmv(char transa,
+                     MKL_INT m,
+                     MKL_INT n,
+                     MKL_INT kl,
+                     MKL_INT ku,
+                     double alpha,
+                     const double* a,
+                     MKL_INT lda,
+                     const double* x,
+                     MKL_INT incx,
+                     double beta,
+                     double* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    // clang-format off
+    native_gbmv(
+        transa, m, n, kl, ku, alpha, a, lda, x, incx, beta, y, incy);
+    // clang-format on
+#else
+    // clang-format off
+    cblas_dgbmv(
+        CblasColMajor, cblas_trans(transa), m, n, kl, ku, alpha, a, lda, x,
+        incx, beta, y, incy);
+    // clang-format on
+#endif
+}
+
+void srs::blas::sbmv(char uplo,
+                     MKL_INT n,
+                     MKL_INT k,
+                     double alpha,
+                     const double* a,
+                     MKL_INT lda,
+                     const double* x,
+                     MKL_INT incx,
+                     double beta,
+                     double* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    native_sbmv(uplo, n, k, alpha, a, lda, x, incx, beta, y, incy);
+#else
+    // clang-format off
+    cblas_dsbmv(
+        CblasColMajor, cblas_uplo(uplo), n, k, alpha, a, lda, x, incx, beta,
+        y, incy);
+    // clang-format on
+#endif
+}
+
+void srs::blas::gbmv(char transa,
+                     MKL_INT m,
+                     MKL_INT n,
+                     MKL_INT kl,
+                     MKL_INT ku,
+                     std::complex<float> alpha,
+                     const std::complex<float>* a,
+                     MKL_INT lda,
+                     const std::complex<float>* x,
+                     MKL_INT incx,
+                     std::complex<float> beta,
+                     std::complex<float>* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    // clang-format off
+    native_gbmv(
+        transa, m, n, kl, ku, alpha, a, lda, x, incx, beta, y, incy);
+    // clang-format on
+#else
+    // clang-format off
+    cblas_cgbmv(
+        CblasColMajor, cblas_trans(transa), m, n, kl, ku, &alpha, a, lda, x,
+        incx, &beta, y, incy);
+    // clang-format on
+#endif
+}
+
+void srs::blas::gbmv(char transa,
+                     MKL_INT m,
+                     MKL_INT n,
+                     MKL_INT kl,
+                     MKL_INT ku,
+                     std::complex<double> alpha,
+                     const std::complex<double>* a,
+                     MKL_INT lda,
+                     const std::complex<double>* x,
+                     MKL_INT incx,
+                     std::complex<double> beta,
+                     std::complex<double>* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    // clang-format off
+    native_gbmv(
+        transa, m, n, kl, ku, alpha, a, lda, x, incx, beta, y, incy);
+    // clang-format on
+#else
+    // clang-format off
+    cblas_zgbmv(
+        CblasColMajor, cblas_trans(transa), m, n, kl, ku, &alpha, a, lda, x,
+        incx, &beta, y, incy);
+    // clang-format on
+#endif
+}
+
+void srs::blas::spmv(char uplo,
+                     MKL_INT n,
+                     float alpha,
+                     const float* ap,
+                     const float* x,
+                     MKL_INT incx,
+                     float beta,
+                     float* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    native_spmv(uplo, n, alpha, ap, x, incx, beta, y, incy);
+#else
+    // clang-format off
+    cblas_sspmv(
+        CblasColMajor, cblas_uplo(uplo), n, alpha, ap, x, incx, beta, y,
+        incy);
+    // clang-format on
+#endif
+}
+
+void srs::blas::spmv(char uplo,
+                     MKL_INT n,
+                     double alpha,
+                     const double* ap,
+                     const double* x,
+                     MKL_INT incx,
+                     double beta,
+                     double* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    native_spmv(uplo, n, alpha, ap, x, incx, beta, y, incy);
+#else
+    // clang-format off
+    cblas_dspmv(
+        CblasColMajor, cblas_uplo(uplo), n, alpha, ap, x, incx, beta, y,
+        incy);
+    // clang-format on
+#endif
+}
+
+void srs::blas::symv(char uplo,
+                     MKL_INT n,
+                     float alpha,
+                     const float* a,
+                     MKL_INT lda,
+                     const float* x,
+                     MKL_INT incx,
+                     float beta,
+                     float* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    native_symv(uplo, n, alpha, a, lda, x, incx, beta, y, incy);
+#else
+    // clang-format off
+    cblas_ssymv(
+        CblasColMajor, cblas_uplo(uplo), n, alpha, a, lda, x, incx, beta, y,
+        incy);
+    // clang-format on
+#endif
+}
+
+void srs::blas::symm(char side,
+                     char uplo,
+                     MKL_INT m,
+                     MKL_INT n,
+                     float alpha,
+                     const float* a,
+                     MKL_INT lda,
+                     const float* b,
+                     MKL_INT ldb,
+                     float beta,
+                     float* c,
+                     MKL_INT ldc)
+{
+#ifdef SRS_USE_NATIVE
+    native_symm(side, uplo, m, n, alpha, a, lda, b, ldb, beta, c, ldc);
+#else
+    // clang-format off
+    cblas_ssymm(
+        CblasColMajor, cblas_side(side), cblas_uplo(uplo), m, n, alpha, a,
+        lda, b, ldb, beta, c, ldc);
+    // clang-format on
+#endif
+}
+
+void srs::blas::symv(char uplo,
+                     MKL_INT n,
+                     double alpha,
+                     const double* a,
+                     MKL_INT lda,
+                     const double* x,
+                     MKL_INT incx,
+                     double beta,
+                     double* y,
+                     MKL_INT incy)
+{
+#ifdef SRS_USE_NATIVE
+    native_symv(uplo, n, alpha, a, lda, x, incx, beta, y, incy);
+#else
+    // clang-format off
+    cblas_dsymv(
+        CblasColMajor, cblas_uplo(uplo), n, alpha, a, lda, x, incx, beta, y,
+        incy);
+    // clang-format on
+#endif
+}
+
+void srs::blas::symm(char side,
+                     char uplo,
+                     MKL_INT m,
+                     MKL_INT n,
+                     double alpha,
+                     const double* a,
+                     MKL_INT lda,
+                     const double* b,
+                     MKL_INT ldb,
+                     double beta,
+                     double* c,
+                     MKL_INT ldc)
+{
+#ifdef SRS_USE_NATIVE
+    native_symm(side, uplo, m, n, alpha, a, lda, b, ldb, beta, c, ldc);
+#else
+    // clang-format off
+    cblas_dsymm(
+        CblasColMajor, cblas_side(side), cblas_uplo(uplo), m, n, alpha, a,
+        lda, b, ldb, beta, c, ldc);
+    // clang-format on
+#endif
+}
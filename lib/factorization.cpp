@@ -0,0 +1,693 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <srs/math_impl/backend.h>
+#include <srs/math_impl/core.h>
+#include <srs/math_impl/factorization.h>
+#include <algorithm>
+#include <cmath>
+#include <gsl/gsl>
+#include <limits>
+
+#ifdef SRS_HAVE_LAPACK
+
+//------------------------------------------------------------------------------
+// Cholesky factorization in full storage.
+
+void srs::Cholesky<srs::dmatrix>::factorize(const srs::dmatrix& a)
+{
+    Expects(a.rows() == a.cols());
+
+    u = a;
+
+    MKL_INT n    = u.rows();
+    MKL_INT info = LAPACKE_dpotrf(LAPACK_COL_MAJOR, 'U', n, u.data(), n);
+    if (info != 0) {
+        throw Math_error("dpotrf failed");
+    }
+    for (MKL_INT j = 0; j < n; ++j) {  // strictly lower triangle is not used
+        for (MKL_INT i = j + 1; i < n; ++i) {
+            u(i, j) = 0.0;
+        }
+    }
+}
+
+void srs::Cholesky<srs::dmatrix>::solve(srs::dmatrix& b) const
+{
+    Expects(b.rows() == u.rows());
+
+    MKL_INT n    = u.rows();
+    MKL_INT nrhs = b.cols();
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dpotrs(
+        LAPACK_COL_MAJOR, 'U', n, nrhs, u.data(), n, b.data(), n);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dpotrs failed");
+    }
+}
+
+void srs::Cholesky<srs::dmatrix>::solve(srs::dvector& b) const
+{
+    Expects(b.size() == u.rows());
+
+    MKL_INT n = u.rows();
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dpotrs(
+        LAPACK_COL_MAJOR, 'U', n, 1, u.data(), n, b.data(), n);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dpotrs failed");
+    }
+}
+
+void srs::Cholesky<srs::dmatrix>::update(const srs::dvector& x)
+{
+    Expects(x.size() == u.rows());
+
+    // Sequence of Givens rotations applied to the rows of u, O(n^2).
+    srs::dvector w = x;
+    srs::size_t n  = u.rows();
+    for (srs::size_t k = 0; k < n; ++k) {
+        double r = std::hypot(u(k, k), w(k));
+        double c = r / u(k, k);
+        double s = w(k) / u(k, k);
+        u(k, k)  = r;
+        for (srs::size_t j = k + 1; j < n; ++j) {
+            u(k, j) = (u(k, j) + s * w(j)) / c;
+            w(j)    = c * w(j) - s * u(k, j);
+        }
+    }
+}
+
+void srs::Cholesky<srs::dmatrix>::downdate(const srs::dvector& x)
+{
+    Expects(x.size() == u.rows());
+
+    // Hyperbolic rotations; u is left unchanged if the downdated matrix is
+    // not positive definite.
+    srs::dmatrix tmp = u;
+    srs::dvector w   = x;
+    srs::size_t n    = tmp.rows();
+    for (srs::size_t k = 0; k < n; ++k) {
+        double r2 = (tmp(k, k) - w(k)) * (tmp(k, k) + w(k));
+        if (r2 <= 0.0) {
+            throw Math_error(
+                "srs::Cholesky::downdate(): matrix is not positive definite");
+        }
+        double r  = std::sqrt(r2);
+        double c  = r / tmp(k, k);
+        double s  = w(k) / tmp(k, k);
+        tmp(k, k) = r;
+        for (srs::size_t j = k + 1; j < n; ++j) {
+            tmp(k, j) = (tmp(k, j) - s * w(j)) / c;
+            w(j)      = c * w(j) - s * tmp(k, j);
+        }
+    }
+    u.swap(tmp);
+}
+
+double srs::Cholesky<srs::dmatrix>::det() const
+{
+    double ddet = 1.0;
+    for (srs::size_t i = 0; i < u.rows(); ++i) {
+        ddet *= u(i, i);
+    }
+    return ddet * ddet;
+}
+
+//------------------------------------------------------------------------------
+// Cholesky factorization in packed storage.
+
+void srs::Cholesky<srs::packed_dmatrix>::factorize(const srs::packed_dmatrix& a)
+{
+    u = a;
+
+    MKL_INT n    = u.rows();
+    MKL_INT info = LAPACKE_dpptrf(LAPACK_COL_MAJOR, 'U', n, u.data());
+    if (info != 0) {
+        throw Math_error("dpptrf failed");
+    }
+}
+
+void srs::Cholesky<srs::packed_dmatrix>::solve(srs::dmatrix& b) const
+{
+    Expects(b.rows() == u.rows());
+
+    MKL_INT n    = u.rows();
+    MKL_INT nrhs = b.cols();
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dpptrs(
+        LAPACK_COL_MAJOR, 'U', n, nrhs, u.data(), b.data(), n);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dpptrs failed");
+    }
+}
+
+void srs::Cholesky<srs::packed_dmatrix>::solve(srs::dvector& b) const
+{
+    Expects(b.size() == u.rows());
+
+    MKL_INT n = u.rows();
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dpptrs(
+        LAPACK_COL_MAJOR, 'U', n, 1, u.data(), b.data(), n);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dpptrs failed");
+    }
+}
+
+void srs::Cholesky<srs::packed_dmatrix>::update(const srs::dvector& x)
+{
+    Expects(x.size() == u.rows());
+
+    // Same Givens rotations as in full storage; only the upper triangle of
+    // the packed factor is touched.
+    srs::dvector w = x;
+    srs::size_t n  = u.rows();
+    for (srs::size_t k = 0; k < n; ++k) {
+        double r = std::hypot(u(k, k), w(k));
+        double c = r / u(k, k);
+        double s = w(k) / u(k, k);
+        u(k, k)  = r;
+        for (srs::size_t j = k + 1; j < n; ++j) {
+            u(k, j) = (u(k, j) + s * w(j)) / c;
+            w(j)    = c * w(j) - s * u(k, j);
+        }
+    }
+}
+
+void srs::Cholesky<srs::packed_dmatrix>::downdate(const srs::dvector& x)
+{
+    Expects(x.size() == u.rows());
+
+    // Hyperbolic rotations; u is left unchanged if the downdated matrix is
+    // not positive definite.
+    srs::packed_dmatrix tmp = u;
+    srs::dvector w          = x;
+    srs::size_t n           = tmp.rows();
+    for (srs::size_t k = 0; k < n; ++k) {
+        double r2 = (tmp(k, k) - w(k)) * (tmp(k, k) + w(k));
+        if (r2 <= 0.0) {
+            throw Math_error(
+                "srs::Cholesky::downdate(): matrix is not positive definite");
+        }
+        double r  = std::sqrt(r2);
+        double c  = r / tmp(k, k);
+        double s  = w(k) / tmp(k, k);
+        tmp(k, k) = r;
+        for (srs::size_t j = k + 1; j < n; ++j) {
+            tmp(k, j) = (tmp(k, j) - s * w(j)) / c;
+            w(j)      = c * w(j) - s * tmp(k, j);
+        }
+    }
+    u.swap(tmp);
+}
+
+double srs::Cholesky<srs::packed_dmatrix>::det() const
+{
+    double ddet = 1.0;
+    for (srs::size_t i = 0; i < u.rows(); ++i) {
+        ddet *= u(i, i);
+    }
+    return ddet * ddet;
+}
+
+//------------------------------------------------------------------------------
+// Cholesky factorization in rectangular full packed storage.
+
+void srs::Cholesky<srs::rfp_dmatrix>::factorize(const srs::rfp_dmatrix& a)
+{
+    u = a;
+
+    MKL_INT n    = u.rows();
+    MKL_INT info = LAPACKE_dpftrf(LAPACK_COL_MAJOR, 'N', 'U', n, u.data());
+    if (info != 0) {
+        throw Math_error("dpftrf failed");
+    }
+}
+
+void srs::Cholesky<srs::rfp_dmatrix>::solve(srs::dmatrix& b) const
+{
+    Expects(b.rows() == u.rows());
+
+    MKL_INT n    = u.rows();
+    MKL_INT nrhs = b.cols();
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dpftrs(
+        LAPACK_COL_MAJOR, 'N', 'U', n, nrhs, u.data(), b.data(), n);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dpftrs failed");
+    }
+}
+
+void srs::Cholesky<srs::rfp_dmatrix>::solve(srs::dvector& b) const
+{
+    Expects(b.size() == u.rows());
+
+    MKL_INT n = u.rows();
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dpftrs(
+        LAPACK_COL_MAJOR, 'N', 'U', n, 1, u.data(), b.data(), n);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dpftrs failed");
+    }
+}
+
+double srs::Cholesky<srs::rfp_dmatrix>::det() const
+{
+    double ddet = 1.0;
+    for (srs::size_t i = 0; i < u.rows(); ++i) {
+        ddet *= u(i, i);
+    }
+    return ddet * ddet;
+}
+
+//------------------------------------------------------------------------------
+// Cholesky factorization in band storage.
+
+void srs::Cholesky<srs::band_dmatrix>::factorize(const srs::band_dmatrix& a)
+{
+    Expects(a.rows() == a.cols());
+    Expects(a.lower() == a.upper());
+
+    // Only the upper band is kept, the lower band is not referenced.
+    MKL_INT n  = a.rows();
+    MKL_INT kd = a.upper();
+
+    u = srs::band_dmatrix(n, n, 0, kd);
+    for (MKL_INT j = 0; j < n; ++j) {
+        for (MKL_INT i = std::max<MKL_INT>(0, j - kd); i <= j; ++i) {
+            u(i, j) = a(i, j);
+        }
+    }
+    MKL_INT ldab = u.leading_dim();
+    MKL_INT info = LAPACKE_dpbtrf(LAPACK_COL_MAJOR, 'U', n, kd, u.data(), ldab);
+    if (info != 0) {
+        throw Math_error("dpbtrf failed");
+    }
+}
+
+void srs::Cholesky<srs::band_dmatrix>::solve(srs::dmatrix& b) const
+{
+    Expects(b.rows() == u.rows());
+
+    MKL_INT n    = u.rows();
+    MKL_INT kd   = u.upper();
+    MKL_INT ldab = u.leading_dim();
+    MKL_INT nrhs = b.cols();
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dpbtrs(
+        LAPACK_COL_MAJOR, 'U', n, kd, nrhs, u.data(), ldab, b.data(), n);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dpbtrs failed");
+    }
+}
+
+void srs::Cholesky<srs::band_dmatrix>::solve(srs::dvector& b) const
+{
+    Expects(b.size() == u.rows());
+
+    MKL_INT n    = u.rows();
+    MKL_INT kd   = u.upper();
+    MKL_INT ldab = u.leading_dim();
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dpbtrs(
+        LAPACK_COL_MAJOR, 'U', n, kd, 1, u.data(), ldab, b.data(), n);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dpbtrs failed");
+    }
+}
+
+double srs::Cholesky<srs::band_dmatrix>::det() const
+{
+    double ddet = 1.0;
+    for (srs::size_t i = 0; i < u.rows(); ++i) {
+        ddet *= u(i, i);
+    }
+    return ddet * ddet;
+}
+
+//------------------------------------------------------------------------------
+// LDL^T factorization in full storage.
+
+void srs::Ldlt<srs::dmatrix>::factorize(const srs::dmatrix& a)
+{
+    Expects(a.rows() == a.cols());
+
+    ld = a;
+
+    MKL_INT n = ld.rows();
+    ipiv.resize(n);
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dsytrf(
+        LAPACK_COL_MAJOR, 'U', n, ld.data(), n, ipiv.data());
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dsytrf failed");
+    }
+}
+
+void srs::Ldlt<srs::dmatrix>::solve(srs::dmatrix& b) const
+{
+    Expects(b.rows() == ld.rows());
+
+    MKL_INT n    = ld.rows();
+    MKL_INT nrhs = b.cols();
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dsytrs(
+        LAPACK_COL_MAJOR, 'U', n, nrhs, ld.data(), n, ipiv.data(),
+        b.data(), n);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dsytrs failed");
+    }
+}
+
+void srs::Ldlt<srs::dmatrix>::solve(srs::dvector& b) const
+{
+    Expects(b.size() == ld.rows());
+
+    MKL_INT n = ld.rows();
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dsytrs(
+        LAPACK_COL_MAJOR, 'U', n, 1, ld.data(), n, ipiv.data(), b.data(), n);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dsytrs failed");
+    }
+}
+
+//------------------------------------------------------------------------------
+// LDL^T factorization in packed storage.
+
+void srs::Ldlt<srs::packed_dmatrix>::factorize(const srs::packed_dmatrix& a)
+{
+    ld = a;
+
+    MKL_INT n = ld.rows();
+    ipiv.resize(n);
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dsptrf(
+        LAPACK_COL_MAJOR, 'U', n, ld.data(), ipiv.data());
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dsptrf failed");
+    }
+}
+
+void srs::Ldlt<srs::packed_dmatrix>::solve(srs::dmatrix& b) const
+{
+    Expects(b.rows() == ld.rows());
+
+    MKL_INT n    = ld.rows();
+    MKL_INT nrhs = b.cols();
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dsptrs(
+        LAPACK_COL_MAJOR, 'U', n, nrhs, ld.data(), ipiv.data(), b.data(), n);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dsptrs failed");
+    }
+}
+
+void srs::Ldlt<srs::packed_dmatrix>::solve(srs::dvector& b) const
+{
+    Expects(b.size() == ld.rows());
+
+    MKL_INT n = ld.rows();
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dsptrs(
+        LAPACK_COL_MAJOR, 'U', n, 1, ld.data(), ipiv.data(), b.data(), n);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dsptrs failed");
+    }
+}
+
+//------------------------------------------------------------------------------
+// LU factorization in band storage.
+
+void srs::Lu<srs::band_dmatrix>::factorize(const srs::band_dmatrix& a)
+{
+    Expects(a.rows() == a.cols());
+
+    MKL_INT n  = a.rows();
+    MKL_INT kl = a.lower();
+    MKL_INT ku = a.upper();
+
+    // Storage for kl additional superdiagonals is needed by dgbtrf.
+    lu = srs::band_dmatrix(n, n, kl, kl + ku);
+    for (MKL_INT j = 0; j < n; ++j) {
+        MKL_INT ifirst = std::max<MKL_INT>(0, j - ku);
+        MKL_INT ilast  = std::min(n - 1, j + kl);
+        for (MKL_INT i = ifirst; i <= ilast; ++i) {
+            lu(i, j) = a(i, j);
+        }
+    }
+    ipiv.resize(n);
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dgbtrf(
+        LAPACK_COL_MAJOR, n, n, kl, ku, lu.data(), lu.leading_dim(),
+        ipiv.data());
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dgbtrf failed");
+    }
+}
+
+void srs::Lu<srs::band_dmatrix>::solve(srs::dmatrix& b) const
+{
+    Expects(b.rows() == lu.rows());
+
+    MKL_INT n    = lu.rows();
+    MKL_INT kl   = lu.lower();
+    MKL_INT ku   = lu.upper() - kl;
+    MKL_INT nrhs = b.cols();
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dgbtrs(
+        LAPACK_COL_MAJOR, 'N', n, kl, ku, nrhs, lu.data(), lu.leading_dim(),
+        ipiv.data(), b.data(), n);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dgbtrs failed");
+    }
+}
+
+void srs::Lu<srs::band_dmatrix>::solve(srs::dvector& b) const
+{
+    Expects(b.size() == lu.rows());
+
+    MKL_INT n  = lu.rows();
+    MKL_INT kl = lu.lower();
+    MKL_INT ku = lu.upper() - kl;
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dgbtrs(
+        LAPACK_COL_MAJOR, 'N', n, kl, ku, 1, lu.data(), lu.leading_dim(),
+        ipiv.data(), b.data(), n);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dgbtrs failed");
+    }
+}
+
+double srs::Lu<srs::band_dmatrix>::det() const
+{
+    double ddet = 1.0;
+    for (srs::size_t i = 0; i < lu.rows(); ++i) {
+        ddet *= lu(i, i);
+        if (ipiv(i) != i + 1) {
+            ddet = -ddet;
+        }
+    }
+    return ddet;
+}
+
+//------------------------------------------------------------------------------
+// QR factorization.
+
+void srs::Qr::factorize(const srs::dmatrix& a, bool pivot)
+{
+    qr       = a;
+    pivoting = pivot;
+
+    MKL_INT m = qr.rows();
+    MKL_INT n = qr.cols();
+    tau.resize(std::min(m, n));
+    jpvt.resize(n);
+
+    MKL_INT info;
+    if (pivoting) {
+        jpvt = 0;  // all columns are free
+        // clang-format off
+        info = LAPACKE_dgeqp3(
+            LAPACK_COL_MAJOR, m, n, qr.data(), m, jpvt.data(), tau.data());
+        // clang-format on
+        if (info != 0) {
+            throw Math_error("dgeqp3 failed");
+        }
+    }
+    else {
+        for (MKL_INT j = 0; j < n; ++j) {
+            jpvt(j) = j + 1;
+        }
+        info = LAPACKE_dgeqrf(LAPACK_COL_MAJOR, m, n, qr.data(), m, tau.data());
+        if (info != 0) {
+            throw Math_error("dgeqrf failed");
+        }
+    }
+}
+
+void srs::Qr::solve(srs::dmatrix& b) const
+{
+    Expects(qr.rows() >= qr.cols());
+    Expects(b.rows() == qr.rows());
+
+    MKL_INT m    = qr.rows();
+    MKL_INT n    = qr.cols();
+    MKL_INT nrhs = b.cols();
+
+    // Form q^T * b.
+    // clang-format off
+    MKL_INT info = LAPACKE_dormqr(
+        LAPACK_COL_MAJOR, 'L', 'T', m, nrhs, n, qr.data(), m, tau.data(),
+        b.data(), m);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dormqr failed");
+    }
+
+    // Back substitution with the leading k x k block of r.
+    MKL_INT k = pivoting ? rank() : n;
+    if (k > 0) {
+        // clang-format off
+        info = LAPACKE_dtrtrs(
+            LAPACK_COL_MAJOR, 'U', 'N', 'N', k, nrhs, qr.data(), m,
+            b.data(), m);
+        // clang-format on
+        if (info != 0) {
+            throw Math_error("srs::Qr::solve(): matrix is rank deficient");
+        }
+    }
+
+    srs::dmatrix x(n, nrhs, 0.0);
+    for (MKL_INT j = 0; j < nrhs; ++j) {
+        for (MKL_INT i = 0; i < k; ++i) {
+            x(jpvt(i) - 1, j) = b(i, j);  // Fortran uses base 1
+        }
+    }
+    b.swap(x);
+}
+
+void srs::Qr::solve(srs::dvector& b) const
+{
+    Expects(b.size() == qr.rows());
+
+    srs::dmatrix tmp(b.size(), 1, b.data());
+    solve(tmp);
+    b.resize(tmp.rows());
+    for (srs::size_t i = 0; i < tmp.rows(); ++i) {
+        b(i) = tmp(i, 0);
+    }
+}
+
+srs::dmatrix srs::Qr::q() const
+{
+    MKL_INT m = qr.rows();
+    MKL_INT n = qr.cols();
+    MKL_INT k = std::min(m, n);
+
+    srs::dmatrix res(m, k);
+    for (MKL_INT j = 0; j < k; ++j) {
+        for (MKL_INT i = 0; i < m; ++i) {
+            res(i, j) = qr(i, j);
+        }
+    }
+    // clang-format off
+    MKL_INT info = LAPACKE_dorgqr(
+        LAPACK_COL_MAJOR, m, k, k, res.data(), m, tau.data());
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dorgqr failed");
+    }
+    return res;
+}
+
+srs::dmatrix srs::Qr::r() const
+{
+    srs::size_t k = std::min(qr.rows(), qr.cols());
+
+    srs::dmatrix res(k, qr.cols(), 0.0);
+    for (srs::size_t j = 0; j < qr.cols(); ++j) {
+        for (srs::size_t i = 0; i <= std::min(j, k - 1); ++i) {
+            res(i, j) = qr(i, j);
+        }
+    }
+    return res;
+}
+
+srs::ivector srs::Qr::permutation() const
+{
+    srs::ivector res(jpvt.size());
+    for (srs::size_t j = 0; j < jpvt.size(); ++j) {
+        res(j) = jpvt(j) - 1;
+    }
+    return res;
+}
+
+srs::Int_t srs::Qr::rank(double tol) const
+{
+    srs::size_t k = std::min(qr.rows(), qr.cols());
+    if (k == 0) {
+        return 0;
+    }
+    if (tol < 0.0) {
+        tol = std::max(qr.rows(), qr.cols())
+              * std::numeric_limits<double>::epsilon() * std::abs(qr(0, 0));
+    }
+    srs::size_t r = 0;
+    for (srs::size_t i = 0; i < k; ++i) {
+        if (std::abs(qr(i, i)) > tol) {
+            ++r;
+        }
+    }
+    return r;
+}
+
+#endif  // SRS_HAVE_LAPACK
@@ -14,13 +14,17 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <mkl.h>
+#include <srs/math_impl/backend.h>
+#include <srs/math_impl/blas.h>
 #include <srs/math_impl/core.h>
 #include <srs/math_impl/linalg.h>
+#include <algorithm>
 #include <cmath>
 #include <gsl/gsl>
 #include <iostream>
+#include <limits>
 #include <random>
+#include <string>
 
 
 srs::dmatrix srs::hilbert(int n)
@@ -97,6 +101,104 @@ srs::dmatrix srs::randu(int m, int n)
 
 //------------------------------------------------------------------------------
 
+#ifndef SRS_HAVE_LAPACK
+namespace {
+
+// Native LU factorization with partial pivoting, a = p * l * u, using the
+// same storage and one-based pivot indices as dgetrf. Returns info as
+// dgetrf.
+MKL_INT getrf(srs::dmatrix& a, srs::ivector& ipiv)
+{
+    MKL_INT m    = a.rows();
+    MKL_INT n    = a.cols();
+    MKL_INT info = 0;
+    for (MKL_INT k = 0; k < std::min(m, n); ++k) {
+        MKL_INT p = k;
+        for (MKL_INT i = k + 1; i < m; ++i) {
+            if (std::abs(a(i, k)) > std::abs(a(p, k))) {
+                p = i;
+            }
+        }
+        ipiv(k) = p + 1;  // Fortran uses base 1
+        if (a(p, k) == 0.0) {
+            if (info == 0) {
+                info = k + 1;
+            }
+            continue;
+        }
+        if (p != k) {
+            for (MKL_INT j = 0; j < n; ++j) {
+                std::swap(a(k, j), a(p, j));
+            }
+        }
+        for (MKL_INT i = k + 1; i < m; ++i) {
+            a(i, k) /= a(k, k);
+        }
+        for (MKL_INT j = k + 1; j < n; ++j) {
+            double akj = a(k, j);
+            for (MKL_INT i = k + 1; i < m; ++i) {
+                a(i, j) -= a(i, k) * akj;
+            }
+        }
+    }
+    return info;
+}
+
+// Solve a * x = b using the LU factorization computed by getrf().
+void getrs(const srs::dmatrix& lu, const srs::ivector& ipiv, srs::dmatrix& b)
+{
+    MKL_INT n = lu.rows();
+    for (MKL_INT j = 0; j < b.cols(); ++j) {
+        for (MKL_INT k = 0; k < n; ++k) {
+            std::swap(b(k, j), b(ipiv(k) - 1, j));
+        }
+        for (MKL_INT k = 0; k < n; ++k) {  // forward substitution
+            for (MKL_INT i = k + 1; i < n; ++i) {
+                b(i, j) -= lu(i, k) * b(k, j);
+            }
+        }
+        for (MKL_INT k = n - 1; k >= 0; --k) {  // back substitution
+            b(k, j) /= lu(k, k);
+            for (MKL_INT i = 0; i < k; ++i) {
+                b(i, j) -= lu(i, k) * b(k, j);
+            }
+        }
+    }
+}
+
+}  // namespace
+#endif  // SRS_HAVE_LAPACK
+
+#ifdef SRS_HAVE_LAPACK
+void srs::sfrk(char trans,
+               double alpha,
+               const srs::dmatrix& a,
+               double beta,
+               srs::rfp_dmatrix& c)
+{
+    const bool ta = (trans == 'T') || (trans == 't');
+
+    MKL_INT n   = ta ? a.cols() : a.rows();
+    MKL_INT k   = ta ? a.rows() : a.cols();
+    MKL_INT lda = std::max<MKL_INT>(1, a.rows());
+
+    if (c.empty()) {
+        c.resize(n);
+        c = 0.0;
+    }
+    Expects(c.rows() == n);
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dsfrk(
+        LAPACK_COL_MAJOR, 'N', 'U', ta ? 'T' : 'N', n, k, alpha, a.data(),
+        lda, beta, c.data());
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dsfrk failed");
+    }
+}
+#endif  // SRS_HAVE_LAPACK
+
 double srs::det(const srs::dmatrix& a)
 {
     Expects(a.rows() == a.cols());
@@ -148,11 +250,17 @@ void srs::inv(srs::dmatrix& a)
     srs::ivector ipiv(n);
     lu(a, ipiv);  // perform LU factorization
 
+#ifdef SRS_HAVE_LAPACK
     MKL_INT info
         = LAPACKE_dgetri(LAPACK_COL_MAJOR, n, a.data(), n, ipiv.data());
     if (info != 0) {
         throw Math_error("dgetri: matrix inversion failed");
     }
+#else
+    srs::dmatrix ainv = srs::identity(n);
+    getrs(a, ipiv, ainv);
+    a.swap(ainv);
+#endif
 }
 
 //------------------------------------------------------------------------------
@@ -163,8 +271,12 @@ void srs::lu(srs::dmatrix& a, srs::ivector& ipiv)
     MKL_INT n = a.cols();
     ipiv.resize(std::min(m, n));
 
+#ifdef SRS_HAVE_LAPACK
     MKL_INT info
         = LAPACKE_dgetrf(LAPACK_COL_MAJOR, m, n, a.data(), m, ipiv.data());
+#else
+    MKL_INT info = getrf(a, ipiv);
+#endif
     if (info < 0) {
         throw Math_error("dgetrf: illegal input parameter");
     }
@@ -175,31 +287,277 @@ void srs::lu(srs::dmatrix& a, srs::ivector& ipiv)
 
 //------------------------------------------------------------------------------
 
-void srs::eigs(srs::dmatrix& a, srs::dvector& wr)
+#ifdef SRS_HAVE_LAPACK
+void srs::svd(srs::dmatrix& a,
+              srs::dmatrix& u,
+              srs::dvector& s,
+              srs::dmatrix& vt)
+{
+    MKL_INT m = a.rows();
+    MKL_INT n = a.cols();
+    MKL_INT k = std::min(m, n);
+
+    u.resize(m, k);
+    s.resize(k);
+    vt.resize(k, n);
+
+    MKL_INT lda  = std::max<MKL_INT>(m, 1);  // LAPACK requires lda >= 1
+    MKL_INT ldvt = std::max<MKL_INT>(k, 1);
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dgesdd(
+        LAPACK_COL_MAJOR, 'S', m, n, a.data(), lda, s.data(), u.data(), lda,
+        vt.data(), ldvt);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dgesdd failed");
+    }
+}
+
+void srs::svdvals(srs::dmatrix& a, srs::dvector& s)
+{
+    MKL_INT m = a.rows();
+    MKL_INT n = a.cols();
+
+    MKL_INT lda = std::max<MKL_INT>(m, 1);  // LAPACK requires lda >= 1
+
+    s.resize(std::min(m, n));
+
+    double udummy;
+    double vtdummy;
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dgesdd(
+        LAPACK_COL_MAJOR, 'N', m, n, a.data(), lda, s.data(), &udummy, 1,
+        &vtdummy, 1);
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dgesdd failed");
+    }
+}
+
+namespace {
+
+// Replace the columns of y by an orthonormal basis for their span.
+void orth(srs::dmatrix& y)
+{
+    MKL_INT m = y.rows();
+    MKL_INT n = y.cols();
+
+    srs::dvector tau(n);
+    MKL_INT info
+        = LAPACKE_dgeqrf(LAPACK_COL_MAJOR, m, n, y.data(), m, tau.data());
+    if (info != 0) {
+        throw srs::Math_error("dgeqrf failed");
+    }
+    info = LAPACKE_dorgqr(LAPACK_COL_MAJOR, m, n, n, y.data(), m, tau.data());
+    if (info != 0) {
+        throw srs::Math_error("dorgqr failed");
+    }
+}
+
+}  // namespace
+
+void srs::svd_rand(const srs::dmatrix& a,
+                   srs::dmatrix& u,
+                   srs::dvector& s,
+                   srs::dmatrix& vt,
+                   int k,
+                   int p,
+                   int q)
+{
+    Expects(k > 0 && k <= std::min(a.rows(), a.cols()));
+    Expects(p >= 0 && q >= 0);
+
+    const int m = a.rows();
+    const int n = a.cols();
+    const int l = std::min(k + p, std::min(m, n));
+
+    // Sample the range of a with a random test matrix.
+    srs::dmatrix omega = srs::randu(n, l);
+    omega *= 2.0;
+    omega -= 1.0;
+
+    srs::dmatrix y(m, l);
+    srs::mkl_dgemm("N", "N", 1.0, a, omega, 0.0, y);
+    orth(y);
+
+    // Power iterations sharpen the decay of the spectrum.
+    srs::dmatrix z(n, l);
+    for (int i = 0; i < q; ++i) {
+        srs::mkl_dgemm("T", "N", 1.0, a, y, 0.0, z);
+        orth(z);
+        srs::mkl_dgemm("N", "N", 1.0, a, z, 0.0, y);
+        orth(y);
+    }
+
+    // Project a onto the range, b = y^T * a, and decompose the small matrix.
+    srs::dmatrix b(l, n);
+    srs::mkl_dgemm("T", "N", 1.0, y, a, 0.0, b);
+
+    srs::dmatrix ub;
+    srs::dvector sb;
+    srs::dmatrix vtb;
+    srs::svd(b, ub, sb, vtb);
+
+    srs::dmatrix uy(m, l);
+    srs::mkl_dgemm("N", "N", 1.0, y, ub, 0.0, uy);
+
+    // Truncate to the k largest singular triplets.
+    u.resize(m, k);
+    s.resize(k);
+    vt.resize(k, n);
+    for (int j = 0; j < k; ++j) {
+        s(j) = sb(j);
+        for (int i = 0; i < m; ++i) {
+            u(i, j) = uy(i, j);
+        }
+    }
+    for (int j = 0; j < n; ++j) {
+        for (int i = 0; i < k; ++i) {
+            vt(i, j) = vtb(i, j);
+        }
+    }
+}
+
+srs::dmatrix srs::pinv(const srs::dmatrix& a, double tol)
+{
+    srs::dmatrix tmp = a;
+    srs::dmatrix u;
+    srs::dvector s;
+    srs::dmatrix vt;
+    srs::svd(tmp, u, s, vt);
+
+    if (tol < 0.0 && s.size() > 0) {
+        tol = std::max(a.rows(), a.cols())
+              * std::numeric_limits<double>::epsilon() * s(0);
+    }
+
+    // Form v * diag(1 / s) * u^T by scaling the columns of u.
+    for (srs::size_t j = 0; j < s.size(); ++j) {
+        double sinv = (s(j) > tol) ? 1.0 / s(j) : 0.0;
+        for (srs::size_t i = 0; i < u.rows(); ++i) {
+            u(i, j) *= sinv;
+        }
+    }
+    srs::dmatrix result(a.cols(), a.rows());
+    srs::mkl_dgemm("T", "T", 1.0, vt, u, 0.0, result);
+    return result;
+}
+#endif  // SRS_HAVE_LAPACK
+
+//------------------------------------------------------------------------------
+
+#ifdef SRS_HAVE_LAPACK
+namespace {
+
+// Helper function for computing all or selected eigenvalues and, optionally,
+// eigenvectors of a real symmetric matrix. The eigenvectors are written
+// directly to z. Returns the number of eigenvalues found.
+MKL_INT syevr(char jobz,
+              char range,
+              srs::dmatrix& a,
+              double vl,
+              double vu,
+              MKL_INT il,
+              MKL_INT iu,
+              srs::dvector& w,
+              double* z,
+              MKL_INT ldz)
 {
     Expects(a.rows() == a.cols());
 
-    MKL_INT n  = a.rows();
-    MKL_INT il = 1;
-    MKL_INT iu = n;
+    MKL_INT n = a.rows();
+    MKL_INT m = 0;
 
-    wr.resize(n);
-    srs::dmatrix z(n, n);
-    srs::ivector isuppz(2 * n);
+    w.resize(n);
+    srs::ivector isuppz(2 * std::max<MKL_INT>(n, 1));
 
     double abstol = -1.0;  // use default value
-    double vl     = 0.0;
-    double vu     = 0.0;
+    double zdummy = 0.0;   // not referenced if jobz = 'N'
+    if (jobz == 'N') {
+        z   = &zdummy;
+        ldz = 1;
+    }
 
     // clang-format off
     MKL_INT info = LAPACKE_dsyevr(
-        LAPACK_COL_MAJOR, 'V', 'A', 'U', n, a.data(), n, vl, vu, il, iu, abstol, 
-        &n, wr.data(), z.data(), n, isuppz.data());
+        LAPACK_COL_MAJOR, jobz, range, 'U', n, a.data(), n, vl, vu, il, iu, 
+        abstol, &m, w.data(), z, ldz, isuppz.data());
     // clang-format on
     if (info != 0) {
-        throw Math_error("dsyevr failed");
+        throw srs::Math_error("dsyevr failed");
+    }
+    w.resize(m);  // shrinking does not reallocate
+    return m;
+}
+
+}  // namespace
+#endif  // SRS_HAVE_LAPACK
+
+void srs::eigs(srs::dmatrix& a, srs::dvector& wr)
+{
+    Expects(a.rows() == a.cols());
+
+#ifdef SRS_HAVE_LAPACK
+    MKL_INT n = a.rows();
+    srs::dmatrix z(n, n);
+
+    syevr('V', 'A', a, 0.0, 0.0, 1, n, wr, z.data(), n);
+    a.swap(z);
+#else
+    srs::jacobi(a, wr);
+#endif
+}
+
+#ifdef SRS_HAVE_LAPACK
+
+void srs::eigs(
+    srs::dmatrix& a, srs::dmatrix& v, srs::dvector& w, int il, int iu)
+{
+    Expects(a.rows() == a.cols());
+    Expects(il >= 0 && il <= iu && iu < a.rows());
+
+    MKL_INT n = a.rows();
+    MKL_INT k = iu - il + 1;
+
+    if (v.rows() != n || v.cols() != k) {
+        v.resize(n, k);
     }
-    a = z;
+    MKL_INT m = syevr('V', 'I', a, 0.0, 0.0, il + 1, iu + 1, w, v.data(), n);
+    Ensures(m == k);
+}
+
+void srs::eigs(
+    double vl, double vu, srs::dmatrix& a, srs::dmatrix& v, srs::dvector& w)
+{
+    Expects(a.rows() == a.cols());
+    Expects(vl < vu);
+
+    MKL_INT n = a.rows();
+
+    // The number of eigenvalues in (vl, vu] is not known in advance, hence
+    // room for n eigenvectors is needed. The first m columns are kept.
+    v.resize(n, n);
+    MKL_INT m = syevr('V', 'V', a, vl, vu, 1, n, w, v.data(), n);
+    v.resize(n, m);
+}
+
+void srs::eigvals(srs::dmatrix& a, srs::dvector& w)
+{
+    syevr('N', 'A', a, 0.0, 0.0, 1, a.rows(), w, nullptr, 1);
+}
+
+void srs::eigvals(srs::dmatrix& a, srs::dvector& w, int il, int iu)
+{
+    Expects(il >= 0 && il <= iu && iu < a.rows());
+    syevr('N', 'I', a, 0.0, 0.0, il + 1, iu + 1, w, nullptr, 1);
+}
+
+void srs::eigvals(double vl, double vu, srs::dmatrix& a, srs::dvector& w)
+{
+    Expects(vl < vu);
+    syevr('N', 'V', a, vl, vu, 1, a.rows(), w, nullptr, 1);
 }
 
 void srs::eigs(srs::band_dmatrix& ab, srs::dmatrix& v, srs::dvector& w)
@@ -244,13 +602,29 @@ void srs::eigs(srs::packed_dmatrix& ap, srs::dmatrix& v, srs::dvector& w)
     }
 }
 
+void srs::eigs(const srs::rfp_dmatrix& a, srs::dmatrix& v, srs::dvector& w)
+{
+    MKL_INT n = a.rows();
+    srs::dmatrix tmp(n, n);
+
+    // clang-format off
+    MKL_INT info = LAPACKE_dtfttr(
+        LAPACK_COL_MAJOR, 'N', 'U', n, a.data(), tmp.data(),
+        std::max<MKL_INT>(1, n));
+    // clang-format on
+    if (info != 0) {
+        throw Math_error("dtfttr failed");
+    }
+    v.resize(n, n);
+    syevr('V', 'A', tmp, 0.0, 0.0, 1, n, w, v.data(), n);
+}
+
 void srs::eig(srs::dmatrix& a, srs::zmatrix& v, srs::zvector& w)
 {
     Expects(a.rows() == a.cols());
 
-    MKL_INT n     = a.cols();
-    MKL_INT lwork = 4 * n;
-    MKL_INT info  = 0;
+    MKL_INT n    = a.cols();
+    MKL_INT info = 0;
 
     if (w.size() != a.cols()) {
         w.resize(a.cols());
@@ -259,12 +633,11 @@ void srs::eig(srs::dmatrix& a, srs::zmatrix& v, srs::zvector& w)
     srs::dvector wi(n);
     srs::dmatrix vr(n, n);
     srs::dmatrix vl(n, n);
-    srs::dvector work(lwork);
 
     // clang-format off
-    dgeev(
-        "N", "V", &n, a.data(), &n, wr.data(), wi.data(), vl.data(), &n, 
-        vr.data(), &n, work.data(), &lwork, &info);
+    info = LAPACKE_dgeev(
+        LAPACK_COL_MAJOR, 'N', 'V', n, a.data(), n, wr.data(), wi.data(),
+        vl.data(), n, vr.data(), n);
     // clang-format on
     if (info != 0) {
         throw Math_error("dgeev failed");
@@ -285,6 +658,9 @@ void srs::eig(srs::dmatrix& a, srs::zmatrix& v, srs::zvector& w)
     }
 }
 
+#endif  // SRS_HAVE_LAPACK
+
+#ifdef SRS_USE_MKL
 void srs::eig(double emin,
               double emax,
               const srs::band_dmatrix& ab,
@@ -330,11 +706,20 @@ void srs::eig(double emin,
     v = v.slice(0, n - 1, 0, m - 1);
 }
 
-void srs::eig(double emin,
-              double emax,
-              const srs::sparse_dmatrix& a,
-              srs::dmatrix& v,
-              srs::dvector& w)
+namespace {
+
+// Compute eigenvalues in [emin, emax] and eigenvectors of a real symmetric
+// matrix in one-based CSR format using FEAST. If uplo is "F", the full
+// matrix is stored, and if uplo is "U" only the upper triangle.
+void feast_csr(const char* uplo,
+               MKL_INT n,
+               const double* a,
+               const MKL_INT* ia,
+               const MKL_INT* ja,
+               double emin,
+               double emax,
+               srs::dmatrix& v,
+               srs::dvector& w)
 {
     // Initialize FEAST:
 
@@ -346,14 +731,10 @@ void srs::eig(double emin,
 
     // Solve eigenvalue problem:
 
-    MKL_INT n    = a.cols();  // size of the problem
-    MKL_INT m0   = n;         // initial guess for subspace dimension
-    MKL_INT loop = 0;         // number of refinement loops
-    MKL_INT m    = m0;        // total number of eigenvalues found
-    MKL_INT info = 0;         // error code
-
-    auto ia = a.row_index_one_based();  // FEAST only support one-based indexing
-    auto ja = a.columns_one_based();
+    MKL_INT m0   = n;   // initial guess for subspace dimension
+    MKL_INT loop = 0;   // number of refinement loops
+    MKL_INT m    = m0;  // total number of eigenvalues found
+    MKL_INT info = 0;   // error code
 
     double epsout = 0.0;   // relative error on the trace (not returned)
     srs::dvector res(m0);  // residual vector (not returned)
@@ -363,11 +744,11 @@ void srs::eig(double emin,
 
     // clang-format off
     dfeast_scsrev(
-        "F", &n, a.data(), ia.data(), ja.data(), (MKL_INT*)fpm, &epsout, &loop, 
-        &emin, &emax, &m0, w.data(), v.data(), &m, res.data(), &info);
+        uplo, &n, a, ia, ja, (MKL_INT*)fpm, &epsout, &loop, &emin, &emax,
+        &m0, w.data(), v.data(), &m, res.data(), &info);
     // clang-format on
     if (info != 0) {
-        throw Math_error("dfeast_scsrev failed");
+        throw srs::Math_error("dfeast_scsrev failed");
     }
 
     // Return the m first eigenvalues and eigenvectors:
@@ -376,6 +757,32 @@ void srs::eig(double emin,
     v = v.slice(0, n - 1, 0, m - 1);
 }
 
+}  // namespace
+
+void srs::eig(double emin,
+              double emax,
+              const srs::sparse_dmatrix& a,
+              srs::dmatrix& v,
+              srs::dvector& w)
+{
+    auto ia = a.row_index_one_based();  // FEAST only support one-based indexing
+    auto ja = a.columns_one_based();
+    feast_csr("F", a.cols(), a.data(), ia.data(), ja.data(), emin, emax, v, w);
+}
+
+void srs::eig(double emin,
+              double emax,
+              const srs::sym_sparse_dmatrix& a,
+              srs::dmatrix& v,
+              srs::dvector& w)
+{
+    auto ia = a.row_index_one_based();  // FEAST only support one-based indexing
+    auto ja = a.columns_one_based();
+    feast_csr("U", a.cols(), a.data(), ia.data(), ja.data(), emin, emax, v, w);
+}
+
+#endif  // SRS_USE_MKL
+
 void srs::jacobi(srs::dmatrix& a, srs::dvector& wr)
 {
     // Algorithm:
@@ -549,32 +956,400 @@ void srs::linsolve(srs::dmatrix& a, srs::dmatrix& b)
     Expects(a.rows() == a.cols());
     Expects(b.rows() == a.cols());
 
-    MKL_INT n    = a.cols();
+    MKL_INT n = a.cols();
+
+    srs::ivector ipiv(n);
+
+#ifdef SRS_HAVE_LAPACK
     MKL_INT lda  = a.rows();
     MKL_INT ldb  = b.rows();
     MKL_INT nrhs = b.cols();
 
-    srs::ivector ipiv(n);
-
     MKL_INT info = LAPACKE_dgesv(
         LAPACK_COL_MAJOR, n, nrhs, a.data(), lda, ipiv.data(), b.data(), ldb);
+#else
+    MKL_INT info = getrf(a, ipiv);
+    if (info == 0) {
+        getrs(a, ipiv, b);
+    }
+#endif
     if (info != 0) {
         throw Math_error("dgesv: factor U is singular");
     }
 }
 
-void srs::linsolve(const srs::sparse_dmatrix& a,
+namespace {
+
+#ifdef SRS_HAVE_LAPACK
+// Helper function for solving a band system with nrhs right-hand sides
+// stored in b with leading dimension n.
+void gbsv(const srs::band_dmatrix& a, double* b, MKL_INT nrhs)
+{
+    Expects(a.rows() == a.cols());
+
+    MKL_INT n  = a.rows();
+    MKL_INT kl = a.lower();
+    MKL_INT ku = a.upper();
+
+    if (n == 0 || nrhs == 0) {
+        return;
+    }
+
+    MKL_INT info = 0;
+    if (kl == 1 && ku == 1) {
+        srs::dvector dl(n - 1);
+        srs::dvector d(n);
+        srs::dvector du(n - 1);
+        for (MKL_INT i = 0; i < n; ++i) {
+            d(i) = a(i, i);
+            if (i < n - 1) {
+                dl(i) = a(i + 1, i);
+                du(i) = a(i, i + 1);
+            }
+        }
+        // clang-format off
+        info = LAPACKE_dgtsv(
+            LAPACK_COL_MAJOR, n, nrhs, dl.data(), d.data(), du.data(), b, n);
+        // clang-format on
+    }
+    else {
+        // dgbsv needs kl additional superdiagonals for the fill-in.
+        srs::band_dmatrix lu(n, n, kl, kl + ku);
+        for (MKL_INT j = 0; j < n; ++j) {
+            MKL_INT ifirst = std::max<MKL_INT>(0, j - ku);
+            MKL_INT ilast  = std::min(n - 1, j + kl);
+            for (MKL_INT i = ifirst; i <= ilast; ++i) {
+                lu(i, j) = a(i, j);
+            }
+        }
+        srs::ivector ipiv(n);
+        // clang-format off
+        info = LAPACKE_dgbsv(
+            LAPACK_COL_MAJOR, n, kl, ku, nrhs, lu.data(), lu.leading_dim(),
+            ipiv.data(), b, n);
+        // clang-format on
+    }
+    if (info != 0) {
+        throw srs::Math_error("dgbsv: factor U is singular");
+    }
+}
+#endif  // SRS_HAVE_LAPACK
+
+// Thomas algorithm for the tridiagonal system with subdiagonal dl,
+// diagonal d and superdiagonal du (dl(0) and du(n - 1) are zero).
+void thomas(const srs::dvector& dl,
+            const srs::dvector& d,
+            const srs::dvector& du,
+            double* b,
+            srs::size_t nrhs)
+{
+    const srs::size_t n = d.size();
+
+    // Forward elimination of the matrix, shared by all right-hand sides.
+    srs::dvector cp(n);
+    srs::dvector winv(n);
+    for (srs::size_t i = 0; i < n; ++i) {
+        double w = d(i);
+        if (i > 0) {
+            w -= dl(i) * cp(i - 1);
+        }
+        if (w == 0.0) {
+            throw srs::Math_error("srs::linsolve_tridiag(): zero pivot");
+        }
+        winv(i) = 1.0 / w;
+        cp(i)   = du(i) * winv(i);
+    }
+
+#pragma omp parallel for if (nrhs > 1)
+    for (srs::size_t k = 0; k < nrhs; ++k) {
+        double* x = b + k * n;
+        x[0] *= winv(0);
+        for (srs::size_t i = 1; i < n; ++i) {
+            x[i] = (x[i] - dl(i) * x[i - 1]) * winv(i);
+        }
+        for (srs::size_t i = n - 2; i >= 0; --i) {
+            x[i] -= cp(i) * x[i + 1];
+        }
+    }
+}
+
+// Parallel cyclic reduction for the tridiagonal system with subdiagonal dl,
+// diagonal d and superdiagonal du. Each step eliminates the couplings to the
+// equations at distance s and doubles s, which decouples all equations after
+// ceil(log2(n)) steps.
+void pcr(srs::dvector& dl,
+         srs::dvector& d,
+         srs::dvector& du,
+         double* b,
+         srs::size_t nrhs)
+{
+    const srs::size_t n = d.size();
+
+    srs::dmatrix r(n, nrhs, b);
+    srs::dmatrix r2(n, nrhs);
+    srs::dvector dl2(n);
+    srs::dvector d2(n);
+    srs::dvector du2(n);
+
+    for (srs::size_t s = 1; s < n; s *= 2) {
+        int failed = 0;
+
+#pragma omp parallel for reduction(+ : failed)
+        for (srs::size_t i = 0; i < n; ++i) {
+            double alpha = 0.0;
+            double gamma = 0.0;
+            d2(i)        = d(i);
+            dl2(i)       = 0.0;
+            du2(i)       = 0.0;
+            if (i - s >= 0) {
+                if (d(i - s) == 0.0) {
+                    ++failed;
+                    continue;
+                }
+                alpha  = -dl(i) / d(i - s);
+                dl2(i) = alpha * dl(i - s);
+                d2(i) += alpha * du(i - s);
+            }
+            if (i + s < n) {
+                if (d(i + s) == 0.0) {
+                    ++failed;
+                    continue;
+                }
+                gamma  = -du(i) / d(i + s);
+                du2(i) = gamma * du(i + s);
+                d2(i) += gamma * dl(i + s);
+            }
+            for (srs::size_t k = 0; k < nrhs; ++k) {
+                r2(i, k) = r(i, k);
+                if (i - s >= 0) {
+                    r2(i, k) += alpha * r(i - s, k);
+                }
+                if (i + s < n) {
+                    r2(i, k) += gamma * r(i + s, k);
+                }
+            }
+        }
+        if (failed > 0) {
+            throw srs::Math_error("srs::linsolve_tridiag(): zero pivot");
+        }
+        r.swap(r2);
+        dl.swap(dl2);
+        d.swap(d2);
+        du.swap(du2);
+    }
+
+    for (srs::size_t k = 0; k < nrhs; ++k) {
+        for (srs::size_t i = 0; i < n; ++i) {
+            if (d(i) == 0.0) {
+                throw srs::Math_error("srs::linsolve_tridiag(): zero pivot");
+            }
+            b[i + k * n] = r(i, k) / d(i);
+        }
+    }
+}
+
+// Helper function for solving a tridiagonal system with nrhs right-hand
+// sides stored in b with leading dimension n.
+void tridiag(const srs::band_dmatrix& a,
+             double* b,
+             srs::size_t nrhs,
+             srs::Tridiag_t method)
+{
+    Expects(a.rows() == a.cols());
+    Expects(a.lower() == 1 && a.upper() == 1);
+
+    const srs::size_t n = a.rows();
+    if (n == 0 || nrhs == 0) {
+        return;
+    }
+
+    srs::dvector dl(n, 0.0);
+    srs::dvector d(n);
+    srs::dvector du(n, 0.0);
+    for (srs::size_t i = 0; i < n; ++i) {
+        d(i) = a(i, i);
+        if (i > 0) {
+            dl(i) = a(i, i - 1);
+        }
+        if (i < n - 1) {
+            du(i) = a(i, i + 1);
+        }
+    }
+
+    if (method == srs::Pcr) {
+        pcr(dl, d, du, b, nrhs);
+    }
+    else {
+        thomas(dl, d, du, b, nrhs);
+    }
+}
+
+}  // namespace
+
+#ifdef SRS_HAVE_LAPACK
+void srs::linsolve(const srs::band_dmatrix& a, srs::dmatrix& b)
+{
+    Expects(b.rows() == a.cols());
+    gbsv(a, b.data(), b.cols());
+}
+
+void srs::linsolve(const srs::band_dmatrix& a, srs::dvector& b)
+{
+    Expects(b.size() == a.cols());
+    gbsv(a, b.data(), 1);
+}
+#endif  // SRS_HAVE_LAPACK
+
+void srs::linsolve_tridiag(const srs::band_dmatrix& a,
+                           srs::dmatrix& b,
+                           srs::Tridiag_t method)
+{
+    Expects(b.rows() == a.cols());
+    tridiag(a, b.data(), b.cols(), method);
+}
+
+void srs::linsolve_tridiag(const srs::band_dmatrix& a,
+                           srs::dvector& b,
+                           srs::Tridiag_t method)
+{
+    Expects(b.size() == a.cols());
+    tridiag(a, b.data(), 1, method);
+}
+
+#ifdef SRS_HAVE_LAPACK
+namespace {
+
+// Largest relative residual ||r_j||_inf / (||a||_inf * ||x_j||_inf) over
+// the columns j of the solution x.
+double relative_residual(const srs::dmatrix& r,
+                         const srs::dmatrix& x,
+                         double anorm)
+{
+    double result = 0.0;
+    for (srs::size_t j = 0; j < r.cols(); ++j) {
+        double rnorm = 0.0;
+        double xnorm = 0.0;
+        for (srs::size_t i = 0; i < r.rows(); ++i) {
+            rnorm = std::max(rnorm, std::abs(r(i, j)));
+            xnorm = std::max(xnorm, std::abs(x(i, j)));
+        }
+        if (rnorm > 0.0) {
+            if (xnorm * anorm == 0.0) {
+                return std::numeric_limits<double>::infinity();
+            }
+            result = std::max(result, rnorm / (xnorm * anorm));
+        }
+    }
+    return result;
+}
+
+}  // namespace
+
+int srs::linsolve_mixed(const srs::dmatrix& a,
+                        srs::dmatrix& b,
+                        double tol,
+                        int max_iter)
+{
+    Expects(a.rows() == a.cols());
+    Expects(b.rows() == a.cols());
+
+    const MKL_INT n    = a.cols();
+    const MKL_INT nrhs = b.cols();
+
+    if (a.empty() || b.empty()) {
+        return 0;
+    }
+    if (tol < 0.0) {
+        tol = std::sqrt(static_cast<double>(n))
+              * std::numeric_limits<double>::epsilon();
+    }
+
+    const double anorm = srs::norm(a, srs::Inf);
+
+    int iter = 0;
+
+    // Matrices out of range for single precision go directly to fallback.
+    if (anorm < std::numeric_limits<float>::max()) {
+        srs::Array<float, 2> sa(n, n);
+        srs::Array<float, 2> sr(n, nrhs);
+        srs::ivector ipiv(n);
+
+#pragma omp parallel for
+        for (MKL_INT j = 0; j < n; ++j) {
+            for (MKL_INT i = 0; i < n; ++i) {
+                sa(i, j) = static_cast<float>(a(i, j));
+            }
+        }
+        MKL_INT info = LAPACKE_sgetrf(
+            LAPACK_COL_MAJOR, n, n, sa.data(), n, ipiv.data());
+
+        if (info == 0) {
+            srs::dmatrix x(n, nrhs, 0.0);
+            srs::dmatrix r = b;
+
+            double rel_prev = std::numeric_limits<double>::infinity();
+            while (true) {
+                // Correction from the single precision factorization.
+                for (MKL_INT j = 0; j < nrhs; ++j) {
+                    for (MKL_INT i = 0; i < n; ++i) {
+                        sr(i, j) = static_cast<float>(r(i, j));
+                    }
+                }
+                // clang-format off
+                LAPACKE_sgetrs(
+                    LAPACK_COL_MAJOR, 'N', n, nrhs, sa.data(), n, ipiv.data(),
+                    sr.data(), n);
+                // clang-format on
+                for (MKL_INT j = 0; j < nrhs; ++j) {
+                    for (MKL_INT i = 0; i < n; ++i) {
+                        x(i, j) += static_cast<double>(sr(i, j));
+                    }
+                }
+
+                // Residual r = b - a * x in double precision.
+                r = b;
+                // clang-format off
+                srs::blas::gemm(
+                    'N', 'N', n, nrhs, n, -1.0, a.data(), n, x.data(), n, 1.0,
+                    r.data(), n);
+                // clang-format on
+
+                double rel = relative_residual(r, x, anorm);
+                if (rel <= tol) {
+                    b = x;
+                    return iter;
+                }
+                if ((iter == max_iter) || !(rel < 0.5 * rel_prev)) {
+                    break;  // not converging
+                }
+                rel_prev = rel;
+                ++iter;
+            }
+        }
+    }
+
+    srs::dmatrix ad = a;
+    srs::linsolve(ad, b);
+    return -(iter + 1);
+}
+#endif  // SRS_HAVE_LAPACK
+
+#ifdef SRS_USE_MKL
+namespace {
+
+// Solve a * x = b with PARDISO for a matrix of type mtype in zero-based
+// CSR format. The internal solver memory is released before returning.
+void pardiso_solve(MKL_INT mtype,
+                   const double* a,
+                   const MKL_INT* ia,
+                   const MKL_INT* ja,
                    srs::dvector& b,
                    srs::dvector& x)
 {
-    Expects(b.size() == a.rows());
-    x.resize(b.size());
-
     // Initialize PARDISO:
 
     void* pt[64];         // internal solver memory pointer
     MKL_INT iparm[64];    // PARDISO control parameters
-    MKL_INT mtype  = 11;  // real and nonsymmetric matrix
     MKL_INT maxfct = 1;   // max factors kept in memory
     MKL_INT mnum   = 1;   // which matrix to factorize
     MKL_INT phase  = 13;  // analysis, numerical factorization, solve
@@ -592,62 +1367,537 @@ void srs::linsolve(const srs::sparse_dmatrix& a,
 
     // clang-format off
     pardiso(
-        (void*)pt, &maxfct, &mnum, &mtype, &phase, &n, a.data(), 
-        a.row_index().data(), a.columns().data(), perm.data(), &nrhs, 
-        (MKL_INT*)iparm, &msglvl, b.data(), x.data(), &error);
+        (void*)pt, &maxfct, &mnum, &mtype, &phase, &n, a, ia, ja, perm.data(),
+        &nrhs, (MKL_INT*)iparm, &msglvl, b.data(), x.data(), &error);
+    // clang-format on
+
+    // Release internal solver memory, also if the solve failed:
+
+    MKL_INT release = -1;
+    MKL_INT ierr    = 0;
+    // clang-format off
+    pardiso(
+        (void*)pt, &maxfct, &mnum, &mtype, &release, &n, a, ia, ja,
+        perm.data(), &nrhs, (MKL_INT*)iparm, &msglvl, b.data(), x.data(),
+        &ierr);
     // clang-format on
 
     if (error != 0) {
-        throw Math_error("could not solve sparse linear system of equations");
+        throw srs::Math_error(
+            "could not solve sparse linear system of equations");
     }
 }
 
+}  // namespace
+
+void srs::linsolve(const srs::sparse_dmatrix& a,
+                   srs::dvector& b,
+                   srs::dvector& x)
+{
+    Expects(b.size() == a.rows());
+    x.resize(b.size());
+    const MKL_INT mtype = 11;  // real and nonsymmetric matrix
+    pardiso_solve(
+        mtype, a.data(), a.row_index().data(), a.columns().data(), b, x);
+}
+
+void srs::linsolve(const srs::sym_sparse_dmatrix& a,
+                   srs::dvector& b,
+                   srs::dvector& x)
+{
+    Expects(b.size() == a.rows());
+    x.resize(b.size());
+    const MKL_INT mtype = -2;  // real and symmetric indefinite matrix
+    pardiso_solve(
+        mtype, a.data(), a.row_index().data(), a.columns().data(), b, x);
+}
+
+#endif  // SRS_USE_MKL
+
 //------------------------------------------------------------------------------
 
-void srs::schmidt(srs::dmatrix& a, srs::size_t n)
+#ifdef SRS_HAVE_LAPACK
+namespace {
+
+// Compute eigenvalues and eigenvectors of a real symmetric N x N matrix
+// stored in column-major order. This is a fixed-size, allocation-free version
+// of the Jacobi algorithm in srs::jacobi() intended for batches of small
+// matrices. On exit, a holds the eigenvectors and w the eigenvalues in
+// ascending order. Returns false if the iterations did not converge.
+template <int N>
+bool jacobi_kernel(double* a, double* w)
+{
+    double v[N * N];
+
+    for (int j = 0; j < N; ++j) {
+        for (int i = 0; i < N; ++i) {
+            v[i + j * N] = (i == j) ? 1.0 : 0.0;
+        }
+        w[j] = a[j + j * N];
+    }
+
+    // Main iteration loop:
+
+    const int max_iter = 100;
+    int iter;
+
+    for (iter = 0; iter < max_iter; ++iter) {
+        double so = 0.0;
+        for (int p = 0; p < N; ++p) {
+            for (int q = p + 1; q < N; ++q) {
+                so += std::abs(a[p + q * N]);
+            }
+        }
+        if (so == 0.0) {
+            break;
+        }
+        double thresh = (iter < 4) ? 0.2 * so / (N * N) : 0.0;
+
+        // Do sweeps:
+
+        for (int p = 0; p < N; ++p) {
+            for (int q = p + 1; q < N; ++q) {
+                double& apq = a[p + q * N];
+                double g    = 100.0 * std::abs(apq);
+
+                if ((iter > 4) && (std::abs(w[p]) + g == std::abs(w[p]))
+                    && (std::abs(w[q]) + g == std::abs(w[q]))) {
+                    apq = 0.0;
+                }
+                else if (std::abs(apq) > thresh) {
+                    // Calculate Jacobi transformation:
+                    double h = w[q] - w[p];
+                    double t;
+                    if (std::abs(h) + g == std::abs(h)) {
+                        t = apq / h;
+                    }
+                    else {
+                        double theta = 0.5 * h / apq;
+                        t = 1.0
+                            / (std::abs(theta)
+                               + std::sqrt(1.0 + theta * theta));
+                        if (theta < 0.0) {
+                            t = -t;
+                        }
+                    }
+                    double c = 1.0 / std::sqrt(1.0 + t * t);
+                    double s = t * c;
+                    double z = t * apq;
+
+                    // Apply Jacobi transformation:
+
+                    apq = 0.0;
+                    w[p] -= z;
+                    w[q] += z;
+
+                    for (int r = 0; r < p; ++r) {
+                        t            = a[r + p * N];
+                        a[r + p * N] = c * t - s * a[r + q * N];
+                        a[r + q * N] = s * t + c * a[r + q * N];
+                    }
+                    for (int r = p + 1; r < q; ++r) {
+                        t            = a[p + r * N];
+                        a[p + r * N] = c * t - s * a[r + q * N];
+                        a[r + q * N] = s * t + c * a[r + q * N];
+                    }
+                    for (int r = q + 1; r < N; ++r) {
+                        t            = a[p + r * N];
+                        a[p + r * N] = c * t - s * a[q + r * N];
+                        a[q + r * N] = s * t + c * a[q + r * N];
+                    }
+
+                    // Update eigenvectors:
+
+                    for (int r = 0; r < N; ++r) {
+                        t            = v[r + p * N];
+                        v[r + p * N] = c * t - s * v[r + q * N];
+                        v[r + q * N] = s * t + c * v[r + q * N];
+                    }
+                }
+            }
+        }
+    }
+    if (iter >= max_iter) {
+        return false;
+    }
+
+    // Sort eigenvalues in ascending order:
+
+    for (int i = 0; i < N - 1; ++i) {
+        int k    = i;
+        double p = w[i];
+        for (int j = i + 1; j < N; ++j) {
+            if (w[j] < p) {
+                k = j;
+                p = w[j];
+            }
+        }
+        if (k != i) {
+            w[k] = w[i];
+            w[i] = p;
+            for (int j = 0; j < N; ++j) {
+                std::swap(v[j + i * N], v[j + k * N]);
+            }
+        }
+    }
+    std::copy(v, v + N * N, a);
+    return true;
+}
+
+}  // namespace
+
+void srs::eigs_batched(srs::dcube& a, srs::dmatrix& w)
 {
-    srs::size_t n_out   = 0;
-    srs::size_t n_orb   = n;
-    srs::size_t n_basis = a.rows();
+    Expects(a.rows() == a.cols());
+
+    const MKL_INT n  = a.rows();
+    const int nbatch = a.depths();
 
-    srs::dvector work(n_basis, 0.0);
+    w.resize(n, nbatch);
+    if (a.empty()) {
+        return;
+    }
 
-    double r_min = 0.1;
+    int failed = 0;
 
-    while (n_orb < n_basis) {
-        srs::size_t lim = n_orb + n_basis;
-        for (srs::size_t i = 0; i < lim; ++i) {
-            if (n_out >= n_basis) {
-                return;
+    if (n == 3) {
+#pragma omp parallel for reduction(+ : failed)
+        for (int k = 0; k < nbatch; ++k) {
+            if (!jacobi_kernel<3>(a.depth(k).data(), w.column(k).data())) {
+                ++failed;
             }
-            auto an = a.column(n_out);
-            if (i < n_orb) {
-                auto ai = a.column(i);
-                an      = ai;
+        }
+    }
+    else {
+        const MKL_INT il     = 1;
+        const MKL_INT iu     = n;
+        const double vl      = 0.0;
+        const double vu      = 0.0;
+        const double abstol  = -1.0;  // use default value
+        MKL_INT m            = 0;
+        double lwork_query   = 0.0;
+        MKL_INT liwork_query = 0;
+
+        // Workspace query, the workspace is then allocated once per thread:
+
+        // clang-format off
+        LAPACKE_dsyevr_work(
+            LAPACK_COL_MAJOR, 'V', 'A', 'U', n, a.data(), n, vl, vu, il, iu,
+            abstol, &m, w.data(), nullptr, n, nullptr, &lwork_query, -1,
+            &liwork_query, -1);
+        // clang-format on
+        const MKL_INT lwork  = static_cast<MKL_INT>(lwork_query);
+        const MKL_INT liwork = liwork_query;
+
+#pragma omp parallel reduction(+ : failed)
+        {
+            srs::dmatrix z(n, n);
+            srs::dvector work(lwork);
+            srs::ivector iwork(liwork);
+            srs::ivector isuppz(2 * n);
+
+#pragma omp for
+            for (int k = 0; k < nbatch; ++k) {
+                double* ak = a.depth(k).data();
+                MKL_INT mk = 0;
+
+                // clang-format off
+                MKL_INT info = LAPACKE_dsyevr_work(
+                    LAPACK_COL_MAJOR, 'V', 'A', 'U', n, ak, n, vl, vu, il, iu, 
+                    abstol, &mk, w.column(k).data(), z.data(), n, 
+                    isuppz.data(), work.data(), lwork, iwork.data(), liwork);
+                // clang-format on
+                if (info != 0) {
+                    ++failed;
+                }
+                else {
+                    std::copy(z.begin(), z.end(), ak);
+                }
             }
-            else {
-                an                  = 0.0;
-                a(i - n_orb, n_out) = 1.0;
+        }
+    }
+    if (failed > 0) {
+        throw Math_error("srs::eigs_batched(): " + std::to_string(failed)
+                         + " eigenproblems failed");
+    }
+}
+
+void srs::lu_batched(srs::dcube& a, srs::imatrix& ipiv)
+{
+    const MKL_INT m  = a.rows();
+    const MKL_INT n  = a.cols();
+    const int nbatch = a.depths();
+
+    ipiv.resize(std::min(m, n), nbatch);
+    if (a.empty()) {
+        return;
+    }
+
+    int failed = 0;
+
+#pragma omp parallel for reduction(+ : failed)
+    for (int k = 0; k < nbatch; ++k) {
+        MKL_INT info = LAPACKE_dgetrf(LAPACK_COL_MAJOR,
+                                      m,
+                                      n,
+                                      a.depth(k).data(),
+                                      m,
+                                      ipiv.column(k).data());
+        if (info != 0) {
+            ++failed;
+        }
+    }
+    if (failed > 0) {
+        throw Math_error("srs::lu_batched(): U matrix is singular for "
+                         + std::to_string(failed) + " matrices");
+    }
+}
+
+void srs::linsolve_batched(srs::dcube& a, srs::dcube& b)
+{
+    Expects(a.rows() == a.cols());
+    Expects(b.rows() == a.cols());
+    Expects(b.depths() == a.depths());
+
+    const MKL_INT n    = a.cols();
+    const MKL_INT nrhs = b.cols();
+    const int nbatch   = a.depths();
+
+    if (a.empty() || b.empty()) {
+        return;
+    }
+
+    int failed = 0;
+
+#pragma omp parallel reduction(+ : failed)
+    {
+        srs::ivector ipiv(n);
+
+#pragma omp for
+        for (int k = 0; k < nbatch; ++k) {
+            // clang-format off
+            MKL_INT info = LAPACKE_dgesv(
+                LAPACK_COL_MAJOR, n, nrhs, a.depth(k).data(), n, ipiv.data(), 
+                b.depth(k).data(), n);
+            // clang-format on
+            if (info != 0) {
+                ++failed;
             }
-            for (srs::size_t j = 0; j < n_out; ++j) {
-                auto aj = a.column(j);
-                work(j) = srs::dot(aj, an);
+        }
+    }
+    if (failed > 0) {
+        throw Math_error("srs::linsolve_batched(): factor U is singular for "
+                         + std::to_string(failed) + " matrices");
+    }
+}
+
+void srs::linsolve_batched(srs::dcube& a, srs::dmatrix& b)
+{
+    Expects(a.rows() == a.cols());
+    Expects(b.rows() == a.cols());
+    Expects(b.cols() == a.depths());
+
+    const MKL_INT n  = a.cols();
+    const int nbatch = a.depths();
+
+    if (a.empty()) {
+        return;
+    }
+
+    int failed = 0;
+
+#pragma omp parallel reduction(+ : failed)
+    {
+        srs::ivector ipiv(n);
+
+#pragma omp for
+        for (int k = 0; k < nbatch; ++k) {
+            // clang-format off
+            MKL_INT info = LAPACKE_dgesv(
+                LAPACK_COL_MAJOR, n, 1, a.depth(k).data(), n, ipiv.data(), 
+                b.column(k).data(), n);
+            // clang-format on
+            if (info != 0) {
+                ++failed;
+            }
+        }
+    }
+    if (failed > 0) {
+        throw Math_error("srs::linsolve_batched(): factor U is singular for "
+                         + std::to_string(failed) + " matrices");
+    }
+}
+
+#endif  // SRS_HAVE_LAPACK
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+// Orthogonalize columns [k, k + nb) of a against the orthonormal columns
+// [0, k) using two passes of block classical Gram-Schmidt (BLAS-3).
+void project_out(srs::dmatrix& a, MKL_INT k, MKL_INT nb, double* w)
+{
+    if (k == 0) {
+        return;
+    }
+    MKL_INT m = a.rows();
+    double* b = a.data() + k * m;
+    for (int pass = 0; pass < 2; ++pass) {
+        srs::blas::gemm('T', 'N', k, nb, m, 1.0, a.data(), m, b, m, 0.0, w, k);
+        // clang-format off
+        srs::blas::gemm(
+            'N', 'N', m, nb, k, -1.0, a.data(), m, w, k, 1.0, b, m);
+        // clang-format on
+    }
+}
+
+// Orthonormalize columns [k, k + nb) of a among themselves using modified
+// Gram-Schmidt with reorthogonalization. Columns with residual norm below
+// r_min are dropped and the accepted columns are packed from column k.
+// Returns the number of accepted columns.
+MKL_INT mgs_block(srs::dmatrix& a, MKL_INT k, MKL_INT nb, double r_min)
+{
+    MKL_INT m        = a.rows();
+    MKL_INT accepted = 0;
+    for (MKL_INT j = 0; j < nb; ++j) {
+        double* v = a.data() + (k + accepted) * m;
+        if (accepted < j) {
+            srs::blas::copy(m, a.data() + (k + j) * m, 1, v, 1);
+        }
+        for (int pass = 0; pass < 2; ++pass) {
+            for (MKL_INT p = 0; p < accepted; ++p) {
+                const double* q = a.data() + (k + p) * m;
+                double h = srs::blas::dot(m, q, 1, v, 1);
+                srs::blas::axpy(m, -h, q, 1, v, 1);
             }
-            for (srs::size_t j = 0; j < n_out; ++j) {
-                auto aj = a.column(j);
-                an      = an - work(j) * aj;
+        }
+        double r = srs::blas::nrm2(m, v, 1);
+        if (r >= r_min) {
+            srs::blas::scal(m, 1.0 / r, v, 1);
+            ++accepted;
+        }
+    }
+    return accepted;
+}
+
+// Gram-Schmidt orthonormalization of n orbitals in a, filled up with unit
+// vectors to a complete basis. Columns are processed in blocks of nb.
+void gram_schmidt(srs::dmatrix& a, MKL_INT n, MKL_INT nb)
+{
+    MKL_INT m     = a.rows();
+    MKL_INT n_out = 0;
+    double r_min  = 0.1;
+
+    srs::dvector work(m * nb);
+
+    // Orthonormalize the orbitals, moving accepted ones to the front.
+    for (MKL_INT i = 0; i < n; i += nb) {
+        MKL_INT bs = std::min(nb, n - i);
+        if (n_out < i) {
+            for (MKL_INT j = 0; j < bs; ++j) {
+                // clang-format off
+                srs::blas::copy(
+                    m, a.data() + (i + j) * m, 1, a.data() + (n_out + j) * m,
+                    1);
+                // clang-format on
             }
-            double r = std::sqrt(srs::dot(an, an));
-            if (r >= r_min) {
-                ++n_out;
-                an /= r;
+        }
+        project_out(a, n_out, bs, work.data());
+        n_out += mgs_block(a, n_out, bs, r_min);
+    }
+
+    // Fill up with unit vectors, relaxing the threshold until the basis is
+    // complete.
+    while (n_out < m) {
+        MKL_INT i = 0;
+        while (i < m && n_out < m) {
+            // The block is limited by the missing columns, so advance by
+            // bs rather than nb in order to try every unit vector.
+            MKL_INT bs = std::min(std::min(nb, m - i), m - n_out);
+            for (MKL_INT j = 0; j < bs; ++j) {
+                double* v = a.data() + (n_out + j) * m;
+                std::fill(v, v + m, 0.0);
+                v[i + j] = 1.0;
             }
+            project_out(a, n_out, bs, work.data());
+            n_out += mgs_block(a, n_out, bs, r_min);
+            i += bs;
         }
         r_min /= 10.0;
-        n_orb = n_out;
     }
 }
 
+#ifdef SRS_HAVE_LAPACK
+// Householder QR orthonormalization of n orbitals in a, with the remaining
+// columns of the complete q factor filling up the basis.
+void householder(srs::dmatrix& a, MKL_INT n)
+{
+    MKL_INT m = a.rows();
+
+    srs::dvector tau(std::max<MKL_INT>(n, 1));
+    srs::dvector sign(std::max<MKL_INT>(n, 1), 1.0);
+    if (n > 0) {
+        // clang-format off
+        MKL_INT info = LAPACKE_dgeqrf(
+            LAPACK_COL_MAJOR, m, n, a.data(), m, tau.data());
+        // clang-format on
+        if (info != 0) {
+            throw srs::Math_error("dgeqrf failed");
+        }
+        for (MKL_INT j = 0; j < n; ++j) {
+            if (a(j, j) < 0.0) {
+                sign(j) = -1.0;
+            }
+        }
+    }
+    // clang-format off
+    MKL_INT info = LAPACKE_dorgqr(
+        LAPACK_COL_MAJOR, m, m, n, a.data(), m, tau.data());
+    // clang-format on
+    if (info != 0) {
+        throw srs::Math_error("dorgqr failed");
+    }
+
+    // Fix signs so that the result agrees with Gram-Schmidt for orbitals
+    // that are linearly independent.
+    for (MKL_INT j = 0; j < n; ++j) {
+        if (sign(j) < 0.0) {
+            srs::blas::scal(m, -1.0, a.data() + j * m, 1);
+        }
+    }
+}
+#endif  // SRS_HAVE_LAPACK
+
+}  // namespace
+
+void srs::orthonormalize(srs::dmatrix& a, srs::size_t n, srs::Ortho_t method)
+{
+    Expects(a.cols() >= a.rows());
+    Expects(n >= 0 && n <= a.rows());
+
+    switch (method) {
+    case Mgs:
+        gram_schmidt(a, n, 32);
+        break;
+    case Cgs2:
+        gram_schmidt(a, n, 1);
+        break;
+    case Householder:
+#ifdef SRS_HAVE_LAPACK
+        householder(a, n);
+#else
+        gram_schmidt(a, n, 32);
+#endif
+        break;
+    }
+}
+
+void srs::schmidt(srs::dmatrix& a, srs::size_t n)
+{
+    srs::orthonormalize(a, n, Mgs);
+}
+
 //------------------------------------------------------------------------------
 
 void srs::mkl_dgemm(const std::string& transa,
@@ -658,47 +1908,28 @@ void srs::mkl_dgemm(const std::string& transa,
                     const double beta,
                     srs::dmatrix& c)
 {
-    Expects(a.rows() == b.cols());
+    const char ta = ((transa == "T") || (transa == "t")) ? 'T' : 'N';
+    const char tb = ((transb == "T") || (transb == "t")) ? 'T' : 'N';
 
-    const MKL_INT m = a.rows();
-    const MKL_INT n = b.cols();
-    const MKL_INT k = a.cols();
+    // Dimensions of op(a) (m x k) and op(b) (k x n).
+    const MKL_INT m = (ta == 'T') ? a.cols() : a.rows();
+    const MKL_INT k = (ta == 'T') ? a.rows() : a.cols();
+    const MKL_INT n = (tb == 'T') ? b.rows() : b.cols();
 
-    MKL_INT lda = k > 1 ? k : 1;
-    if ((transa == "N") || (transa == "n")) {
-        lda = m > 1 ? m : 1;
-    }
-
-    MKL_INT ldb = n > 1 ? n : 1;
-    if ((transb == "N") || (transb == "n")) {
-        ldb = k > 1 ? k : 1;
-    }
+    Expects(k == ((tb == 'T') ? b.cols() : b.rows()));
 
+    MKL_INT lda = a.rows() > 1 ? a.rows() : 1;
+    MKL_INT ldb = b.rows() > 1 ? b.rows() : 1;
     MKL_INT ldc = m > 1 ? m : 1;
     if (c.empty()) {
-        c.resize(ldc, n);
-    }
-
-    CBLAS_TRANSPOSE cblas_transa;
-    if ((transa == "T") || (transa == "t")) {
-        cblas_transa = CblasTrans;
-    }
-    else {
-        cblas_transa = CblasNoTrans;
-    }
-
-    CBLAS_TRANSPOSE cblas_transb;
-    if ((transb == "T") || (transb == "t")) {
-        cblas_transb = CblasTrans;
-    }
-    else {
-        cblas_transb = CblasNoTrans;
+        c.resize(m, n);
     }
+    Expects(c.rows() == m && c.cols() == n);
 
     // clang-format off
-    cblas_dgemm(
-        CblasColMajor, cblas_transa, cblas_transb, m, n, k, alpha, a.data(),
-        lda, b.data(), ldb, beta, c.data(), ldc);
+    srs::blas::gemm(
+        ta, tb, m, n, k, alpha, a.data(), lda, b.data(), ldb, beta, c.data(),
+        ldc);
     // clang-format on
 }
 
@@ -719,7 +1950,7 @@ void srs::mkl_dgemv(const std::string& transa,
         }
     }
     else {
-        Expects(x.size() == a.cols());
+        Expects(x.size() == a.rows());
         if (y.empty()) {
             y.resize(n);
         }
@@ -729,17 +1960,10 @@ void srs::mkl_dgemv(const std::string& transa,
     MKL_INT incx = 1;
     MKL_INT incy = 1;
 
-    CBLAS_TRANSPOSE cblas_transa;
-    if ((transa == "T") || (transa == "t")) {
-        cblas_transa = CblasTrans;
-    }
-    else {
-        cblas_transa = CblasNoTrans;
-    }
+    const char ta = ((transa == "T") || (transa == "t")) ? 'T' : 'N';
 
     // clang-format off
-    cblas_dgemv(
-        CblasColMajor, cblas_transa, m, n, alpha, a.data(), lda, x.data(),
-        incx, beta, y.data(), incy);
+    srs::blas::gemv(
+        ta, m, n, alpha, a.data(), lda, x.data(), incx, beta, y.data(), incy);
     // clang-format on
 }
@@ -20,6 +20,7 @@
 #include <cmath>
 #include <gsl/gsl>
 #include <iostream>
+#include <limits>
 #include <utility>
 
 
@@ -450,4 +451,14 @@ TEST_CASE("test_array2")
         CHECK(srs::prod(a, 2) == c);
         CHECK(srs::prod(a, 1) == r);
     }
+
+    SECTION("size_overflow")
+    {
+        const srs::Int_t big = std::numeric_limits<srs::Int_t>::max() / 2 + 1;
+        CHECK(srs::checked_mul(big, 1) == big);
+        CHECK_THROWS(srs::checked_mul(big, 2));
+        CHECK_THROWS(srs::checked_mul(-1, 2));
+        CHECK_THROWS(srs::Array<char, 2>(big, 2));
+        CHECK_THROWS(srs::Array<char, 3>(big, 1, 2));
+    }
 }
@@ -17,6 +17,7 @@
 #include <srs/array.h>
 #include <srs/band.h>
 #include <catch/catch.hpp>
+#include <algorithm>
 #include <iostream>
 
 
@@ -49,4 +50,44 @@ TEST_CASE("test_band")
         CHECK(ab(4, 3) == 54);
         CHECK(ab(4, 4) == 55);
     }
+
+    SECTION("mv_mul")
+    {
+        srs::ivector v     = {1, 2, 3, 4, 5};
+        srs::ivector w     = ab * v;
+        srs::ivector w_ans = a * v;
+        CHECK(w == w_ans);
+
+        srs::dmatrix ad(6, 5, 0.0);
+        for (int j = 0; j < 5; ++j) {
+            for (int i = std::max(0, j - 1); i <= std::min(5, j + 2); ++i) {
+                ad(i, j) = 1.0 + i + 10.0 * j;
+            }
+        }
+        srs::band_dmatrix bd(2, 1, ad);
+        srs::dvector vd     = {1.0, -2.0, 3.0, -4.0, 5.0};
+        srs::dvector wd     = bd * vd;
+        srs::dvector wd_ans = ad * vd;
+        CHECK(wd == wd_ans);
+
+        // Symmetric band matrix, only the upper band is referenced.
+        srs::dmatrix sd = {{4.0, 1.0, 2.0, 0.0, 0.0},
+                           {1.0, 5.0, 3.0, 1.0, 0.0},
+                           {2.0, 3.0, 6.0, 2.0, 1.0},
+                           {0.0, 1.0, 2.0, 7.0, 3.0},
+                           {0.0, 0.0, 1.0, 3.0, 8.0}};
+        srs::band_dmatrix bs(0, 2, sd);
+        srs::dvector ws;
+        srs::sym_mv_mul(bs, vd, ws);
+        wd_ans = sd * vd;
+        CHECK(ws == wd_ans);
+    }
+
+    SECTION("mm_mul")
+    {
+        srs::imatrix b     = {{1, 2}, {3, 4}, {5, 6}, {7, 8}, {9, 10}};
+        srs::imatrix c     = ab * b;
+        srs::imatrix c_ans = a * b;
+        CHECK(c == c_ans);
+    }
 }
\ No newline at end of file
@@ -17,8 +17,10 @@
 #include <srs/math.h>
 #include <armadillo>
 #include <catch/catch.hpp>
+#include <cmath>
 #include <complex>
 #include <functional>
+#include <vector>
 
 double f(double x) { return x * x; }
 
@@ -181,6 +183,140 @@ TEST_CASE("test_math")
         CHECK(srs::approx_equal(srs::dot(a1, a2), arma::dot(b1, b2), 1.0e-18));
     }
 
+    SECTION("blas")
+    {
+        srs::dmatrix a = {{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}};
+        srs::dmatrix b = {{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}, {7.0, 8.0}};
+        srs::dvector x = {1.0, 2.0};
+
+        // c = a^T * b^T = (b * a)^T
+        srs::dmatrix ba = {{9.0, 12.0, 15.0},
+                           {19.0, 26.0, 33.0},
+                           {29.0, 40.0, 51.0},
+                           {39.0, 54.0, 69.0}};
+        srs::dmatrix c;
+        srs::mkl_dgemm("T", "T", 1.0, a, b, 0.0, c);
+        CHECK(c.rows() == 3);
+        CHECK(c.cols() == 4);
+        for (srs::size_t j = 0; j < c.cols(); ++j) {
+            for (srs::size_t i = 0; i < c.rows(); ++i) {
+                CHECK(srs::approx_equal(c(i, j), ba(j, i), 1.0e-12));
+            }
+        }
+
+        srs::dvector y;
+        srs::dvector y_ans = {9.0, 12.0, 15.0};
+        srs::mkl_dgemv("T", 1.0, a, x, 0.0, y);
+        CHECK(y.size() == 3);
+        for (srs::size_t i = 0; i < y.size(); ++i) {
+            CHECK(srs::approx_equal(y(i), y_ans(i), 1.0e-12));
+        }
+
+        srs::dmatrix at;
+        srs::mkl_transpose(a, at);
+        CHECK(at.rows() == 3);
+        CHECK(at.cols() == 2);
+        for (srs::size_t j = 0; j < a.cols(); ++j) {
+            for (srs::size_t i = 0; i < a.rows(); ++i) {
+                CHECK(at(j, i) == a(i, j));
+            }
+        }
+
+        // Single precision, complex and integer types:
+        srs::Array<float, 2> af  = {{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}};
+        srs::Array<float, 2> bf  = {{1.0f, 2.0f}, {3.0f, 4.0f}, {5.0f, 6.0f}};
+        srs::Array<float, 2> cf;
+        srs::gemm('N', 'N', 1.0f, af, bf, 0.0f, cf);
+        CHECK(cf.rows() == 2);
+        CHECK(cf.cols() == 2);
+        CHECK(srs::approx_equal(cf(0, 0), 22.0f, 1.0e-6f));
+        CHECK(srs::approx_equal(cf(1, 1), 64.0f, 1.0e-6f));
+
+        srs::zmatrix az = {{{1.0, 1.0}, {0.0, 2.0}}, {{3.0, 0.0}, {1.0, -1.0}}};
+        srs::zvector xz = {{1.0, 0.0}, {0.0, 1.0}};
+        srs::zvector yz;
+        srs::gemv('N', {1.0, 0.0}, az, xz, {0.0, 0.0}, yz);
+        CHECK(std::abs(yz(0) - std::complex<double>(-1.0, 1.0)) < 1.0e-12);
+        CHECK(std::abs(yz(1) - std::complex<double>(4.0, 1.0)) < 1.0e-12);
+        CHECK(std::abs(srs::dot(xz, yz) - std::complex<double>(-2.0, 5.0))
+              < 1.0e-12);
+
+        srs::imatrix ai = {{1, 2}, {3, 4}};
+        srs::imatrix ci;
+        srs::gemm('T', 'N', 1, ai, ai, 0, ci);
+        CHECK(ci(0, 0) == 10);
+        CHECK(ci(0, 1) == 14);
+        CHECK(ci(1, 1) == 20);
+
+        // Strided sub-blocks, c(1:2, 1:2) = a(0:1, 0:1) * b(1:2, 0:1):
+        srs::dmatrix cs(3, 3, 0.0);
+        srs::gemm('N', 'N', 1.0, a.slice(0, 1, 0, 1), b.slice(1, 2, 0, 1), 0.0,
+                  cs.slice(1, 2, 1, 2));
+        CHECK(srs::approx_equal(cs(1, 1), 13.0, 1.0e-12));
+        CHECK(srs::approx_equal(cs(1, 2), 16.0, 1.0e-12));
+        CHECK(srs::approx_equal(cs(2, 1), 37.0, 1.0e-12));
+        CHECK(srs::approx_equal(cs(2, 2), 46.0, 1.0e-12));
+        CHECK(cs(0, 0) == 0.0);
+
+        srs::dvector yd(3, 1.0);
+        srs::axpy(2.0, a.row(1), yd);
+        CHECK(srs::approx_equal(yd(2), 13.0, 1.0e-12));
+        CHECK(srs::approx_equal(srs::dot(a.column(2), x), 15.0, 1.0e-12));
+    }
+
+    SECTION("gemm_batched")
+    {
+        const int nbatch = 20;
+
+        srs::dcube a(4, 3, nbatch);
+        srs::dcube b(3, 5, nbatch);
+        for (int l = 0; l < nbatch; ++l) {
+            for (int j = 0; j < 3; ++j) {
+                for (int i = 0; i < 4; ++i) {
+                    a(i, j, l) = std::sin(i + 2.0 * j + 3.0 * l);
+                }
+                for (int i = 0; i < 5; ++i) {
+                    b(j, i, l) = std::cos(j - 2.0 * i + l);
+                }
+            }
+        }
+
+        srs::dcube c;
+        srs::gemm_batched('N', 'N', 1.0, a, b, 0.0, c);
+        CHECK(c.rows() == 4);
+        CHECK(c.cols() == 5);
+        CHECK(c.depths() == nbatch);
+        for (int l = 0; l < nbatch; ++l) {
+            srs::dmatrix ab;
+            srs::gemm('N', 'N', 1.0, a.depth(l), b.depth(l), 0.0, ab);
+            for (int j = 0; j < 5; ++j) {
+                for (int i = 0; i < 4; ++i) {
+                    CHECK(srs::approx_equal(c(i, j, l), ab(i, j), 1.0e-12));
+                }
+            }
+        }
+
+        // Products of varying size, c[l] = 2 * a[l]^T * a[l] + c[l]:
+        std::vector<srs::dmatrix> am;
+        std::vector<srs::dmatrix> cm;
+        for (int l = 1; l <= nbatch; ++l) {
+            srs::dmatrix al(l + 2, l);
+            for (int j = 0; j < l; ++j) {
+                for (int i = 0; i < l + 2; ++i) {
+                    al(i, j) = std::sin(i + 2.0 * j + 3.0 * l);
+                }
+            }
+            am.push_back(al);
+            cm.push_back(srs::dmatrix(l, l, 1.0));
+        }
+        srs::gemm_batched('T', 'N', 2.0, am, am, 1.0, cm);
+        for (int l = 0; l < nbatch; ++l) {
+            srs::dmatrix ata(l + 1, l + 1, 1.0);
+            srs::gemm('T', 'N', 2.0, am[l], am[l], 1.0, ata);
+            CHECK(srs::approx_equal(cm[l], ata, 1.0e-12));
+        }
+    }
+
     SECTION("cross_product")
     {
         srs::dvector a1 = {1.0, 2.0, 3.0};
@@ -279,6 +415,581 @@ TEST_CASE("test_math")
         }
     }
 
+#ifdef SRS_HAVE_LAPACK
+    SECTION("eigs_range")
+    {
+        srs::dmatrix a = srs::hilbert(5);
+        srs::dvector wans;
+        srs::eigs(a, wans);
+
+        // Index range:
+
+        srs::dmatrix b = srs::hilbert(5);
+        srs::dmatrix v;
+        srs::dvector w;
+        srs::eigs(b, v, w, 1, 3);
+
+        CHECK(w.size() == 3);
+        CHECK(v.rows() == 5);
+        CHECK(v.cols() == 3);
+        for (int i = 0; i < w.size(); ++i) {
+            CHECK(srs::approx_equal(w(i), wans(i + 1), 1.0e-12));
+        }
+        for (int j = 0; j < v.cols(); ++j) {
+            for (int i = 0; i < v.rows(); ++i) {
+                CHECK(srs::approx_equal(
+                    std::abs(v(i, j)), std::abs(a(i, j + 1)), 1.0e-10));
+            }
+        }
+
+        // Value range:
+
+        b = srs::hilbert(5);
+        srs::eigs(1.0e-3, 2.0, b, v, w);
+
+        CHECK(w.size() == 3);
+        CHECK(v.cols() == 3);
+        for (int i = 0; i < w.size(); ++i) {
+            CHECK(srs::approx_equal(w(i), wans(i + 2), 1.0e-12));
+        }
+
+        // Eigenvalues only:
+
+        b = srs::hilbert(5);
+        srs::eigvals(b, w);
+        CHECK(srs::approx_equal(w, wans, 1.0e-12));
+
+        b = srs::hilbert(5);
+        srs::eigvals(b, w, 4, 4);
+        CHECK(w.size() == 1);
+        CHECK(srs::approx_equal(w(0), wans(4), 1.0e-12));
+
+        b = srs::hilbert(5);
+        srs::eigvals(-1.0, 1.0e-3, b, w);
+        CHECK(w.size() == 2);
+        CHECK(srs::approx_equal(w(1), wans(1), 1.0e-12));
+    }
+
+    SECTION("eigs_batched")
+    {
+        const int nbatch = 4;
+
+        srs::dcube a3(3, 3, nbatch);
+        srs::dcube a5(5, 5, nbatch);
+        for (int k = 0; k < nbatch; ++k) {
+            a3.depth(k) = {{2.0 + k, -1.0, 0.0},
+                           {-1.0, 2.0, -1.0 * k},
+                           {0.0, -1.0 * k, 2.0}};
+            a5.depth(k) = srs::hilbert(5) * (1.0 + k);
+        }
+        srs::dcube b3 = a3;
+        srs::dcube b5 = a5;
+
+        srs::dmatrix w3;
+        srs::dmatrix w5;
+        srs::eigs_batched(b3, w3);
+        srs::eigs_batched(b5, w5);
+
+        for (int k = 0; k < nbatch; ++k) {
+            srs::dmatrix v3 = a3.depth(k);
+            srs::dmatrix v5 = a5.depth(k);
+            srs::dvector ans3;
+            srs::dvector ans5;
+            srs::eigs(v3, ans3);
+            srs::eigs(v5, ans5);
+            for (int i = 0; i < 3; ++i) {
+                CHECK(srs::approx_equal(w3(i, k), ans3(i), 1.0e-12));
+                for (int j = 0; j < 3; ++j) {
+                    CHECK(srs::approx_equal(
+                        std::abs(b3(j, i, k)), std::abs(v3(j, i)), 1.0e-10));
+                }
+            }
+            for (int i = 0; i < 5; ++i) {
+                CHECK(srs::approx_equal(w5(i, k), ans5(i), 1.0e-12));
+            }
+        }
+    }
+
+    SECTION("linsolve_batched")
+    {
+        const int nbatch = 3;
+
+        srs::dcube a(3, 3, nbatch);
+        srs::dmatrix b(3, nbatch);
+        for (int k = 0; k < nbatch; ++k) {
+            a.depth(k) = {
+                {1.0 + k, 2.0, 3.0}, {2.0, 3.0, 4.0}, {3.0, 4.0, 1.0}};
+            b.column(k) = srs::dvector{14.0, 20.0, 14.0};
+        }
+        srs::dcube lu = a;
+        srs::imatrix ipiv;
+        srs::lu_batched(lu, ipiv);
+        CHECK(ipiv.rows() == 3);
+        CHECK(ipiv.cols() == nbatch);
+
+        srs::dmatrix x = b;
+        srs::linsolve_batched(a, x);
+
+        for (int k = 0; k < nbatch; ++k) {
+            srs::dmatrix ak  = lu.depth(k);
+            srs::dmatrix ans = {
+                {1.0 + k, 2.0, 3.0}, {2.0, 3.0, 4.0}, {3.0, 4.0, 1.0}};
+            srs::dmatrix bk(3, 1, b.column(k).data());
+            srs::linsolve(ans, bk);
+            for (int i = 0; i < 3; ++i) {
+                CHECK(srs::approx_equal(x(i, k), bk(i, 0), 1.0e-12));
+                CHECK(srs::approx_equal(ak(i, i), ans(i, i), 1.0e-12));
+            }
+        }
+    }
+
+    SECTION("linsolve_batched_cube")
+    {
+        const int n      = 4;
+        const int nrhs   = 2;
+        const int nbatch = 5;
+
+        srs::dcube a(n, n, nbatch);
+        srs::dcube b(n, nrhs, nbatch);
+        for (int k = 0; k < nbatch; ++k) {
+            for (int j = 0; j < n; ++j) {
+                for (int i = 0; i < n; ++i) {
+                    a(i, j, k) = std::cos(1.0 + i + 2 * j + 3 * k);
+                }
+                a(j, j, k) += n + 0.5 * k;
+            }
+            for (int j = 0; j < nrhs; ++j) {
+                for (int i = 0; i < n; ++i) {
+                    b(i, j, k) = std::sin(1.0 + i - j + k);
+                }
+            }
+        }
+        srs::dcube lu = a;
+        srs::dcube x  = b;
+        srs::linsolve_batched(lu, x);
+
+        for (int k = 0; k < nbatch; ++k) {
+            srs::dmatrix ak = a.depth(k);
+            srs::dmatrix bk = b.depth(k);
+            srs::linsolve(ak, bk);
+            for (int j = 0; j < nrhs; ++j) {
+                for (int i = 0; i < n; ++i) {
+                    CHECK(srs::approx_equal(x(i, j, k), bk(i, j), 1.0e-12));
+                }
+            }
+        }
+    }
+
+    SECTION("linsolve_mixed")
+    {
+        const int n = 50;
+
+        srs::dmatrix a(n, n);
+        srs::dmatrix b(n, 2);
+        for (int j = 0; j < n; ++j) {
+            for (int i = 0; i < n; ++i) {
+                a(i, j) = std::sin(1.0 + i + 3.0 * j);
+            }
+            a(j, j) += n;
+            b(j, 0) = std::cos(1.0 * j);
+            b(j, 1) = 1.0;
+        }
+        srs::dmatrix x  = b;
+        srs::dmatrix ad = a;
+        srs::linsolve(ad, x);
+
+        srs::dmatrix xm = b;
+        int iter        = srs::linsolve_mixed(a, xm);
+        CHECK(iter >= 0);
+        CHECK(srs::approx_equal(xm, x, 1.0e-12));
+
+        // Hilbert matrix is too ill-conditioned for single precision.
+        srs::dmatrix h(12, 12);
+        for (int j = 0; j < 12; ++j) {
+            for (int i = 0; i < 12; ++i) {
+                h(i, j) = 1.0 / (i + j + 1.0);
+            }
+        }
+        srs::dmatrix hb(12, 1, 1.0);
+        srs::dmatrix hx = hb;
+        srs::dmatrix hd = h;
+        srs::linsolve(hd, hx);
+
+        iter = srs::linsolve_mixed(h, hb);
+        CHECK(iter < 0);
+        CHECK(srs::approx_equal(hb, hx, 1.0e-12));
+    }
+
+    SECTION("linsolve_band")
+    {
+        const int n = 30;
+
+        // General band matrix with kl = 2 and ku = 3.
+        srs::band_dmatrix ab(n, n, 2, 3);
+        srs::dmatrix a(n, n, 0.0);
+        for (int j = 0; j < n; ++j) {
+            for (int i = std::max(0, j - 3); i <= std::min(n - 1, j + 2); ++i) {
+                ab(i, j) = std::sin(1.0 + i + 2.0 * j);
+                a(i, j)  = ab(i, j);
+            }
+        }
+        srs::dmatrix b(n, 2);
+        for (int i = 0; i < n; ++i) {
+            b(i, 0) = 1.0;
+            b(i, 1) = std::cos(1.0 * i);
+        }
+        srs::dmatrix x  = b;
+        srs::dmatrix ad = a;
+        srs::linsolve(ad, x);
+
+        srs::dmatrix xb = b;
+        srs::linsolve(ab, xb);
+        CHECK(srs::approx_equal(xb, x, 1.0e-10));
+
+        srs::Lu<srs::band_dmatrix> lu(ab);
+        srs::dmatrix xl = b;
+        lu.solve(xl);
+        CHECK(srs::approx_equal(xl, x, 1.0e-10));
+        CHECK(srs::approx_equal(lu.det(), srs::det(a), 1.0e-10));
+
+        srs::dvector v(n, 1.0);
+        lu.solve(v);
+        for (int i = 0; i < n; ++i) {
+            CHECK(srs::approx_equal(v(i), x(i, 0), 1.0e-10));
+        }
+
+        // Tridiagonal matrix, solved with dgtsv.
+        srs::band_dmatrix at(n, n, 1, 1);
+        for (int i = 0; i < n; ++i) {
+            at(i, i) = 2.0 + std::sin(1.0 * i);
+            if (i > 0) {
+                at(i, i - 1) = std::cos(1.0 * i);
+                at(i - 1, i) = -1.0;
+            }
+        }
+        srs::dmatrix ta(n, n, 0.0);
+        for (int j = 0; j < n; ++j) {
+            for (int i = std::max(0, j - 1); i <= std::min(n - 1, j + 1); ++i) {
+                ta(i, j) = at(i, j);
+            }
+        }
+        x = b;
+        srs::linsolve(ta, x);
+        xb = b;
+        srs::linsolve(at, xb);
+        CHECK(srs::approx_equal(xb, x, 1.0e-10));
+    }
+
+    SECTION("cholesky")
+    {
+        srs::dmatrix a = {{4.0, -1.0, 0.0, 0.0},
+                          {-1.0, 4.0, -1.0, 0.0},
+                          {0.0, -1.0, 4.0, -1.0},
+                          {0.0, 0.0, -1.0, 4.0}};
+        srs::dvector b = {3.0, 2.0, 2.0, 3.0};
+
+        srs::Cholesky<srs::dmatrix> chol(a);
+        srs::dvector x = b;
+        chol.solve(x);
+        for (int i = 0; i < 4; ++i) {
+            CHECK(srs::approx_equal(x(i), 1.0, 1.0e-12));
+        }
+        CHECK(srs::approx_equal(chol.det(), srs::det(a), 1.0e-10));
+
+        srs::dmatrix u   = chol.factor();
+        srs::dmatrix utu = srs::transpose(u) * u;
+        for (int j = 0; j < 4; ++j) {
+            for (int i = 0; i < 4; ++i) {
+                CHECK(srs::approx_equal(utu(i, j), a(i, j), 1.0e-12));
+            }
+        }
+
+        srs::dvector v  = {1.0, 0.5, -0.5, 2.0};
+        srs::dmatrix av = a;
+        for (int j = 0; j < 4; ++j) {
+            for (int i = 0; i < 4; ++i) {
+                av(i, j) += v(i) * v(j);
+            }
+        }
+        chol.update(v);
+        srs::Cholesky<srs::dmatrix> ans(av);
+        for (int j = 0; j < 4; ++j) {
+            for (int i = 0; i < 4; ++i) {
+                CHECK(srs::approx_equal(
+                    chol.factor()(i, j), ans.factor()(i, j), 1.0e-12));
+            }
+        }
+        chol.downdate(v);
+        for (int j = 0; j < 4; ++j) {
+            for (int i = 0; i < 4; ++i) {
+                CHECK(srs::approx_equal(
+                    chol.factor()(i, j), u(i, j), 1.0e-12));
+            }
+        }
+        CHECK_THROWS(chol.downdate(srs::dvector{0.0, 0.0, 0.0, 5.0}));
+
+        srs::packed_dmatrix ap(a);
+        srs::Cholesky<srs::packed_dmatrix> pchol(ap);
+        srs::dmatrix xp(4, 2, 0.0);
+        xp.column(0) = b;
+        xp.column(1) = b;
+        pchol.solve(xp);
+        CHECK(srs::approx_equal(pchol.det(), srs::det(a), 1.0e-10));
+
+        pchol.update(v);
+        for (int j = 0; j < 4; ++j) {
+            for (int i = 0; i <= j; ++i) {
+                CHECK(srs::approx_equal(
+                    pchol.factor()(i, j), ans.factor()(i, j), 1.0e-12));
+            }
+        }
+        pchol.downdate(v);
+        for (int j = 0; j < 4; ++j) {
+            for (int i = 0; i <= j; ++i) {
+                CHECK(srs::approx_equal(
+                    pchol.factor()(i, j), u(i, j), 1.0e-12));
+            }
+        }
+        CHECK_THROWS(pchol.downdate(srs::dvector{0.0, 0.0, 0.0, 5.0}));
+
+        srs::band_dmatrix ab(1, 1, a);
+        srs::Cholesky<srs::band_dmatrix> bchol(ab);
+        srs::dvector xb = b;
+        bchol.solve(xb);
+        CHECK(srs::approx_equal(bchol.det(), srs::det(a), 1.0e-10));
+
+        srs::rfp_dmatrix ar(a);
+        srs::Cholesky<srs::rfp_dmatrix> rchol(ar);
+        srs::dmatrix xr(4, 2, 0.0);
+        xr.column(0) = b;
+        xr.column(1) = b;
+        rchol.solve(xr);
+        CHECK(srs::approx_equal(rchol.det(), srs::det(a), 1.0e-10));
+        for (int j = 0; j < 4; ++j) {
+            for (int i = 0; i <= j; ++i) {
+                CHECK(srs::approx_equal(
+                    rchol.factor()(i, j), u(i, j), 1.0e-12));
+            }
+        }
+        for (int i = 0; i < 4; ++i) {
+            CHECK(srs::approx_equal(xp(i, 0), 1.0, 1.0e-12));
+            CHECK(srs::approx_equal(xp(i, 1), 1.0, 1.0e-12));
+            CHECK(srs::approx_equal(xb(i), 1.0, 1.0e-12));
+            CHECK(srs::approx_equal(xr(i, 0), 1.0, 1.0e-12));
+            CHECK(srs::approx_equal(xr(i, 1), 1.0, 1.0e-12));
+        }
+
+        srs::dmatrix indef = {{1.0, 2.0}, {2.0, 1.0}};
+        CHECK_THROWS(srs::Cholesky<srs::dmatrix>(indef));
+    }
+
+    SECTION("ldlt")
+    {
+        srs::dmatrix a = {{1.0, 2.0, 3.0}, {2.0, 3.0, 4.0}, {3.0, 4.0, 1.0}};
+        srs::dvector b = {14.0, 20.0, 14.0};
+
+        srs::Ldlt<srs::dmatrix> ldlt(a);
+        srs::dvector x = b;
+        ldlt.solve(x);
+
+        srs::packed_dmatrix ap(a);
+        srs::Ldlt<srs::packed_dmatrix> pldlt(ap);
+        srs::dmatrix xp(3, 1, b.data());
+        pldlt.solve(xp);
+
+        srs::dvector ans = {1.0, 2.0, 3.0};
+        for (int i = 0; i < 3; ++i) {
+            CHECK(srs::approx_equal(x(i), ans(i), 1.0e-12));
+            CHECK(srs::approx_equal(xp(i, 0), ans(i), 1.0e-12));
+        }
+    }
+
+    SECTION("qr")
+    {
+        // Least squares fit of a straight line.
+        srs::dmatrix a = {{1.0, 1.0}, {1.0, 2.0}, {1.0, 3.0}, {1.0, 4.0}};
+        srs::dvector b = {6.0, 5.0, 7.0, 10.0};
+
+        srs::Qr qr(a);
+        srs::dvector x = b;
+        qr.solve(x);
+        CHECK(x.size() == 2);
+        CHECK(srs::approx_equal(x(0), 3.5, 1.0e-12));
+        CHECK(srs::approx_equal(x(1), 1.4, 1.0e-12));
+        CHECK(qr.rank() == 2);
+
+        srs::dmatrix qmat = qr.q();
+        srs::dmatrix rmat = qr.r();
+        CHECK(qmat.rows() == 4);
+        CHECK(qmat.cols() == 2);
+        srs::dmatrix qtq = srs::transpose(qmat) * qmat;
+        srs::dmatrix res = qmat * rmat;
+        for (int j = 0; j < 2; ++j) {
+            for (int i = 0; i < 2; ++i) {
+                double ans = (i == j) ? 1.0 : 0.0;
+                CHECK(srs::approx_equal(qtq(i, j), ans, 1.0e-12));
+            }
+            for (int i = 0; i < 4; ++i) {
+                CHECK(srs::approx_equal(res(i, j), a(i, j), 1.0e-12));
+            }
+        }
+
+        // Rank deficient problem with column pivoting.
+        srs::dmatrix c = {{1.0, 2.0, 1.0},
+                          {1.0, 4.0, 2.0},
+                          {1.0, 6.0, 3.0},
+                          {1.0, 8.0, 4.0}};
+        srs::Qr qrp(c, true);
+        CHECK(qrp.rank() == 2);
+        srs::ivector p = qrp.permutation();
+        CHECK(p(0) == 1);
+
+        srs::dvector y = b;
+        qrp.solve(y);
+        CHECK(y.size() == 3);
+        srs::dvector cy = c * y;
+        srs::dvector ax = a * x;
+        for (int i = 0; i < 4; ++i) {
+            CHECK(srs::approx_equal(cy(i), ax(i), 1.0e-12));
+        }
+    }
+
+    SECTION("orthonormalize")
+    {
+        const int n = 6;
+
+        srs::dmatrix orb = srs::randu(n, n);
+        for (int i = 0; i < n; ++i) {  // fourth orbital is linearly dependent
+            orb(i, 3) = orb(i, 0) + orb(i, 1);
+        }
+        srs::dmatrix a_mgs  = orb;
+        srs::dmatrix a_cgs2 = orb;
+        srs::dmatrix a_hh   = orb;
+        srs::dmatrix a_gs   = orb;
+        srs::orthonormalize(a_mgs, 4, srs::Mgs);
+        srs::orthonormalize(a_cgs2, 4, srs::Cgs2);
+        srs::orthonormalize(a_hh, 4, srs::Householder);
+        srs::schmidt(a_gs, 4);
+
+        for (auto* q : {&a_mgs, &a_cgs2, &a_hh}) {
+            srs::dmatrix qtq = srs::transpose(*q) * (*q);
+            for (int j = 0; j < n; ++j) {
+                for (int i = 0; i < n; ++i) {
+                    double ans = (i == j) ? 1.0 : 0.0;
+                    CHECK(srs::approx_equal(qtq(i, j), ans, 1.0e-12));
+                }
+            }
+        }
+        for (int j = 0; j < 3; ++j) {
+            for (int i = 0; i < n; ++i) {
+                CHECK(srs::approx_equal(a_cgs2(i, j), a_mgs(i, j), 1.0e-12));
+                CHECK(srs::approx_equal(a_hh(i, j), a_mgs(i, j), 1.0e-12));
+                CHECK(a_gs(i, j) == a_mgs(i, j));
+            }
+        }
+    }
+
+    SECTION("orthonormalize_fill")
+    {
+        // All unit vectors except e2 and e3, so that the basis can only be
+        // completed by those two.
+        const int m = 40;
+        const int n = m - 2;
+
+        srs::dmatrix orb(m, m, 0.0);
+        for (int j = 0, k = 0; k < m; ++k) {
+            if (k != 2 && k != 3) {
+                orb(k, j++) = 1.0;
+            }
+        }
+        srs::dmatrix a_mgs  = orb;
+        srs::dmatrix a_cgs2 = orb;
+        srs::dmatrix a_gs   = orb;
+        srs::orthonormalize(a_mgs, n, srs::Mgs);
+        srs::orthonormalize(a_cgs2, n, srs::Cgs2);
+        srs::schmidt(a_gs, n);
+
+        for (auto* q : {&a_mgs, &a_cgs2, &a_gs}) {
+            srs::dmatrix qtq = srs::transpose(*q) * (*q);
+            for (int j = 0; j < m; ++j) {
+                for (int i = 0; i < m; ++i) {
+                    double ans = (i == j) ? 1.0 : 0.0;
+                    CHECK(srs::approx_equal(qtq(i, j), ans, 1.0e-12));
+                }
+            }
+        }
+    }
+
+    SECTION("svd")
+    {
+        srs::dmatrix a = {{4.0, 0.0}, {3.0, -5.0}, {0.0, 1.0}};
+
+        srs::dmatrix tmp = a;
+        srs::dmatrix u;
+        srs::dvector s;
+        srs::dmatrix vt;
+        srs::svd(tmp, u, s, vt);
+        CHECK(u.rows() == 3);
+        CHECK(u.cols() == 2);
+        CHECK(vt.rows() == 2);
+        CHECK(s(0) >= s(1));
+
+        srs::dmatrix us = u;
+        for (int j = 0; j < 2; ++j) {
+            for (int i = 0; i < 3; ++i) {
+                us(i, j) *= s(j);
+            }
+        }
+        srs::dmatrix res = us * vt;
+        for (int j = 0; j < 2; ++j) {
+            for (int i = 0; i < 3; ++i) {
+                CHECK(srs::approx_equal(res(i, j), a(i, j), 1.0e-12));
+            }
+        }
+
+        srs::dvector sv;
+        tmp = a;
+        srs::svdvals(tmp, sv);
+        CHECK(srs::approx_equal(sv(0), s(0), 1.0e-12));
+        CHECK(srs::approx_equal(sv(1), s(1), 1.0e-12));
+
+        srs::dmatrix e(0, 3);  // empty matrix
+        srs::svd(e, u, s, vt);
+        CHECK(u.rows() == 0);
+        CHECK(s.size() == 0);
+        CHECK(vt.rows() == 0);
+        CHECK(vt.cols() == 3);
+        srs::svdvals(e, sv);
+        CHECK(sv.size() == 0);
+
+        srs::dmatrix ap  = srs::pinv(a);
+        srs::dmatrix apa = ap * a;
+        for (int j = 0; j < 2; ++j) {
+            for (int i = 0; i < 2; ++i) {
+                double ans = (i == j) ? 1.0 : 0.0;
+                CHECK(srs::approx_equal(apa(i, j), ans, 1.0e-12));
+            }
+        }
+
+        // Randomized SVD of a rank 3 matrix.
+        srs::dmatrix x = srs::randu(60, 3);
+        srs::dmatrix y = srs::randu(3, 40);
+        srs::dmatrix b = x * y;
+
+        srs::dmatrix ub;
+        srs::dvector sb;
+        srs::dmatrix vtb;
+        srs::svd_rand(b, ub, sb, vtb, 3);
+        CHECK(ub.cols() == 3);
+        CHECK(vtb.rows() == 3);
+
+        srs::dmatrix bb = b;
+        srs::svdvals(bb, sv);
+        for (int i = 0; i < 3; ++i) {
+            CHECK(srs::approx_equal(sb(i), sv(i), 1.0e-10));
+        }
+    }
+
     SECTION("eigs_band")
     {
         arma::mat aa = {{1.0, -2.0, 0.0, 0.0, 0.0},
@@ -341,6 +1052,46 @@ TEST_CASE("test_math")
         }
     }
 
+    SECTION("rfp")
+    {
+        srs::packed_dmatrix ap(srs::hilbert(6));
+        srs::dvector wp(6);
+        srs::dmatrix vp(6, 6);
+        srs::eigs(ap, vp, wp);
+
+        srs::rfp_dmatrix ar(srs::hilbert(6));
+        srs::dvector w;
+        srs::dmatrix v;
+        srs::eigs(ar, v, w);
+        CHECK(w.size() == 6);
+        for (int i = 0; i < w.size(); ++i) {
+            CHECK(srs::approx_equal(w(i), wp(i), 1.0e-12));
+        }
+        for (int j = 0; j < v.cols(); ++j) {
+            for (int i = 0; i < v.rows(); ++i) {
+                CHECK(srs::approx_equal(
+                    std::abs(v(i, j)), std::abs(vp(i, j)), 1.0e-10));
+            }
+        }
+
+        // c = 2 * a * a^T - c and c = a^T * a:
+        srs::dmatrix a = {{1.0, 2.0}, {0.0, -1.0}, {3.0, 1.0}};
+        srs::rfp_dmatrix c(3, 1.0);
+        srs::sfrk('N', 2.0, a, -1.0, c);
+        for (int j = 0; j < 3; ++j) {
+            for (int i = 0; i < 3; ++i) {
+                double aat = a(i, 0) * a(j, 0) + a(i, 1) * a(j, 1);
+                CHECK(srs::approx_equal(c(i, j), 2.0 * aat - 1.0, 1.0e-12));
+            }
+        }
+        srs::rfp_dmatrix ata;
+        srs::sfrk('T', 1.0, a, 0.0, ata);
+        CHECK(ata.rows() == 2);
+        CHECK(srs::approx_equal(ata(0, 0), 10.0, 1.0e-12));
+        CHECK(srs::approx_equal(ata(0, 1), 5.0, 1.0e-12));
+        CHECK(srs::approx_equal(ata(1, 1), 6.0, 1.0e-12));
+    }
+
     SECTION("eig")
     {
         arma::mat a1 = {{1.0, 5.0, 4.0, 2.0},
@@ -374,6 +1125,9 @@ TEST_CASE("test_math")
         }
     }
 
+#endif  // SRS_HAVE_LAPACK
+
+#ifdef SRS_USE_MKL
     SECTION("eig_band")
     {
         // Example from Intel MKL:
@@ -412,18 +1166,19 @@ TEST_CASE("test_math")
         // Example from Intel MKL:
 
         // clang-format off
-        int rows[12] = {0, 4, 9, 15, 22, 29, 36, 43, 50, 56, 61, 65};
-        int cols[65] = {0,   1,   2,   3,
-                        0,   1,   2,   3,   4,
-                        0,   1,   2,   3,   4,   5,
-                        0,   1,   2,   3,   4,   5,   6,
-                             1,   2,   3,   4,   5,   6,   7,
-                                  2,   3,   4,   5,   6,   7,   8,
-                                       3,   4,   5,   6,   7,   8,  9,
-                                            4,   5,   6,   7,   8,  9,  10,
-                                                 5,   6,   7,   8,  9,  10,
-                                                      6,   7,   8,  9,  10,
-                                                           7,   8,  9,  10
+        srs::Int_t rows[12] = {0, 4, 9, 15, 22, 29, 36, 43, 50, 56, 61, 65};
+        srs::Int_t cols[65] = {
+            0,   1,   2,   3,
+            0,   1,   2,   3,   4,
+            0,   1,   2,   3,   4,   5,
+            0,   1,   2,   3,   4,   5,   6,
+                 1,   2,   3,   4,   5,   6,   7,
+                      2,   3,   4,   5,   6,   7,   8,
+                           3,   4,   5,   6,   7,   8,  9,
+                                4,   5,   6,   7,   8,  9,  10,
+                                     5,   6,   7,   8,  9,  10,
+                                          6,   7,   8,  9,  10,
+                                               7,   8,  9,  10
         };
         double val[65] = {5.0, 2.0, 1.0, 1.0,
                           2.0, 6.0, 3.0, 1.0, 1.0,
@@ -458,8 +1213,19 @@ TEST_CASE("test_math")
         for (int i = 0; i < 6; ++i) {
             CHECK(srs::approx_equal(w(i), gsl::at(eig, i), 1.0e-12));
         }
+
+        // Same problem with only the upper triangle stored:
+        srs::dmatrix vs;
+        srs::dvector ws;
+        srs::eig(emin, emax, srs::sym_sparse_dmatrix(a), vs, ws);
+        CHECK(ws.size() == w.size());
+        for (int i = 0; i < 6; ++i) {
+            CHECK(srs::approx_equal(ws(i), gsl::at(eig, i), 1.0e-12));
+        }
     }
 
+#endif  // SRS_USE_MKL
+
     SECTION("inv")
     {
         arma::mat aa = {{1.0, 5.0, 4.0, 2.0},
@@ -507,6 +1273,35 @@ TEST_CASE("test_math")
         }
     }
 
+    SECTION("linsolve_tridiag")
+    {
+        // 1D diffusion matrix, tridiag(-1, 2, -1).
+        const int n = 37;
+        srs::band_dmatrix a(n, n, 1, 1);
+        for (int i = 0; i < n; ++i) {
+            a(i, i) = 2.0;
+            if (i > 0) {
+                a(i, i - 1) = -1.0;
+                a(i - 1, i) = -1.0;
+            }
+        }
+        // Solution x(i) = (i + 1) * (n - i) / 2 for b = 1.
+        srs::dmatrix b(n, 2, 1.0);
+        srs::dvector bv(n, 1.0);
+        srs::dmatrix bp = b;
+        srs::linsolve_tridiag(a, b);
+        srs::linsolve_tridiag(a, bv);
+        srs::linsolve_tridiag(a, bp, srs::Pcr);
+        for (int i = 0; i < n; ++i) {
+            double xi = 0.5 * (i + 1) * (n - i);
+            CHECK(srs::approx_equal(b(i, 0), xi, 1.0e-10));
+            CHECK(srs::approx_equal(b(i, 1), xi, 1.0e-10));
+            CHECK(srs::approx_equal(bv(i), xi, 1.0e-10));
+            CHECK(srs::approx_equal(bp(i, 0), xi, 1.0e-10));
+            CHECK(srs::approx_equal(bp(i, 1), xi, 1.0e-10));
+        }
+    }
+
     SECTION("stat")
     {
         srs::dvector a = {3.0,
@@ -546,6 +1341,7 @@ TEST_CASE("test_math")
         CHECK(srs::trace(asub) == 4);
     }
 
+#ifdef SRS_USE_MKL
     SECTION("sparse_linsolve")
     {
         using size_type = srs::dvector::size_type;
@@ -569,10 +1365,33 @@ TEST_CASE("test_math")
         }
     }
 
+    SECTION("sym_sparse_linsolve")
+    {
+        // Symmetric indefinite matrix, only the upper triangle is stored:
+        srs::dmatrix m = {{4, 1, 0, 2, 0},
+                          {1, -3, 2, 0, 0},
+                          {0, 2, 5, 1, 1},
+                          {2, 0, 1, -2, 0},
+                          {0, 0, 1, 0, 3}};
+
+        srs::sym_sparse_dmatrix a(srs::sparse_gather(m));
+        srs::dvector b = {1.0, 5.0, 1.0, 4.0, 1.0};
+        srs::dvector x;
+        srs::linsolve(a, b, x);
+
+        srs::dmatrix xans(5, 1, b.data());
+        srs::linsolve(m, xans);
+        for (int i = 0; i < 5; ++i) {
+            CHECK(srs::approx_equal(x(i), xans(i, 0), 1.0e-12));
+        }
+    }
+
+#endif  // SRS_USE_MKL
+
     SECTION("zeros")
     {
-        srs::ivector a = srs::zeros<srs::Array<int, 1>>(3);
-        srs::imatrix b = srs::zeros<srs::Array<int, 2>>(3, 4);
+        srs::ivector a = srs::zeros<srs::ivector>(3);
+        srs::imatrix b = srs::zeros<srs::imatrix>(3, 4);
         CHECK(a.size() == 3);
         CHECK(b.rows() == 3);
         CHECK(b.cols() == 4);
@@ -580,7 +1399,7 @@ TEST_CASE("test_math")
 
     SECTION("ones")
     {
-        srs::ivector a = srs::ones<srs::Array<int, 1>>(3);
+        srs::ivector a = srs::ones<srs::ivector>(3);
         CHECK(a.size() == 3);
         CHECK(a(0) == 1);
         CHECK(a(1) == 1);
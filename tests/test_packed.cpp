@@ -16,14 +16,75 @@
 
 #include <srs/packed.h>
 #include <catch/catch.hpp>
+#include <cmath>
 
 
 TEST_CASE("test_packed")
 {
-    int upper[10] = {1, 2, 2, 3, 3, 3, 4, 4, 4, 4};
+    srs::Int_t upper[10] = {1, 2, 2, 3, 3, 3, 4, 4, 4, 4};
     srs::packed_imatrix u(4, upper);
     CHECK(u.rows() == 4);
     CHECK(u.cols() == 4);
     CHECK(u(3, 0) == 4);
     CHECK(u(0, 3) == 4);
+
+    SECTION("pmv_mul")
+    {
+        const int n = 5;
+        srs::packed_dmatrix ap(n);
+        srs::dmatrix a(n, n);
+        for (int j = 0; j < n; ++j) {
+            for (int i = 0; i <= j; ++i) {
+                ap(i, j) = 1.0 + i + 2.0 * j;
+                a(i, j)  = ap(i, j);
+                a(j, i)  = ap(i, j);
+            }
+        }
+        srs::dvector v(n);
+        for (int i = 0; i < n; ++i) {
+            v(i) = 1.0 - 0.5 * i;
+        }
+        srs::dvector w = ap * v;
+        CHECK(w.size() == n);
+        for (int i = 0; i < n; ++i) {
+            double wi = 0.0;
+            for (int k = 0; k < n; ++k) {
+                wi += a(i, k) * v(k);
+            }
+            CHECK(std::abs(w(i) - wi) < 1.0e-12);
+        }
+    }
+
+    SECTION("pmm_mul")
+    {
+        const int n = 7;
+        const int m = 35;  // spans several column blocks
+        srs::packed_dmatrix ap(n);
+        srs::dmatrix a(n, n);
+        for (int j = 0; j < n; ++j) {
+            for (int i = 0; i <= j; ++i) {
+                ap(i, j) = 0.5 * i - j + 3.0;
+                a(i, j)  = ap(i, j);
+                a(j, i)  = ap(i, j);
+            }
+        }
+        srs::dmatrix b(n, m);
+        for (int j = 0; j < m; ++j) {
+            for (int i = 0; i < n; ++i) {
+                b(i, j) = std::sin(1.0 + i + n * j);
+            }
+        }
+        srs::dmatrix c = ap * b;
+        CHECK(c.rows() == n);
+        CHECK(c.cols() == m);
+        for (int j = 0; j < m; ++j) {
+            for (int i = 0; i < n; ++i) {
+                double cij = 0.0;
+                for (int k = 0; k < n; ++k) {
+                    cij += a(i, k) * b(k, j);
+                }
+                CHECK(std::abs(c(i, j) - cij) < 1.0e-12);
+            }
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 Stig Rune Sellevag. All rights reserved.
+//
+// This code is licensed under the MIT License (MIT).
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <srs/array.h>
+#include <srs/packed.h>
+#include <srs/rfp.h>
+#include <catch/catch.hpp>
+#include <cmath>
+
+
+TEST_CASE("test_rfp")
+{
+    SECTION("layout")
+    {
+        // LAPACK example for n = 5, transr = 'N' and uplo = 'U'.
+        srs::rfp_dmatrix a(5);
+        for (int j = 0; j < 5; ++j) {
+            for (int i = 0; i <= j; ++i) {
+                a(i, j) = 10 * i + j;
+            }
+        }
+        const double ans[] = {2,  12, 22, 0,  1,  3,  13, 23,
+                              33, 11, 4,  14, 24, 34, 44};
+        CHECK(a.size() == 15);
+        CHECK(a.leading_dim() == 5);
+        for (int i = 0; i < a.size(); ++i) {
+            CHECK(a.data()[i] == ans[i]);
+        }
+        CHECK(a(4, 1) == 14);
+
+        srs::rfp_dmatrix b(6);
+        CHECK(b.size() == 21);
+        CHECK(b.leading_dim() == 7);
+    }
+
+    SECTION("conversions")
+    {
+        for (int n = 1; n <= 6; ++n) {
+            srs::packed_dmatrix ap(n);
+            for (int j = 0; j < n; ++j) {
+                for (int i = 0; i <= j; ++i) {
+                    ap(i, j) = 1.0 + i + n * j;
+                }
+            }
+            srs::rfp_dmatrix a(ap);
+            srs::dmatrix d = srs::to_dense(a);
+            for (int j = 0; j < n; ++j) {
+                for (int i = 0; i < n; ++i) {
+                    CHECK(d(i, j) == ap(i, j));
+                }
+            }
+            CHECK(srs::to_packed(a) == ap);
+            CHECK(srs::rfp_dmatrix(d) == a);
+        }
+    }
+
+    SECTION("mv_mul")
+    {
+        for (int n = 4; n <= 5; ++n) {
+            srs::dmatrix d(n, n);
+            for (int j = 0; j < n; ++j) {
+                for (int i = 0; i <= j; ++i) {
+                    d(i, j) = std::cos(1.0 + i + n * j);
+                    d(j, i) = d(i, j);
+                }
+            }
+            srs::rfp_dmatrix a(d);
+            srs::dvector v(n);
+            for (int i = 0; i < n; ++i) {
+                v(i) = 1.0 - 0.5 * i;
+            }
+            srs::dvector w = a * v;
+            CHECK(w.size() == n);
+            for (int i = 0; i < n; ++i) {
+                double wi = 0.0;
+                for (int k = 0; k < n; ++k) {
+                    wi += d(i, k) * v(k);
+                }
+                CHECK(std::abs(w(i) - wi) < 1.0e-12);
+            }
+        }
+    }
+
+    SECTION("mm_mul")
+    {
+        const int m = 3;
+        for (int n = 6; n <= 7; ++n) {
+            srs::dmatrix d(n, n);
+            for (int j = 0; j < n; ++j) {
+                for (int i = 0; i <= j; ++i) {
+                    d(i, j) = std::sin(1.0 + i + n * j);
+                    d(j, i) = d(i, j);
+                }
+            }
+            srs::dmatrix b(n, m);
+            for (int j = 0; j < m; ++j) {
+                for (int i = 0; i < n; ++i) {
+                    b(i, j) = 0.25 * i - j;
+                }
+            }
+            srs::rfp_dmatrix a(d);
+            srs::dmatrix c = a * b;
+            CHECK(c.rows() == n);
+            CHECK(c.cols() == m);
+            for (int j = 0; j < m; ++j) {
+                for (int i = 0; i < n; ++i) {
+                    double cij = 0.0;
+                    for (int k = 0; k < n; ++k) {
+                        cij += d(i, k) * b(k, j);
+                    }
+                    CHECK(std::abs(c(i, j) - cij) < 1.0e-12);
+                }
+            }
+        }
+    }
+}
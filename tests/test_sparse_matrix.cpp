@@ -17,6 +17,11 @@
 #include <srs/math.h>
 #include <srs/sparse.h>
 #include <catch/catch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <utility>
 #include <vector>
 
 
@@ -28,7 +33,7 @@ TEST_CASE("sparse_matrix")
                         {16, 0, 18, 19, 0},
                         {0, 22, 0, 0, 25}};
 
-    srs::Sparse_matrix<int> spmat = srs::sparse_gather(mat);
+    srs::sparse_imatrix spmat = srs::sparse_gather(mat);
 
     SECTION("element_access")
     {
@@ -36,6 +41,33 @@ TEST_CASE("sparse_matrix")
         CHECK(spmat(0, 2) == 0);
     }
 
+    SECTION("long_rows")
+    {
+        // Rows with more than 16 elements are searched by bisection.
+        srs::Sparse_builder<srs::Int_t> builder(3, 100);
+        for (int j = 0; j < 100; j += 3) {
+            builder.add(1, j, j + 1);
+        }
+        builder.add(2, 99, 7);
+        srs::sparse_imatrix a = builder.compress();
+        for (int j = 0; j < 100; ++j) {
+            CHECK(a(1, j) == ((j % 3 == 0) ? j + 1 : 0));
+            CHECK(a(0, j) == 0);
+        }
+        CHECK(a(2, 99) == 7);
+
+        a.insert(1, 50, -1);
+        CHECK(a(1, 50) == -1);
+        CHECK(a(1, 51) == 52);
+        CHECK(a.num_nonzero() == 36);
+
+        srs::imatrix d = srs::sparse_scatter(a);
+        CHECK(d(1, 50) == -1);
+        CHECK(d(1, 99) == 100);
+        CHECK(d(2, 99) == 7);
+        CHECK(d(0, 0) == 0);
+    }
+
     SECTION("insert")
     {
         spmat.insert(0, 2, 3);
@@ -62,7 +94,7 @@ TEST_CASE("sparse_matrix")
 
     SECTION("resize")
     {
-        srs::Sparse_matrix<int> m;
+        srs::sparse_imatrix m;
         m.resize(1000, 500, 3);
 
         m.insert(0, 1, 1);
@@ -76,10 +108,571 @@ TEST_CASE("sparse_matrix")
 
     SECTION("scatter") { CHECK(srs::sparse_scatter(spmat) == mat); }
 
+    SECTION("builder")
+    {
+        // Add the elements in reverse order, split into two parts.
+        srs::Sparse_builder<srs::Int_t> builder(5, 5);
+        builder.reserve(50);
+#pragma omp parallel for
+        for (int k = 24; k >= 0; --k) {
+            int i = k / 5;
+            int j = k % 5;
+            if (mat(i, j) != 0) {
+                builder.add(i, j, mat(i, j) - 1);
+                builder.add(i, j, 1);
+            }
+        }
+        CHECK(builder.num_triplets() == 26);
+
+        srs::sparse_imatrix b = builder.compress();
+        CHECK(b.num_nonzero() == 13);
+        CHECK(b.columns() == spmat.columns());
+        CHECK(b.row_index() == spmat.row_index());
+        CHECK(b.values() == spmat.values());
+
+        builder.clear();
+        builder.add(4, 0, 1);
+        builder.add(4, 0, -1);
+        srs::sparse_imatrix z = builder.compress();
+        CHECK(z.num_nonzero() == 1);
+        CHECK(z(4, 0) == 0);
+        CHECK(z.row_index()[4] == 0);
+        CHECK(z.row_index()[5] == 1);
+    }
+
     SECTION("mv_mul")
     {
         srs::ivector x   = {1, 2, 3, 4, 5};
         srs::ivector ans = {21, 20, 170, 146, 169};
         CHECK(ans == spmat * x);
     }
+
+    SECTION("transpose")
+    {
+        srs::imatrix at = srs::transpose(mat);
+        CHECK(srs::sparse_scatter(srs::transpose(spmat)) == at);
+        CHECK(srs::transpose(srs::transpose(spmat)).columns()
+              == spmat.columns());
+
+        srs::imatrix r = {{0, 1, 0}, {0, 0, 0}, {2, 0, 3}, {0, 4, 0}};
+        srs::sparse_imatrix rt = srs::transpose(srs::sparse_gather(r));
+        CHECK(rt.rows() == 3);
+        CHECK(rt.cols() == 4);
+        CHECK(srs::sparse_scatter(rt) == srs::transpose(r));
+    }
+
+    SECTION("add")
+    {
+        srs::imatrix b = {{0, 1, 1, 0, 0},
+                          {0, -7, 0, 0, 0},
+                          {0, 0, 0, 0, 0},
+                          {1, 0, 0, 0, 1},
+                          {0, 0, 0, 2, 0}};
+        srs::sparse_imatrix spb = srs::sparse_gather(b);
+        CHECK(srs::sparse_scatter(spmat + spb) == mat + b);
+        CHECK(srs::sparse_scatter(spmat - spb) == mat - b);
+
+        srs::sparse_imatrix c
+            = srs::sparse_add(srs::Int_t{2}, spmat, srs::Int_t{3}, spb);
+        CHECK(c.num_nonzero() == 16);  // union of the two patterns
+        CHECK(srs::sparse_scatter(c)
+              == srs::Int_t{2} * mat + srs::Int_t{3} * b);
+    }
+
+    SECTION("spgemm")
+    {
+        srs::imatrix b = {
+            {0, 1, 0}, {2, 0, 0}, {0, 0, 3}, {1, 1, 0}, {0, 0, 1}};
+        srs::sparse_imatrix spb = srs::sparse_gather(b);
+        srs::sparse_imatrix c   = spmat * spb;
+        CHECK(c.rows() == 5);
+        CHECK(c.cols() == 3);
+        CHECK(srs::sparse_scatter(c) == mat * b);
+        for (int i = 0; i < c.rows(); ++i) {
+            for (int k = c.row_index()[i] + 1; k < c.row_index()[i + 1]; ++k) {
+                CHECK(c.columns()[k - 1] < c.columns()[k]);
+            }
+        }
+
+        // Galerkin product p^T * a * p.
+        srs::sparse_imatrix g = srs::transpose(spb) * spmat * spb;
+        CHECK(srs::sparse_scatter(g) == srs::transpose(b) * mat * b);
+    }
+
+    SECTION("sparse_mv")
+    {
+        srs::dmatrix d(40, 30, 0.0);
+        for (int i = 0; i < 40; ++i) {
+            for (int j = 0; j < 30; ++j) {
+                if ((i * 7 + j * 3) % 5 == 0 || (i > 30 && j < 20)) {
+                    d(i, j) = 1.0 + 0.1 * i - 0.2 * j;
+                }
+            }
+        }
+        srs::sparse_dmatrix a = srs::sparse_gather(d);
+        srs::dvector x(30);
+        srs::dvector z(40);
+        for (int j = 0; j < 30; ++j) {
+            x(j) = std::sin(1.0 + j);
+        }
+        for (int i = 0; i < 40; ++i) {
+            z(i) = std::cos(1.0 + i);
+        }
+
+        srs::Sparse_mv<double> engine(a, 10);
+        CHECK(engine.partition().front() == 0);
+        CHECK(engine.partition().back() == 40);
+
+        // y = 2 * a * x - y and w = 0.5 * a^T * z + w:
+        srs::dvector y(40, 1.0);
+        srs::dvector w(30, 1.0);
+        engine.mv('N', 2.0, x, -1.0, y);
+        engine.mv('T', 0.5, z, 1.0, w);
+        for (int i = 0; i < 40; ++i) {
+            double ans = -1.0;
+            for (int j = 0; j < 30; ++j) {
+                ans += 2.0 * d(i, j) * x(j);
+            }
+            CHECK(std::abs(y(i) - ans) < 1.0e-12);
+        }
+        for (int j = 0; j < 30; ++j) {
+            double ans = 1.0;
+            for (int i = 0; i < 40; ++i) {
+                ans += 0.5 * d(i, j) * z(i);
+            }
+            CHECK(std::abs(w(j) - ans) < 1.0e-12);
+        }
+
+        srs::dvector v;
+        srs::mv_mul('T', 1.0, a, z, 0.0, v);
+        CHECK(v.size() == 30);
+        CHECK(std::abs(v(3) - 2.0 * (w(3) - 1.0)) < 1.0e-12);
+
+        srs::dvector u = a * x;
+        CHECK(u.size() == 40);
+        CHECK(std::abs(u(35) - 0.5 * (y(35) + 1.0)) < 1.0e-12);
+    }
+
+    SECTION("spmm")
+    {
+        srs::dmatrix d(40, 30, 0.0);
+        for (int i = 0; i < 40; ++i) {
+            for (int j = 0; j < 30; ++j) {
+                if ((i * 7 + j * 3) % 5 == 0 || (i > 30 && j < 20)) {
+                    d(i, j) = 1.0 + 0.1 * i - 0.2 * j;
+                }
+            }
+        }
+        srs::sparse_dmatrix a = srs::sparse_gather(d);
+
+        // Eleven columns give one full and one partial panel:
+        srs::dmatrix b(30, 11);
+        for (int j = 0; j < 11; ++j) {
+            for (int k = 0; k < 30; ++k) {
+                b(k, j) = std::sin(1.0 + k + 0.3 * j);
+            }
+        }
+
+        srs::dmatrix c;
+        srs::mm_mul(a, b, c);
+        CHECK(c.rows() == 40);
+        CHECK(c.cols() == 11);
+        for (int i = 0; i < 40; ++i) {
+            for (int j = 0; j < 11; ++j) {
+                double ans = 0.0;
+                for (int k = 0; k < 30; ++k) {
+                    ans += d(i, k) * b(k, j);
+                }
+                CHECK(std::abs(c(i, j) - ans) < 1.0e-12);
+            }
+        }
+
+        // c = 2 * a * b - c:
+        srs::dmatrix e = c;
+        srs::Sparse_mv<double>(a).mm(2.0, b, -1.0, e);
+        for (int i = 0; i < 40; ++i) {
+            for (int j = 0; j < 11; ++j) {
+                CHECK(std::abs(e(i, j) - c(i, j)) < 1.0e-12);
+            }
+        }
+
+        srs::dmatrix f = a * b;
+        CHECK(f == c);
+    }
+
+    SECTION("reorder")
+    {
+        // 5-point Laplacian on a 12 x 12 grid with scrambled numbering:
+        const int ng = 12;
+        const int n  = ng * ng;
+        srs::dmatrix d(n, n, 0.0);
+        for (int x = 0; x < ng; ++x) {
+            for (int y = 0; y < ng; ++y) {
+                int i   = x * ng + y;
+                d(i, i) = 4.0;
+                if (x > 0) {
+                    d(i, i - ng) = -1.0;
+                    d(i - ng, i) = -1.0;
+                }
+                if (y > 0) {
+                    d(i, i - 1) = -1.0;
+                    d(i - 1, i) = -1.0;
+                }
+            }
+        }
+        std::vector<srs::Int_t> scramble(n);
+        for (int k = 0; k < n; ++k) {
+            scramble[k] = (k * 37) % n;
+        }
+        srs::sparse_dmatrix a
+            = srs::permute(srs::sparse_gather(d), scramble);
+
+        for (int k = 0; k < n; ++k) {
+            for (int l = 0; l < n; ++l) {
+                CHECK(a(k, l) == d(scramble[k], scramble[l]));
+            }
+        }
+
+        srs::Sparse_graph g(a);
+        CHECK(g.num_vertices() == n);
+        CHECK(g.num_edges() == 2 * ng * (ng - 1));
+
+        // Number of nonzeros in the Cholesky factor of a symmetric matrix:
+        auto fill = [](const srs::sparse_dmatrix& b) {
+            int m = b.rows();
+            std::vector<std::vector<char>> f(m, std::vector<char>(m, 0));
+            for (int i = 0; i < m; ++i) {
+                for (int j = 0; j < m; ++j) {
+                    f[i][j] = (b(i, j) != 0.0);
+                }
+            }
+            int count = 0;
+            for (int k = 0; k < m; ++k) {
+                for (int i = k; i < m; ++i) {
+                    if (f[i][k]) {
+                        ++count;
+                        for (int j = k + 1; j < m; ++j) {
+                            if (f[j][k]) {
+                                f[i][j] = 1;
+                            }
+                        }
+                    }
+                }
+            }
+            return count;
+        };
+
+        std::vector<std::vector<srs::Int_t>> orders = {
+            srs::rcm(a), srs::amd(a), srs::nested_dissection(a, 8)};
+        for (const auto& perm : orders) {
+            std::vector<srs::Int_t> sorted(perm);
+            std::sort(sorted.begin(), sorted.end());
+            for (int k = 0; k < n; ++k) {
+                CHECK(sorted[k] == k);
+            }
+            CHECK(fill(srs::permute(a, perm)) < fill(a));
+        }
+
+        srs::sparse_dmatrix b = srs::permute(a, orders[0]);
+        auto bw               = srs::bandwidth(b);
+        CHECK(bw[0] == bw[1]);
+        CHECK(bw[0] <= ng + 1);
+        CHECK(srs::bandwidth(a)[0] > 2 * ng);
+
+        srs::band_dmatrix ab = srs::to_band(b);
+        CHECK(ab.lower() == bw[0]);
+        CHECK(ab.upper() == bw[1]);
+        CHECK(ab(5, 5) == 4.0);
+        CHECK(ab(5, 5 + bw[1]) == b(5, 5 + bw[1]));
+
+        srs::dvector x(n);
+        for (int i = 0; i < n; ++i) {
+            x(i) = std::sin(1.0 + i);
+        }
+        srs::dvector px = srs::permute(x, orders[1]);
+        CHECK(px(7) == x(orders[1][7]));
+        CHECK(srs::inverse_permute(px, orders[1]) == x);
+
+        // The permuted matrix maps permuted vectors:
+        srs::dvector y  = a * x;
+        srs::dvector py = srs::permute(a, orders[1]) * px;
+        srs::dvector z  = srs::inverse_permute(py, orders[1]);
+        for (int i = 0; i < n; ++i) {
+            CHECK(std::abs(z(i) - y(i)) < 1.0e-12);
+        }
+    }
+
+    SECTION("sym_sparse")
+    {
+        srs::dmatrix d(40, 40, 0.0);
+        for (int i = 0; i < 40; ++i) {
+            for (int j = i; j < 40; ++j) {
+                if ((i * 7 + j * 3) % 5 == 1 || (j - i < 3 && i % 9 != 4)) {
+                    d(i, j) = 1.0 + 0.1 * i + 0.2 * j;
+                    d(j, i) = d(i, j);
+                }
+            }
+        }
+        srs::sparse_dmatrix a = srs::sparse_gather(d);
+        srs::sym_sparse_dmatrix s(a);
+        CHECK(s.rows() == 40);
+        // Four diagonal elements are stored as explicit zeros:
+        CHECK(s.num_nonzero() == (a.num_nonzero() + 44) / 2);
+        CHECK(s(4, 4) == 0.0);
+        CHECK(s(3, 5) == d(3, 5));
+        CHECK(s(5, 3) == d(5, 3));
+        CHECK(s(0, 39) == d(0, 39));
+        CHECK(srs::sparse_scatter(srs::to_sparse(s)) == d);
+
+        srs::dvector x(40);
+        for (int j = 0; j < 40; ++j) {
+            x(j) = std::sin(1.0 + j);
+        }
+
+        // y = 2 * s * x - y:
+        srs::dvector y(40, 1.0);
+        srs::mv_mul(2.0, s, x, -1.0, y);
+        srs::dvector z = a * x;
+        for (int i = 0; i < 40; ++i) {
+            CHECK(std::abs(y(i) - (2.0 * z(i) - 1.0)) < 1.0e-12);
+        }
+
+        srs::dvector u = s * x;
+        for (int i = 0; i < 40; ++i) {
+            CHECK(std::abs(u(i) - z(i)) < 1.0e-12);
+        }
+    }
+
+    SECTION("matrix_market")
+    {
+        const std::string general
+            = "%%MatrixMarket matrix coordinate real general\n"
+              "% comment\n"
+              "\n"
+              "3 4 5\n"
+              "1 1 1.5\n"
+              "3 4 -2e3\n"
+              "\n"
+              "2 2 7\n"
+              "1 4 0.25\n"
+              "3 1 3";
+        srs::imatrix ans = {{1, 0, 0, 0}, {0, 7, 0, 0}, {3, 0, 0, -2000}};
+        for (std::size_t chunk : {4, 16, 1 << 20}) {
+            std::istringstream from(general);
+            srs::sparse_dmatrix a;
+            srs::read_matrix_market(from, a, chunk);
+            CHECK(a.rows() == 3);
+            CHECK(a.cols() == 4);
+            CHECK(a.num_nonzero() == 5);
+            CHECK(a(0, 0) == 1.5);
+            CHECK(a(0, 3) == 0.25);
+            CHECK(a(2, 3) == -2000.0);
+            CHECK(a(2, 0) == 3.0);
+        }
+
+        std::istringstream sym("%%MatrixMarket matrix coordinate integer "
+                               "symmetric\n3 3 4\n1 1 2\n2 1 -1\n"
+                               "3 2 -1\n3 3 2\n");
+        srs::sparse_imatrix b;
+        srs::read_matrix_market(sym, b, 8);
+        srs::imatrix bd = {{2, -1, 0}, {-1, 0, -1}, {0, -1, 2}};
+        CHECK(srs::sparse_scatter(b) == bd);
+
+        std::istringstream skew("%%MatrixMarket matrix coordinate pattern "
+                                "skew-symmetric\n3 3 2\n2 1\n3 1\n");
+        srs::read_matrix_market(skew, b);
+        srs::imatrix sd = {{0, -1, -1}, {1, 0, 0}, {1, 0, 0}};
+        CHECK(srs::sparse_scatter(b) == sd);
+
+        std::istringstream arr("%%MatrixMarket matrix array integer "
+                               "general\n2 3\n1\n0\n0\n4\n5\n0\n");
+        srs::read_matrix_market(arr, b, 5);
+        srs::imatrix ad = {{1, 0, 5}, {0, 4, 0}};
+        CHECK(b.num_nonzero() == 3);
+        CHECK(srs::sparse_scatter(b) == ad);
+
+        std::istringstream sarr("%%MatrixMarket matrix array real "
+                                "symmetric\n3 3\n1\n2\n0\n4\n5\n6\n");
+        srs::read_matrix_market(sarr, b, 6);
+        srs::imatrix sad = {{1, 2, 0}, {2, 4, 5}, {0, 5, 6}};
+        CHECK(srs::sparse_scatter(b) == sad);
+
+        std::istringstream bad("%%MatrixMarket matrix coordinate real "
+                               "general\n2 2 2\n1 1 1.0\n3 1 1.0\n");
+        CHECK_THROWS_AS(srs::read_matrix_market(bad, b), srs::Sparse_io_error);
+
+        std::istringstream few("%%MatrixMarket matrix coordinate real "
+                               "general\n2 2 3\n1 1 1.0\n2 1 1.0\n");
+        CHECK_THROWS_AS(srs::read_matrix_market(few, b), srs::Sparse_io_error);
+
+        std::istringstream cplx("%%MatrixMarket matrix coordinate complex "
+                                "general\n1 1 1\n1 1 1.0 0.0\n");
+        CHECK_THROWS_AS(srs::read_matrix_market(cplx, b), srs::Sparse_io_error);
+
+        // Round trip:
+        std::stringstream ss;
+        srs::write_matrix_market(ss, spmat);
+        srs::sparse_imatrix c;
+        srs::read_matrix_market(ss, c);
+        CHECK(srs::sparse_scatter(c) == mat);
+    }
+
+    SECTION("binary")
+    {
+        srs::Sparse_builder<double> builder(50, 100000);
+        for (int i = 0; i < 50; ++i) {
+            builder.add(i, i, 1.0 + i);
+            builder.add(i, (i * 7919) % 100000, -0.5);
+            builder.add(i, 99999 - i, 1.0 / (i + 1));
+        }
+        srs::sparse_dmatrix a = builder.compress();
+
+        std::stringstream ss(std::ios_base::in | std::ios_base::out
+                             | std::ios_base::binary);
+        srs::write_binary(ss, a);
+        srs::sparse_dmatrix b;
+        srs::read_binary(ss, b);
+        CHECK(b.rows() == a.rows());
+        CHECK(b.cols() == a.cols());
+        CHECK(b.values() == a.values());
+        CHECK(b.columns() == a.columns());
+        CHECK(b.row_index() == a.row_index());
+
+        // Wrong value size and truncated files:
+        ss.clear();
+        ss.seekg(0);
+        srs::Sparse_matrix<float> c;
+        CHECK_THROWS_AS(srs::read_binary(ss, c), srs::Sparse_io_error);
+
+        std::string bytes = ss.str();
+        std::istringstream part(bytes.substr(0, bytes.size() - 9));
+        CHECK_THROWS_AS(srs::read_binary(part, b), srs::Sparse_io_error);
+
+        std::istringstream junk("not a sparse matrix");
+        CHECK_THROWS_AS(srs::read_binary(junk, b), srs::Sparse_io_error);
+    }
+
+    SECTION("sell")
+    {
+        // Rows of varying length, with empty rows and a row count that is
+        // not a multiple of the chunk size.
+        srs::dmatrix d(45, 30, 0.0);
+        for (int i = 0; i < 45; ++i) {
+            for (int j = 0; j < (i * 7) % 13; ++j) {
+                d(i, (i + 5 * j) % 30) = 1.0 + 0.1 * i - 0.2 * j;
+            }
+        }
+        srs::sparse_dmatrix a = srs::sparse_gather(d);
+        srs::dvector x(30);
+        for (int j = 0; j < 30; ++j) {
+            x(j) = std::sin(1.0 + j);
+        }
+        srs::dvector ans = a * x;
+
+        srs::Sell_matrix<double> s(a, 4, 16);
+        CHECK(s.rows() == 45);
+        CHECK(s.cols() == 30);
+        CHECK(s.num_chunks() == 12);
+        CHECK(s.num_nonzero() == a.num_nonzero());
+        CHECK(s.num_stored() >= s.num_nonzero());
+
+        srs::dvector y = s * x;
+        for (int i = 0; i < 45; ++i) {
+            CHECK(std::abs(y(i) - ans(i)) < 1.0e-12);
+        }
+        srs::mv_mul(2.0, s, x, -1.0, y);
+        for (int i = 0; i < 45; ++i) {
+            CHECK(std::abs(y(i) - ans(i)) < 1.0e-12);
+        }
+
+        srs::Sell_matrix<double> s1(a, 1, 1);  // plain CSR order
+        CHECK(s1.num_stored() == a.num_nonzero());
+        srs::dvector y1 = s1 * x;
+        for (int i = 0; i < 45; ++i) {
+            CHECK(std::abs(y1(i) - ans(i)) < 1.0e-12);
+        }
+
+        // Sorting windows that are not a multiple of the chunk size, with
+        // both the fixed-width and the generic kernels.
+        const std::vector<std::pair<int, int>> params = {
+            {4, 1}, {4, 2}, {4, 6}, {3, 256}, {8, 5}, {16, 7}, {32, 3}};
+        for (const auto& p : params) {
+            srs::Sell_matrix<double> sp(a, p.first, p.second);
+            CHECK(sp.num_nonzero() == a.num_nonzero());
+            srs::dvector yp = sp * x;
+            for (int i = 0; i < 45; ++i) {
+                CHECK(std::abs(yp(i) - ans(i)) < 1.0e-12);
+            }
+        }
+    }
+
+    SECTION("block_sparse")
+    {
+        // Block tridiagonal matrix with 3 x 3 blocks, some of them sparse.
+        const int n = 15;
+        srs::dmatrix d(n, n, 0.0);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                int bi = i / 3;
+                int bj = j / 3;
+                if (i == j) {
+                    d(i, j) = 10.0 + i;
+                }
+                else if (std::abs(bi - bj) <= 1 && (i + 2 * j) % 4 != 0) {
+                    d(i, j) = std::sin(1.0 + i + n * j);
+                }
+            }
+        }
+        srs::sparse_dmatrix a = srs::sparse_gather(d);
+        srs::Block_sparse_matrix<double, 3, 3> ab(a);
+        CHECK(ab.num_block_rows() == 5);
+        CHECK(ab.num_blocks() == 13);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                CHECK(ab(i, j) == d(i, j));
+            }
+        }
+
+        srs::dvector x(n);
+        for (int i = 0; i < n; ++i) {
+            x(i) = 1.0 - 0.1 * i;
+        }
+        srs::dvector ans = a * x;
+        srs::dvector y   = ab * x;
+        for (int i = 0; i < n; ++i) {
+            CHECK(std::abs(y(i) - ans(i)) < 1.0e-12);
+        }
+
+        srs::dmatrix b(n, 4);
+        for (int j = 0; j < 4; ++j) {
+            for (int i = 0; i < n; ++i) {
+                b(i, j) = std::cos(1.0 + i - j);
+            }
+        }
+        srs::dmatrix c = ab * b;
+        for (int j = 0; j < 4; ++j) {
+            for (int i = 0; i < n; ++i) {
+                double cij = 0.0;
+                for (int k = 0; k < n; ++k) {
+                    cij += d(i, k) * b(k, j);
+                }
+                CHECK(std::abs(c(i, j) - cij) < 1.0e-12);
+            }
+        }
+
+        // BILU(0) of a block tridiagonal matrix has no fill-in and is exact.
+        srs::Block_ilu<double, 3> ilu(ab);
+        srs::dvector z = ans;
+        ilu.solve(z);
+        for (int i = 0; i < n; ++i) {
+            CHECK(std::abs(z(i) - x(i)) < 1.0e-12);
+        }
+
+        // Rectangular blocks.
+        srs::Block_sparse_matrix<double, 5, 3> ar(a);
+        srs::dvector yr = ar * x;
+        for (int i = 0; i < n; ++i) {
+            CHECK(std::abs(yr(i) - ans(i)) < 1.0e-12);
+        }
+    }
 }
\ No newline at end of file
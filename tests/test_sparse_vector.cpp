@@ -18,11 +18,12 @@
 #include <srs/sparse.h>
 #include <algorithm>
 #include <catch/catch.hpp>
+#include <vector>
 
 
 TEST_CASE("sparse_vector")
 {
-    srs::Sparse_vector<int> spvec = {{1, 10}, {4, 20}, {9, 30}};
+    srs::sparse_ivector spvec = {{1, 10}, {4, 20}, {9, 30}};
 
     SECTION("element_access")
     {
@@ -36,7 +37,7 @@ TEST_CASE("sparse_vector")
 
     SECTION("insert")
     {
-        srs::Sparse_vector<int> spv1(spvec);
+        srs::sparse_ivector spv1(spvec);
         spv1.insert(40, 5);
         CHECK(spv1.num_nonzero() == 4);
         CHECK(spv1(5) == 40);
@@ -44,8 +45,8 @@ TEST_CASE("sparse_vector")
 
     SECTION("swap")
     {
-        srs::Sparse_vector<int> spv1 = {{2, 20}, {4, 30}, {7, 40}};
-        srs::Sparse_vector<int> spv2(spvec);
+        srs::sparse_ivector spv1 = {{2, 20}, {4, 30}, {7, 40}};
+        srs::sparse_ivector spv2(spvec);
         std::swap(spv2, spv1);
         CHECK(spv2.num_nonzero() == 3);
         CHECK(spv2(1) == 0);
@@ -58,7 +59,7 @@ TEST_CASE("sparse_vector")
     SECTION("addition")
     {
         srs::ivector x(10, 1);
-        auto y = 2 * spvec + x;
+        auto y = srs::Int_t{2} * spvec + x;
         CHECK(y(0) == 1);
         CHECK(y(1) == 21);
         CHECK(y(2) == 1);
@@ -71,6 +72,82 @@ TEST_CASE("sparse_vector")
         CHECK(y(9) == 61);
     }
 
+    SECTION("subtraction")
+    {
+        srs::ivector x(10, 1);
+        srs::ivector y = spvec - x;
+        srs::ivector z = x - spvec;
+        CHECK(y(0) == -1);
+        CHECK(y(1) == 9);
+        CHECK(y(9) == 29);
+        CHECK(z(0) == 1);
+        CHECK(z(4) == -19);
+    }
+
+    SECTION("axpyi")
+    {
+        srs::ivector y(12, 1);
+        srs::axpyi(srs::Int_t{3}, spvec, y);
+        CHECK(y(0) == 1);
+        CHECK(y(1) == 31);
+        CHECK(y(4) == 61);
+        CHECK(y(9) == 91);
+        CHECK(y(11) == 1);
+    }
+
+    SECTION("dot")
+    {
+        srs::ivector x(10);
+        for (int i = 0; i < 10; ++i) {
+            x(i) = i;
+        }
+        CHECK(srs::dot(spvec, x) == 10 + 80 + 270);
+        CHECK(srs::dot(std::vector<srs::Int_t>(10, 2), spvec) == 120);
+
+        srs::sparse_ivector spv1 = {{0, 5}, {4, 2}, {8, 7}, {9, -1}};
+        CHECK(srs::dot(spvec, spv1) == 40 - 30);
+        CHECK(srs::dot(spv1, spvec) == 40 - 30);
+        CHECK(srs::dot(spvec, srs::sparse_ivector()) == 0);
+    }
+
+    SECTION("sparse_add")
+    {
+        srs::sparse_ivector spv1 = {{0, 5}, {4, 2}, {8, 7}, {9, -1}};
+        srs::sparse_ivector z    = spvec + spv1;
+        CHECK(z.num_nonzero() == 5);
+        CHECK(z(0) == 5);
+        CHECK(z(1) == 10);
+        CHECK(z(4) == 22);
+        CHECK(z(8) == 7);
+        CHECK(z(9) == 29);
+
+        srs::sparse_ivector w
+            = srs::sparse_add(srs::Int_t{2}, spvec, srs::Int_t{-3}, spv1);
+        srs::ivector ans = srs::Int_t{2} * srs::sparse_scatter(spvec)
+                           - srs::Int_t{3} * srs::sparse_scatter(spv1);
+        CHECK(srs::sparse_scatter(w) == ans);
+        CHECK((spvec - spv1)(9) == 31);
+    }
+
+    SECTION("sparse_gather")
+    {
+        srs::ivector y = {0, 10, 0, 0, 20, 0, 0, 0, 0, 30, 0, 0};
+        srs::sparse_ivector x = srs::sparse_gather(y);
+        CHECK(x.num_nonzero() == 3);
+        CHECK(x.index() == spvec.index());
+        CHECK(x.values() == spvec.values());
+
+        srs::ivector z(10, 4);
+        srs::sparse_gather(z, x);
+        CHECK(x(1) == 4);
+        CHECK(x(9) == 4);
+
+        srs::sparse_scatter(spvec, z);
+        CHECK(z(0) == 4);
+        CHECK(z(1) == 10);
+        CHECK(z(9) == 30);
+    }
+
     SECTION("sparse_scatter")
     {
         srs::ivector y = srs::sparse_scatter(spvec);